@@ -15,22 +15,30 @@
 #include <Picasso_APIC.hpp>
 #include <Picasso_AdaptiveMesh.hpp>
 #include <Picasso_BatchedLinearAlgebra.hpp>
+#include <Picasso_BroadcastFile.hpp>
 #include <Picasso_FacetGeometry.hpp>
+#include <Picasso_FacetGeometryCache.hpp>
+#include <Picasso_FacetLevelSet.hpp>
 #include <Picasso_FieldManager.hpp>
 #include <Picasso_FieldTypes.hpp>
 #include <Picasso_GridOperator.hpp>
+#include <Picasso_GridTransfer.hpp>
 #include <Picasso_InputParser.hpp>
 #include <Picasso_LevelSet.hpp>
+#include <Picasso_LevelSetNarrowBand.hpp>
 #include <Picasso_LevelSetRedistance.hpp>
+#include <Picasso_ParticleBins.hpp>
 #include <Picasso_ParticleCommunication.hpp>
 #include <Picasso_ParticleInit.hpp>
 #include <Picasso_ParticleInterpolation.hpp>
 #include <Picasso_ParticleLevelSet.hpp>
 #include <Picasso_ParticleList.hpp>
 #include <Picasso_PolyPIC.hpp>
+#include <Picasso_StlReader.hpp>
 #include <Picasso_Types.hpp>
 #include <Picasso_UniformMesh.hpp>
 #include <Picasso_Version.hpp>
+#include <Picasso_VolumeIdField.hpp>
 
 #ifdef Picasso_ENABLE_SILO
 #include <Picasso_SiloParticleWriter.hpp>
@@ -384,6 +384,83 @@ g2p( const GridVelocity& u_i, ParticleVelocity& u_p, ParticleAffineMatrix& B_p,
             }
 }
 
+//---------------------------------------------------------------------------//
+// Interpolate collocated grid velocity to the particle along with the
+// velocity gradient and divergence in a single traversal of the stencil such
+// that each grid velocity is read once. The gradient is ordered as in
+// G2P::gradient. Requires SplineValue, SplineGradient, and SplineDistance
+// when constructing the spline data.
+template <class GridVelocity, class SplineDataType, class ParticleVelocity,
+          class ParticleAffineMatrix, class ParticleVelocityGradient,
+          class ParticleDivergence>
+KOKKOS_INLINE_FUNCTION void
+g2p( const GridVelocity& u_i, ParticleVelocity& u_p, ParticleAffineMatrix& B_p,
+     ParticleVelocityGradient& grad_u_p, ParticleDivergence& div_u_p,
+     const SplineDataType& sd,
+     typename std::enable_if<
+         ( Cajita::isNode<typename SplineDataType::entity_type>::value ||
+           Cajita::isCell<typename SplineDataType::entity_type>::value ),
+         void*>::type = 0 )
+{
+    using value_type = typename GridVelocity::value_type;
+
+    static_assert( SplineDataType::has_weight_values,
+                   "APIC::g2p requires spline weight values" );
+
+    static_assert( SplineDataType::has_weight_physical_gradients,
+                   "APIC::g2p requires spline weight gradients" );
+
+    static_assert( SplineDataType::has_physical_distance,
+                   "APIC::g2p requires spline distance" );
+
+    // Reset the particle values.
+    u_p = 0.0;
+    B_p = 0.0;
+    grad_u_p = 0.0;
+
+    // Update particle.
+    Vec3<value_type> u_e;
+    Vec3<value_type> distance;
+    Vec3<value_type> grad_w_ip;
+    value_type w_ip;
+    for ( int i = 0; i < SplineDataType::num_knot; ++i )
+        for ( int j = 0; j < SplineDataType::num_knot; ++j )
+            for ( int k = 0; k < SplineDataType::num_knot; ++k )
+            {
+                // Projection weight.
+                w_ip = sd.w[Dim::I][i] * sd.w[Dim::J][j] * sd.w[Dim::K][k];
+
+                // Projection weight gradient.
+                grad_w_ip( Dim::I ) =
+                    sd.g[Dim::I][i] * sd.w[Dim::J][j] * sd.w[Dim::K][k];
+                grad_w_ip( Dim::J ) =
+                    sd.w[Dim::I][i] * sd.g[Dim::J][j] * sd.w[Dim::K][k];
+                grad_w_ip( Dim::K ) =
+                    sd.w[Dim::I][i] * sd.w[Dim::J][j] * sd.g[Dim::K][k];
+
+                // Entity velocity
+                u_e = u_i( sd.s[Dim::I][i], sd.s[Dim::J][j], sd.s[Dim::K][k] );
+
+                // Update velocity.
+                u_p += w_ip * u_e;
+
+                // Physical distance to entity.
+                distance( Dim::I ) = sd.d[Dim::I][i];
+                distance( Dim::J ) = sd.d[Dim::J][j];
+                distance( Dim::K ) = sd.d[Dim::K][k];
+
+                // Update affine matrix.
+                B_p += w_ip * u_e * ~distance;
+
+                // Update velocity gradient.
+                grad_u_p += grad_w_ip * ~u_e;
+            }
+
+    // Velocity divergence.
+    div_u_p = grad_u_p( Dim::I, Dim::I ) + grad_u_p( Dim::J, Dim::J ) +
+              grad_u_p( Dim::K, Dim::K );
+}
+
 //---------------------------------------------------------------------------//
 // Interpolate staggered grid velocity to the particle. Requires SplineValue
 // and SplineDistance when constructing the spline data.
@@ -0,0 +1,63 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Picasso_BroadcastFile.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+
+namespace Picasso
+{
+//---------------------------------------------------------------------------//
+// Read a file on the first rank and broadcast its contents.
+bool broadcastFile( const std::string& filename, MPI_Comm comm,
+                    std::vector<char>& contents )
+{
+    // Read the file on the first rank. A size of UINT64_MAX indicates the
+    // file could not be read.
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    std::uint64_t size = UINT64_MAX;
+    if ( 0 == comm_rank )
+    {
+        std::ifstream file( filename, std::ios::binary | std::ios::ate );
+        if ( file )
+        {
+            std::uint64_t file_size = file.tellg();
+            file.seekg( 0 );
+            contents.resize( file_size );
+            if ( file.read( contents.data(), file_size ) )
+                size = file_size;
+        }
+    }
+
+    // Broadcast the contents. Large files are sent in pieces as the count
+    // of a broadcast is an int.
+    MPI_Bcast( &size, 1, MPI_UINT64_T, 0, comm );
+    if ( UINT64_MAX == size )
+    {
+        contents.clear();
+        return false;
+    }
+    contents.resize( size );
+    for ( std::uint64_t offset = 0; offset < size; offset += INT_MAX )
+    {
+        int count = std::min<std::uint64_t>( INT_MAX, size - offset );
+        MPI_Bcast( contents.data() + offset, count, MPI_CHAR, 0, comm );
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
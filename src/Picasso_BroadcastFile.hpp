@@ -0,0 +1,82 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef PICASSO_BROADCASTFILE_HPP
+#define PICASSO_BROADCASTFILE_HPP
+
+#include <mpi.h>
+
+#include <ios>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace Picasso
+{
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read a file on the first rank of a communicator and broadcast its
+  contents to all ranks. This avoids every rank opening the file.
+  \param filename The file name.
+  \param comm The communicator.
+  \param contents The contents of the file.
+  \return True on all ranks if the file was read. Otherwise false on all
+  ranks.
+*/
+bool broadcastFile( const std::string& filename, MPI_Comm comm,
+                    std::vector<char>& contents );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Stream buffer over broadcast file contents. The contents are read in
+  place so a stream can be parsed without copying them. The read position
+  can be queried and moved so tellg() and seekg() work as for a file.
+*/
+class ContentsStreamBuffer : public std::streambuf
+{
+  public:
+    explicit ContentsStreamBuffer( std::vector<char>& contents )
+    {
+        char* begin = contents.data();
+        setg( begin, begin, begin + contents.size() );
+    }
+
+  protected:
+    pos_type seekoff( off_type off, std::ios_base::seekdir dir,
+                      std::ios_base::openmode which ) override
+    {
+        if ( !( which & std::ios_base::in ) )
+            return pos_type( off_type( -1 ) );
+
+        off_type base = 0;
+        if ( std::ios_base::cur == dir )
+            base = gptr() - eback();
+        else if ( std::ios_base::end == dir )
+            base = egptr() - eback();
+        off_type position = base + off;
+        if ( position < 0 || position > egptr() - eback() )
+            return pos_type( off_type( -1 ) );
+
+        setg( eback(), eback() + position, egptr() );
+        return pos_type( position );
+    }
+
+    pos_type seekpos( pos_type pos, std::ios_base::openmode which ) override
+    {
+        return seekoff( off_type( pos ), std::ios_base::beg, which );
+    }
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
+
+#endif // end PICASSO_BROADCASTFILE_HPP
@@ -13,15 +13,24 @@
 #define PICASSO_FACETGEOMETRY_HPP
 
 #include <Picasso_BatchedLinearAlgebra.hpp>
+#include <Picasso_FacetGeometryCache.hpp>
+#include <Picasso_StlReader.hpp>
 
 #include <Kokkos_Core.hpp>
 #include <Kokkos_Random.hpp>
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <mpi.h>
+
+#include <algorithm>
 #include <cfloat>
+#include <climits>
 #include <cmath>
-#include <fstream>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -87,8 +96,81 @@ struct FacetGeometryData
 
     // Axis aligned bounding box for all volumes.
     Kokkos::View<float* [6], MemorySpace> volume_bounding_boxes;
+
+    // Given a local volume id get the root node of its bounding volume
+    // hierarchy.
+    KOKKOS_FUNCTION
+    int volumeBvhRoot( const int volume_id ) const
+    {
+        return ( 0 == volume_id ) ? 0 : volume_bvh_offsets( volume_id - 1 );
+    }
+
+    // Volume bounding volume hierarchy node boxes ordered as (node,dim)
+    // where dim=0,1,2 are the low corner and dim=3,4,5 are the high corner.
+    Kokkos::View<float* [6], MemorySpace> volume_bvh_boxes;
+
+    // Volume bounding volume hierarchy node connectivity. Internal nodes
+    // store the indices of their two children. Leaf nodes store -1 minus the
+    // index of their first facet in the volume facets and one past the index
+    // of their last facet.
+    Kokkos::View<int* [2], MemorySpace> volume_bvh_nodes;
+
+    // Volume bounding volume hierarchy offsets. Inclusive scan of volume
+    // node counts giving the offset into the node arrays for each volume.
+    Kokkos::View<int*, MemorySpace> volume_bvh_offsets;
+
+    // Local id of the part volume whose facets and bounding volume hierarchy
+    // define each volume. Volumes read from the STL file are their own part.
+    // Instances of a part have no facets of their own.
+    Kokkos::View<int*, MemorySpace> volume_part_ids;
+
+    // Affine map from world space to the space of the part of each volume.
+    // Ordered as (volume,row,column) where columns 0,1,2 are the linear map
+    // and column 3 is the translation. Volumes read from the STL file have
+    // the identity map.
+    Kokkos::View<float* [3][4], MemorySpace> volume_to_part;
+
+    // Top-level bounding volume hierarchy node boxes over the volume
+    // bounding boxes of all volumes except the global bounding volume.
+    // Ordered as (node,dim) in the same way as the volume hierarchies.
+    Kokkos::View<float* [6], MemorySpace> top_bvh_boxes;
+
+    // Top-level bounding volume hierarchy node connectivity. Internal nodes
+    // store the indices of their two children. Leaf nodes store -1 minus the
+    // index of their first volume in the top-level volume ids and one past
+    // the index of their last volume.
+    Kokkos::View<int* [2], MemorySpace> top_bvh_nodes;
+
+    // Smallest local volume id in the subtree of each top-level node. Used
+    // to skip subtrees which can not contain a higher priority volume.
+    Kokkos::View<int*, MemorySpace> top_bvh_min_volume_id;
+
+    // Local volume ids in top-level leaf order.
+    Kokkos::View<int*, MemorySpace> top_bvh_volume_ids;
+
+    // Whether the geometry is distributed. If so, each rank only has the
+    // facets which intersect its local domain and point-in-volume parity is
+    // computed along the segment from the point to the reference point of
+    // the local domain.
+    bool distributed = false;
+
+    // Reference point of the local domain of a distributed geometry.
+    Kokkos::Array<float, 3> reference_point;
+
+    // Whether the reference point of a distributed geometry is in each
+    // volume. Ordered by local volume id.
+    Kokkos::View<int*, MemorySpace> volume_reference_inside;
 };
 
+//---------------------------------------------------------------------------//
+namespace FacetGeometryOps
+{
+template <class MemorySpace>
+KOKKOS_FUNCTION bool pointInVolume( const float x[3],
+                                    const FacetGeometryData<MemorySpace>& geom,
+                                    const int volume_id );
+} // end namespace FacetGeometryOps
+
 //---------------------------------------------------------------------------//
 template <class MemorySpace>
 class FacetGeometry
@@ -177,144 +259,544 @@ class FacetGeometry
     // Default constructor.
     FacetGeometry() = default;
 
-    // Create the geometry from an ASCII STL file.
+    // Create the geometry from an ASCII or binary STL file or a cache of a
+    // geometry previously built from the same file. Files are read by the
+    // first rank of the communicator and broadcast to the others.
     template <class ExecutionSpace>
     FacetGeometry( const boost::property_tree::ptree& ptree,
-                   const ExecutionSpace& exec_space )
+                   const ExecutionSpace& exec_space,
+                   MPI_Comm comm = MPI_COMM_WORLD )
     {
         // Get the geometry parameters.
         const auto& params = ptree.get_child( "geometry" );
 
-        // Read the stl file and create the facet geometry.
-        auto stl_ascii_filename = params.get<std::string>( "stl_file" );
+        // Get the STL file. The format is detected from the file contents
+        // unless given.
+        auto stl_filename = params.get<std::string>( "stl_file" );
+        auto stl_format =
+            stlFormat( params.get<std::string>( "stl_format", "auto" ) );
+
+        // If a cache file is given restore the geometry from it if it was
+        // built from the current STL file. Otherwise build the geometry from
+        // the STL file and write the cache from the first rank.
+        auto cache_filename = params.get<std::string>( "cache_file", "" );
+        _from_cache = false;
+        _comm = comm;
+        if ( cache_filename.empty() )
+        {
+            build( stl_filename, stl_format, exec_space );
+        }
+        else
+        {
+            int comm_rank;
+            MPI_Comm_rank( _comm, &comm_rank );
+            std::uint64_t stl_hash = 0;
+            if ( 0 == comm_rank )
+                stl_hash = stlFileHash( stl_filename );
+            MPI_Bcast( &stl_hash, 1, MPI_UINT64_T, 0, _comm );
+            FacetGeometryCacheData cache;
+            if ( readFacetGeometryCache( cache_filename, stl_hash, cache,
+                                         _comm ) )
+            {
+                putCacheOnDevice( cache );
+                _from_cache = true;
+            }
+            else
+            {
+                build( stl_filename, stl_format, exec_space );
+                if ( 0 == comm_rank )
+                {
+                    getCacheFromDevice( cache );
+                    writeFacetGeometryCache( cache_filename, stl_hash, cache );
+                }
+            }
+        }
+
+        // Add the instances of the part volumes. These are not cached as
+        // they are defined by the input rather than the STL file.
+        addInstances( params );
+
+        // Get the global bounding box.
+        setGlobalBoundingBox( params );
 
-        // Containers.
+        // Build the hierarchy over the volume bounding boxes.
+        buildTopBvh();
+    }
+
+    // Create a geometry distributed over the ranks of a communicator. The
+    // STL file, or its cache, is only read by the first rank. Ids and volume
+    // bounding boxes are available on all ranks after construction while
+    // facets are not available until the geometry is distributed.
+    FacetGeometry( const boost::property_tree::ptree& ptree, MPI_Comm comm )
+        : _from_cache( false )
+        , _comm( comm )
+    {
+        // Get the geometry parameters.
+        const auto& params = ptree.get_child( "geometry" );
+
+        // Read the geometry on the first rank.
+        int comm_rank;
+        MPI_Comm_rank( _comm, &comm_rank );
         std::vector<int> volume_ids;
         std::vector<int> surface_ids;
-        std::vector<float> volume_facets;
-        std::vector<float> surface_facets;
-
-        // Load the file.
-        std::ifstream file( stl_ascii_filename );
-        if ( !file.is_open() )
-            throw std::runtime_error( "Unable to open STL ASCII file" );
-
-        // Read the file.
-        std::string buffer;
-        std::vector<std::string> tokens;
-        tokens.reserve( 10 );
-        bool read_volume = false;
-        bool read_surface = false;
-        while ( !file.eof() )
-        {
-            // Get the current line.
-            std::getline( file, buffer );
-
-            // Break the line up into tokens.
-            std::istringstream line( buffer );
-            tokens.resize( 0 );
-            while ( !line.eof() )
-            {
-                tokens.push_back( std::string() );
-                line >> tokens.back();
-            }
+        std::vector<float> volume_bounding_boxes;
+        if ( 0 == comm_rank )
+        {
+            _root_geometry = std::make_shared<FacetGeometry<Kokkos::HostSpace>>(
+                ptree, Kokkos::DefaultHostExecutionSpace(), MPI_COMM_SELF );
+            _from_cache = _root_geometry->fromCache();
+            volume_ids.resize( _root_geometry->_volume_ids.size() );
+            for ( const auto& id : _root_geometry->_volume_ids )
+                volume_ids[id.second] = id.first;
+            surface_ids.resize( _root_geometry->_surface_ids.size() );
+            for ( const auto& id : _root_geometry->_surface_ids )
+                surface_ids[id.second] = id.first;
+            copyFromDevice( _root_geometry->data().volume_bounding_boxes,
+                            volume_bounding_boxes );
+            _volume_part_ids = _root_geometry->_volume_part_ids;
+            _volume_to_world = _root_geometry->_volume_to_world;
+            _volume_to_part = _root_geometry->_volume_to_part;
+        }
 
-            // Parse the line.
-            if ( tokens.size() > 0 )
+        // Broadcast the ids, bounding boxes, and instance transforms.
+        broadcastVector( volume_ids );
+        broadcastVector( surface_ids );
+        broadcastVector( volume_bounding_boxes );
+        broadcastVector( _volume_part_ids );
+        broadcastVector( _volume_to_world );
+        broadcastVector( _volume_to_part );
+        for ( std::size_t i = 0; i < volume_ids.size(); ++i )
+            _volume_ids.emplace( volume_ids[i], i );
+        for ( std::size_t i = 0; i < surface_ids.size(); ++i )
+            _surface_ids.emplace( surface_ids[i], i );
+        copyToDevice( "volume_bounding_boxes", volume_bounding_boxes,
+                      _data.volume_bounding_boxes );
+        copyToDevice( "volume_part_ids", _volume_part_ids,
+                      _data.volume_part_ids );
+        copyToDevice( "volume_to_part", _volume_to_part,
+                      _data.volume_to_part );
+
+        // Get the global bounding box.
+        setGlobalBoundingBox( params );
+
+        // Build the hierarchy over the volume bounding boxes.
+        buildTopBvh();
+    }
+
+    /*!
+      \brief Distribute the facets of a distributed geometry. Each rank
+      receives the facets of every volume and surface which intersect its
+      local domain. Point location is only valid for points in the local
+      domain. The domain should be padded by any distance over which facets
+      are searched, such as the band width of a level set. This is a
+      collective operation and can only be done once.
+      \param local_box The local domain of this rank as {x_min, y_min, z_min,
+      x_max, y_max, z_max}. Typically the ghosted local domain of the mesh.
+    */
+    void distribute( const Kokkos::Array<double, 6>& local_box )
+    {
+        if ( !_data.distributed && _data.volume_facets.size() > 0 )
+            throw std::runtime_error( "Geometry is not distributed" );
+        if ( _data.distributed )
+            throw std::runtime_error( "Geometry already distributed" );
+
+        int comm_rank;
+        MPI_Comm_rank( _comm, &comm_rank );
+        int comm_size;
+        MPI_Comm_size( _comm, &comm_size );
+
+        // Gather the local domains on the first rank.
+        std::vector<double> local_boxes( 6 * comm_size );
+        MPI_Gather( local_box.data(), 6, MPI_DOUBLE, local_boxes.data(), 6,
+                    MPI_DOUBLE, 0, _comm );
+
+        // Bin the facets of every rank on the first rank in a single pass
+        // and send each rank its facets. The first rank is done last so its
+        // facets do not need to be stored while sending.
+        StlData local_data;
+        std::vector<int> reference_inside;
+        if ( 0 == comm_rank )
+        {
+            const auto& geom = _root_geometry->data();
+            std::vector<std::vector<int>> rank_volume_facets;
+            std::vector<std::vector<int>> rank_surface_facets;
+            binRankFacets( *_root_geometry, local_boxes, rank_volume_facets,
+                           rank_surface_facets );
+            for ( int r = comm_size - 1; r >= 0; --r )
             {
-                // New solid.
-                if ( tokens[0].compare( "solid" ) == 0 )
+                gatherFacets( geom.volume_facets, geom.volume_offsets,
+                              rank_volume_facets[r],
+                              local_data.volume_facet_count,
+                              local_data.volume_facets );
+                gatherFacets( geom.surface_facets, geom.surface_offsets,
+                              rank_surface_facets[r],
+                              local_data.surface_facet_count,
+                              local_data.surface_facets );
+                std::vector<int>().swap( rank_volume_facets[r] );
+                std::vector<int>().swap( rank_surface_facets[r] );
+
+                // Locate the reference point of the rank with the full
+                // geometry.
+                Kokkos::Array<double, 6> box;
+                for ( int i = 0; i < 6; ++i )
+                    box[i] = local_boxes[6 * r + i];
+                auto x = localReferencePoint( box );
+                float xf[3] = { x[0], x[1], x[2] };
+                reference_inside.resize( geom.numVolume() );
+                for ( int v = 0; v < geom.numVolume(); ++v )
+                    reference_inside[v] =
+                        FacetGeometryOps::pointInVolume( xf, geom, v );
+
+                if ( r > 0 )
                 {
-                    if ( tokens.size() != 3 )
-                        throw std::runtime_error(
-                            "STL READER: Expected 3 solid line entries" );
+                    sendVector( local_data.volume_facet_count, r );
+                    sendVector( local_data.volume_facets, r );
+                    sendVector( local_data.surface_facet_count, r );
+                    sendVector( local_data.surface_facets, r );
+                    sendVector( reference_inside, r );
+                }
+            }
+            _root_geometry.reset();
+        }
+        else
+        {
+            receiveVector( local_data.volume_facet_count );
+            receiveVector( local_data.volume_facets );
+            receiveVector( local_data.surface_facet_count );
+            receiveVector( local_data.surface_facets );
+            receiveVector( reference_inside );
+        }
 
-                    // New volume.
-                    if ( tokens[1].compare( "Volume" ) == 0 ||
-                         tokens[1].compare( "Body" ) == 0 )
-                    {
-                        volume_ids.push_back( std::atoi( tokens[2].c_str() ) );
-                        _volume_facet_count.push_back( 0 );
-                        read_volume = true;
-                    }
+        // Build the local geometry. The ids and volume bounding boxes are
+        // those of the global geometry.
+        _volume_facet_count = local_data.volume_facet_count;
+        _surface_facet_count = local_data.surface_facet_count;
+        std::vector<int> volume_ids( _volume_ids.size() );
+        for ( const auto& id : _volume_ids )
+            volume_ids[id.second] = id.first;
+        std::vector<int> surface_ids( _surface_ids.size() );
+        for ( const auto& id : _surface_ids )
+            surface_ids[id.second] = id.first;
+        buildVolumeBvh( local_data.volume_facets );
+        putFileDataOnDevice( volume_ids, _volume_facet_count,
+                             local_data.volume_facets, _volume_ids,
+                             _data.volume_facets, _data.volume_offsets );
+        putFileDataOnDevice( surface_ids, _surface_facet_count,
+                             local_data.surface_facets, _surface_ids,
+                             _data.surface_facets, _data.surface_offsets );
+
+        // Set the point-in-volume reference data.
+        copyToDevice( "volume_reference_inside", reference_inside,
+                      _data.volume_reference_inside );
+        _data.reference_point = localReferencePoint( local_box );
+        _data.distributed = true;
+    }
 
-                    // New surface.
-                    else if ( tokens[1].compare( "Surface" ) == 0 )
-                    {
-                        surface_ids.push_back( std::atoi( tokens[2].c_str() ) );
-                        _surface_facet_count.push_back( 0 );
-                        read_surface = true;
-                    }
+    // Given a global volume id get the local volume id.
+    int localVolumeId( const int global_id ) const
+    {
+        return _volume_ids.find( global_id )->second;
+    }
 
-                    else
-                    {
-                        throw std::runtime_error(
-                            "STL READER: Solids execpted to be Volume/Body or "
-                            "Surface" );
-                    }
-                }
+    // Given a global surface id get the local surface id.
+    int localSurfaceId( const int global_id ) const
+    {
+        return _surface_ids.find( global_id )->second;
+    }
 
-                // Read facet.
-                else if ( tokens[0].compare( "facet" ) == 0 )
-                {
-                    if ( tokens.size() != 5 )
-                        throw std::runtime_error(
-                            "STL READER: Expected 5 facet line entries" );
+    // Given a local volume id get the number of facets that compose the
+    // volume. Instances have no facets of their own.
+    int numVolumeFacet( const int local_id ) const
+    {
+        return _volume_facet_count[local_id];
+    }
 
-                    // Volume facet.
-                    if ( read_volume )
-                    {
-                        ++_volume_facet_count.back();
-                    }
+    // Given a local volume id get the local id of the part volume whose
+    // facets define the volume. Volumes read from the STL file are their own
+    // part.
+    int volumePartId( const int local_id ) const
+    {
+        return _volume_part_ids[local_id];
+    }
 
-                    // Surface facet.
-                    else if ( read_surface )
-                    {
-                        ++_surface_facet_count.back();
-                    }
+    // Given a local volume id get the facets of the volume in world space.
+    // For volumes read from the STL file these are the volume facets. For
+    // instances the facets of the part are mapped into a new view.
+    template <class ExecutionSpace>
+    Kokkos::View<float* [4][3], MemorySpace>
+    worldVolumeFacets( const ExecutionSpace& exec_space,
+                       const int local_id ) const
+    {
+        int part_id = _volume_part_ids[local_id];
+        auto part_facets = _data.volumeFacets( part_id );
+        if ( part_id == local_id )
+            return part_facets;
+
+        Kokkos::Array<float, 12> to_world;
+        for ( int i = 0; i < 12; ++i )
+            to_world[i] = _volume_to_world[12 * local_id + i];
+        Kokkos::View<float* [4][3], MemorySpace> facets(
+            Kokkos::ViewAllocateWithoutInitializing( "instance_facets" ),
+            part_facets.extent( 0 ) );
+        Kokkos::parallel_for(
+            "instance_facets",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                                 facets.extent( 0 ) ),
+            KOKKOS_LAMBDA( const int f ) {
+                // Map the vertices.
+                for ( int v = 0; v < 3; ++v )
+                    for ( int i = 0; i < 3; ++i )
+                        facets( f, v, i ) =
+                            to_world[4 * i] * part_facets( f, v, 0 ) +
+                            to_world[4 * i + 1] * part_facets( f, v, 1 ) +
+                            to_world[4 * i + 2] * part_facets( f, v, 2 ) +
+                            to_world[4 * i + 3];
+
+                // Rotate the normal. The map is a rotation and a uniform
+                // scale so only the length of the normal changes.
+                float nmag = 0.0;
+                for ( int i = 0; i < 3; ++i )
+                {
+                    facets( f, 3, i ) =
+                        to_world[4 * i] * part_facets( f, 3, 0 ) +
+                        to_world[4 * i + 1] * part_facets( f, 3, 1 ) +
+                        to_world[4 * i + 2] * part_facets( f, 3, 2 );
+                    nmag += facets( f, 3, i ) * facets( f, 3, i );
                 }
+                nmag = sqrt( nmag );
+                for ( int i = 0; i < 3; ++i )
+                    facets( f, 3, i ) /= nmag;
+            } );
+        return facets;
+    }
 
-                // Read vertex.
-                else if ( tokens[0].compare( "vertex" ) == 0 )
-                {
-                    if ( tokens.size() != 4 )
-                        throw std::runtime_error(
-                            "STL READER: Expected 4 vertex line entries" );
+    // Given a local surface id get the number of facets that compose the
+    // surface.
+    int numSurfaceFacet( const int local_id ) const
+    {
+        return _surface_facet_count[local_id];
+    }
 
-                    // Volume vertex coordinates.
-                    if ( read_volume )
-                    {
-                        volume_facets.push_back(
-                            std::atof( tokens[1].c_str() ) );
-                        volume_facets.push_back(
-                            std::atof( tokens[2].c_str() ) );
-                        volume_facets.push_back(
-                            std::atof( tokens[3].c_str() ) );
-                    }
+    // Get the global bounding box.
+    const Kokkos::Array<double, 6>& globalBoundingBox() const
+    {
+        return _global_bounding_box;
+    }
+
+    // Determine if the geometry was restored from a cache file.
+    bool fromCache() const { return _from_cache; }
+
+    // Get the geometry data.
+    const FacetGeometryData<MemorySpace>& data() const { return _data; }
+
+  private:
+    // Set the global bounding box.
+    void setGlobalBoundingBox( const boost::property_tree::ptree& params )
+    {
+        // Get the volume id of the global bounding box. The user is required
+        // to make an axis-aligned bounding box of their geometry that defines
+        // the global bounds of the problem. The user input is the global id
+        // of this volume.
+        _data.global_bounding_volume_id =
+            localVolumeId( params.get<int>( "global_bounding_volume_id" ) );
 
-                    // Surface vertex coordinates.
-                    if ( read_surface )
+        // Extract the global bounding box to the host.
+        auto host_boxes = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(), _data.volume_bounding_boxes );
+        for ( int i = 0; i < 6; ++i )
+            _global_bounding_box[i] =
+                host_boxes( _data.global_bounding_volume_id, i );
+    }
+
+    // Add the instances of part volumes given in the geometry parameters.
+    // Each instance is a new volume which shares the facets and bounding
+    // volume hierarchy of a volume read from the STL file, its part, and is
+    // placed by a rotation, uniform scale, and translation of the part.
+    // Points are located in an instance by mapping them into the space of
+    // its part.
+    void addInstances( const boost::property_tree::ptree& params )
+    {
+        // Volumes read from the STL file are their own part.
+        int num_file_volume = _volume_ids.size();
+        const float identity[12] = { 1.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+                                     0.0, 0.0, 0.0, 0.0, 1.0, 0.0 };
+        _volume_part_ids.resize( num_file_volume );
+        _volume_to_world.clear();
+        _volume_to_part.clear();
+        for ( int v = 0; v < num_file_volume; ++v )
+        {
+            _volume_part_ids[v] = v;
+            _volume_to_world.insert( _volume_to_world.end(), identity,
+                                     identity + 12 );
+            _volume_to_part.insert( _volume_to_part.end(), identity,
+                                    identity + 12 );
+        }
+
+        // Add the instances.
+        if ( params.count( "instances" ) )
+        {
+            std::vector<int> offsets;
+            copyFromDevice( _data.volume_offsets, offsets );
+            std::vector<int> bvh_offsets;
+            copyFromDevice( _data.volume_bvh_offsets, bvh_offsets );
+            std::vector<float> boxes;
+            copyFromDevice( _data.volume_bounding_boxes, boxes );
+            for ( auto& element : params.get_child( "instances" ) )
+            {
+                const auto& instance = element.second;
+
+                // Get the ids.
+                int volume_id = instance.get<int>( "volume_id" );
+                if ( _volume_ids.count( volume_id ) )
+                    throw std::runtime_error(
+                        "Instance volume id " + std::to_string( volume_id ) +
+                        " already exists" );
+                int part_volume_id = instance.get<int>( "part_volume_id" );
+                auto part = _volume_ids.find( part_volume_id );
+                if ( part == _volume_ids.end() ||
+                     part->second >= num_file_volume )
+                    throw std::runtime_error(
+                        "Instance part volume id " +
+                        std::to_string( part_volume_id ) +
+                        " is not a volume of the STL file" );
+                int part_id = part->second;
+
+                // Get the transformation.
+                float rotation[9] = { 1.0, 0.0, 0.0, 0.0, 1.0,
+                                      0.0, 0.0, 0.0, 1.0 };
+                readInstanceArray( instance, "rotation", 9, rotation );
+                float translation[3] = { 0.0, 0.0, 0.0 };
+                readInstanceArray( instance, "translation", 3, translation );
+                float scale = instance.get<float>( "scale", 1.0 );
+                if ( !( scale > 0.0 ) )
+                    throw std::runtime_error(
+                        "Instance scale must be positive" );
+                for ( int i = 0; i < 3; ++i )
+                {
+                    for ( int j = 0; j < 3; ++j )
                     {
-                        surface_facets.push_back(
-                            std::atof( tokens[1].c_str() ) );
-                        surface_facets.push_back(
-                            std::atof( tokens[2].c_str() ) );
-                        surface_facets.push_back(
-                            std::atof( tokens[3].c_str() ) );
+                        float rrt = 0.0;
+                        for ( int k = 0; k < 3; ++k )
+                            rrt += rotation[3 * i + k] * rotation[3 * j + k];
+                        if ( std::abs( rrt - ( i == j ) ) > 1.0e-4 )
+                            throw std::runtime_error(
+                                "Instance rotation must be orthonormal" );
                     }
                 }
 
-                // Finish reading a solid.
-                else if ( tokens[0].compare( "endsolid" ) == 0 )
+                // The map to world space scales and rotates the part and
+                // then translates it. The map to the part space is its
+                // inverse.
+                float to_world[12];
+                float to_part[12];
+                for ( int i = 0; i < 3; ++i )
                 {
-                    read_volume = false;
-                    read_surface = false;
+                    for ( int j = 0; j < 3; ++j )
+                    {
+                        to_world[4 * i + j] = scale * rotation[3 * i + j];
+                        to_part[4 * i + j] = rotation[3 * j + i] / scale;
+                    }
+                    to_world[4 * i + 3] = translation[i];
                 }
+                for ( int i = 0; i < 3; ++i )
+                    to_part[4 * i + 3] =
+                        -( to_part[4 * i] * translation[0] +
+                           to_part[4 * i + 1] * translation[1] +
+                           to_part[4 * i + 2] * translation[2] );
+
+                // Add the volume. It has no facets or hierarchy nodes of its
+                // own and its bounding box is the box of the mapped part box.
+                int v = _volume_ids.size();
+                _volume_ids.emplace( volume_id, v );
+                _volume_facet_count.push_back( 0 );
+                offsets.push_back( offsets.back() );
+                bvh_offsets.push_back( bvh_offsets.back() );
+                float box[6];
+                transformBox( to_world, &boxes[6 * part_id], box );
+                boxes.insert( boxes.end(), box, box + 6 );
+                _volume_part_ids.push_back( part_id );
+                _volume_to_world.insert( _volume_to_world.end(), to_world,
+                                         to_world + 12 );
+                _volume_to_part.insert( _volume_to_part.end(), to_part,
+                                        to_part + 12 );
+            }
+            copyToDevice( "offsets", offsets, _data.volume_offsets );
+            copyToDevice( "volume_bvh_offsets", bvh_offsets,
+                          _data.volume_bvh_offsets );
+            copyToDevice( "volume_bounding_boxes", boxes,
+                          _data.volume_bounding_boxes );
+        }
+
+        // Copy to device.
+        copyToDevice( "volume_part_ids", _volume_part_ids,
+                      _data.volume_part_ids );
+        copyToDevice( "volume_to_part", _volume_to_part,
+                      _data.volume_to_part );
+    }
+
+    // Read an optional array of instance parameters.
+    static void readInstanceArray( const boost::property_tree::ptree& instance,
+                                   const std::string& name, const int size,
+                                   float* values )
+    {
+        if ( !instance.count( name ) )
+            return;
+        if ( static_cast<int>( instance.get_child( name ).size() ) != size )
+            throw std::runtime_error( std::to_string( size ) +
+                                      " entries required for "
+                                      "geometry.instances." +
+                                      name );
+        int i = 0;
+        for ( auto& element : instance.get_child( name ) )
+        {
+            values[i] = element.second.get_value<float>();
+            ++i;
+        }
+    }
+
+    // Compute the axis-aligned bounding box of an axis-aligned box mapped by
+    // an affine transformation from its mapped corners.
+    static void transformBox( const float transform[12], const float box[6],
+                              float result[6] )
+    {
+        for ( int d = 0; d < 3; ++d )
+        {
+            result[d] = FLT_MAX;
+            result[d + 3] = -FLT_MAX;
+        }
+        for ( int c = 0; c < 8; ++c )
+        {
+            float x[3] = { box[3 * ( c & 1 )], box[1 + 3 * ( ( c >> 1 ) & 1 )],
+                           box[2 + 3 * ( ( c >> 2 ) & 1 )] };
+            for ( int i = 0; i < 3; ++i )
+            {
+                float y = transform[4 * i] * x[0] +
+                          transform[4 * i + 1] * x[1] +
+                          transform[4 * i + 2] * x[2] + transform[4 * i + 3];
+                result[i] = std::min( result[i], y );
+                result[i + 3] = std::max( result[i + 3], y );
             }
         }
+    }
 
-        // Close the file.
-        file.close();
+    // Build the geometry from an STL file.
+    template <class ExecutionSpace>
+    void build( const std::string& stl_filename, const StlFormat stl_format,
+                const ExecutionSpace& exec_space )
+    {
+        // Read the stl file on the first rank and broadcast it.
+        StlData stl_data;
+        readStl( stl_filename, stl_format, stl_data, _comm );
+        _volume_facet_count = stl_data.volume_facet_count;
+        _surface_facet_count = stl_data.surface_facet_count;
+        const auto& volume_ids = stl_data.volume_ids;
+        const auto& surface_ids = stl_data.surface_ids;
+        auto& volume_facets = stl_data.volume_facets;
+        const auto& surface_facets = stl_data.surface_facets;
+
+        // Build the bounding volume hierarchy of each volume. This reorders
+        // the volume facets.
+        buildVolumeBvh( volume_facets );
 
         // Put volume data on device.
         putFileDataOnDevice( volume_ids, _volume_facet_count, volume_facets,
@@ -326,13 +808,6 @@ class FacetGeometry
                              _surface_ids, _data.surface_facets,
                              _data.surface_offsets );
 
-        // Get the volume id of the global bounding box. The user is required
-        // to make an axis-aligned bounding box of their geometry that defines
-        // the global bounds of the problem. The user input is the global id
-        // of this volume.
-        _data.global_bounding_volume_id =
-            localVolumeId( params.get<int>( "global_bounding_volume_id" ) );
-
         // Compute the bounding boxes of all the volumes.
         _data.volume_bounding_boxes = Kokkos::View<float* [6], MemorySpace>(
             Kokkos::ViewAllocateWithoutInitializing( "volume_bounding_boxes" ),
@@ -353,50 +828,540 @@ class FacetGeometry
                 host_boxes( v, i ) = box[i];
         }
         Kokkos::deep_copy( _data.volume_bounding_boxes, host_boxes );
+    }
 
-        // Extract the global bounding box to the host.
-        auto global_box = Kokkos::subview(
-            host_boxes, _data.global_bounding_volume_id, Kokkos::ALL() );
+    // Restore the geometry from cached data.
+    void putCacheOnDevice( const FacetGeometryCacheData& cache )
+    {
+        _volume_facet_count = cache.volume_facet_count;
+        _surface_facet_count = cache.surface_facet_count;
+        putCacheIdsOnDevice( cache.volume_ids, _volume_facet_count,
+                             _volume_ids, _data.volume_offsets );
+        putCacheIdsOnDevice( cache.surface_ids, _surface_facet_count,
+                             _surface_ids, _data.surface_offsets );
+        copyToDevice( "facets", cache.volume_facets, _data.volume_facets );
+        copyToDevice( "facets", cache.surface_facets, _data.surface_facets );
+        copyToDevice( "volume_bounding_boxes", cache.volume_bounding_boxes,
+                      _data.volume_bounding_boxes );
+        copyToDevice( "volume_bvh_boxes", cache.volume_bvh_boxes,
+                      _data.volume_bvh_boxes );
+        copyToDevice( "volume_bvh_nodes", cache.volume_bvh_nodes,
+                      _data.volume_bvh_nodes );
+        copyToDevice( "volume_bvh_offsets", cache.volume_bvh_offsets,
+                      _data.volume_bvh_offsets );
+    }
+
+    // Restore the id map and facet offsets of a set of solids from cached
+    // data.
+    void putCacheIdsOnDevice( const std::vector<int>& solid_ids,
+                              const std::vector<int>& solid_facet_counts,
+                              std::unordered_map<int, int>& id_map,
+                              Kokkos::View<int*, MemorySpace>& device_offsets )
+    {
+        std::vector<int> offsets( solid_ids.size() );
+        for ( std::size_t i = 0; i < solid_ids.size(); ++i )
+        {
+            id_map.emplace( solid_ids[i], i );
+            offsets[i] = ( 0 == i ) ? solid_facet_counts[i]
+                                    : solid_facet_counts[i] + offsets[i - 1];
+        }
+        copyToDevice( "offsets", offsets, device_offsets );
+    }
+
+    // Extract the geometry data to cache.
+    void getCacheFromDevice( FacetGeometryCacheData& cache ) const
+    {
+        cache.volume_ids.resize( _volume_ids.size() );
+        for ( const auto& id : _volume_ids )
+            cache.volume_ids[id.second] = id.first;
+        cache.surface_ids.resize( _surface_ids.size() );
+        for ( const auto& id : _surface_ids )
+            cache.surface_ids[id.second] = id.first;
+        cache.volume_facet_count = _volume_facet_count;
+        cache.surface_facet_count = _surface_facet_count;
+        copyFromDevice( _data.volume_facets, cache.volume_facets );
+        copyFromDevice( _data.surface_facets, cache.surface_facets );
+        copyFromDevice( _data.volume_bounding_boxes,
+                        cache.volume_bounding_boxes );
+        copyFromDevice( _data.volume_bvh_boxes, cache.volume_bvh_boxes );
+        copyFromDevice( _data.volume_bvh_nodes, cache.volume_bvh_nodes );
+        copyFromDevice( _data.volume_bvh_offsets, cache.volume_bvh_offsets );
+    }
+
+    // Copy flattened host values into a newly allocated device view.
+    template <class ViewType>
+    void
+    copyToDevice( const std::string& label,
+                  const std::vector<typename ViewType::value_type>& values,
+                  ViewType& view ) const
+    {
+        std::size_t stride = 1;
+        for ( unsigned r = 1; r < ViewType::rank; ++r )
+            stride *= ViewType::static_extent( r );
+        view = ViewType( Kokkos::ViewAllocateWithoutInitializing( label ),
+                         values.size() / stride );
+        Kokkos::View<typename ViewType::const_data_type, Kokkos::LayoutRight,
+                     Kokkos::HostSpace,
+                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>
+            host_values( values.data(), view.extent( 0 ) );
+        auto host_view =
+            Kokkos::create_mirror_view( Kokkos::HostSpace(), view );
+        Kokkos::deep_copy( host_view, host_values );
+        Kokkos::deep_copy( view, host_view );
+    }
+
+    // Copy a device view into flattened host values.
+    template <class ViewType>
+    void
+    copyFromDevice( const ViewType& view,
+                    std::vector<typename ViewType::value_type>& values ) const
+    {
+        values.resize( view.size() );
+        auto host_view =
+            Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), view );
+        Kokkos::View<typename ViewType::data_type, Kokkos::LayoutRight,
+                     Kokkos::HostSpace,
+                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>
+            host_values( values.data(), view.extent( 0 ) );
+        Kokkos::deep_copy( host_values, host_view );
+    }
+
+    // Build a bounding volume hierarchy over the facets of each volume and
+    // put it on device. Facets are reordered such that the facets of each
+    // leaf are contiguous.
+    void buildVolumeBvh( std::vector<float>& facets )
+    {
+        std::vector<float> boxes;
+        std::vector<int> nodes;
+        std::vector<int> node_offsets;
+        std::size_t facet_offset = 0;
+        for ( auto num_facet : _volume_facet_count )
+        {
+            // Facet boxes and centroids.
+            float* volume_facets = facets.data() + 9 * facet_offset;
+            std::vector<float> facet_boxes( 6 * num_facet );
+            std::vector<float> centroids( 3 * num_facet );
+            for ( int f = 0; f < num_facet; ++f )
+            {
+                for ( int d = 0; d < 3; ++d )
+                {
+                    const float* x = volume_facets + 9 * f + d;
+                    facet_boxes[6 * f + d] =
+                        std::min( x[0], std::min( x[3], x[6] ) );
+                    facet_boxes[6 * f + d + 3] =
+                        std::max( x[0], std::max( x[3], x[6] ) );
+                    centroids[3 * f + d] = ( x[0] + x[3] + x[6] ) / 3.0;
+                }
+            }
+
+            // Build the tree.
+            std::vector<int> order( num_facet );
+            for ( int f = 0; f < num_facet; ++f )
+                order[f] = f;
+            buildBvhNode( facet_boxes, centroids, order, 0, num_facet, boxes,
+                          nodes );
+            node_offsets.push_back( nodes.size() / 2 );
+
+            // Put the facets in leaf order.
+            std::vector<float> sorted( 9 * num_facet );
+            for ( int f = 0; f < num_facet; ++f )
+                for ( int i = 0; i < 9; ++i )
+                    sorted[9 * f + i] = volume_facets[9 * order[f] + i];
+            std::copy( sorted.begin(), sorted.end(), volume_facets );
+
+            facet_offset += num_facet;
+        }
+
+        // Copy to device.
+        copyToDevice( "volume_bvh_boxes", boxes, _data.volume_bvh_boxes );
+        copyToDevice( "volume_bvh_nodes", nodes, _data.volume_bvh_nodes );
+        copyToDevice( "volume_bvh_offsets", node_offsets,
+                      _data.volume_bvh_offsets );
+    }
+
+    // Build the top-level bounding volume hierarchy over the bounding boxes
+    // of all volumes except the global bounding volume and put it on
+    // device.
+    void buildTopBvh()
+    {
+        // Volume boxes and centroids.
+        std::vector<float> volume_boxes;
+        copyFromDevice( _data.volume_bounding_boxes, volume_boxes );
+        std::vector<int> order;
+        std::vector<float> centroids( 3 * _volume_ids.size() );
+        for ( int v = 0; v < static_cast<int>( _volume_ids.size() ); ++v )
+        {
+            if ( v != _data.global_bounding_volume_id )
+                order.push_back( v );
+            for ( int d = 0; d < 3; ++d )
+                centroids[3 * v + d] = 0.5 * ( volume_boxes[6 * v + d] +
+                                               volume_boxes[6 * v + d + 3] );
+        }
+
+        // Build the tree.
+        std::vector<float> boxes;
+        std::vector<int> nodes;
+        buildBvhNode( volume_boxes, centroids, order, 0, order.size(), boxes,
+                      nodes );
+
+        // Compute the smallest volume id in each subtree. Children are
+        // always created after their parent so a reverse pass visits
+        // children first.
+        int num_node = nodes.size() / 2;
+        std::vector<int> min_volume_id( num_node, INT_MAX );
+        for ( int n = num_node - 1; n >= 0; --n )
+        {
+            if ( nodes[2 * n] < 0 )
+            {
+                for ( int i = -1 - nodes[2 * n]; i < nodes[2 * n + 1]; ++i )
+                    min_volume_id[n] = std::min( min_volume_id[n], order[i] );
+            }
+            else
+            {
+                min_volume_id[n] = std::min( min_volume_id[nodes[2 * n]],
+                                             min_volume_id[nodes[2 * n + 1]] );
+            }
+        }
+
+        // Copy to device.
+        copyToDevice( "top_bvh_boxes", boxes, _data.top_bvh_boxes );
+        copyToDevice( "top_bvh_nodes", nodes, _data.top_bvh_nodes );
+        copyToDevice( "top_bvh_min_volume_id", min_volume_id,
+                      _data.top_bvh_min_volume_id );
+        copyToDevice( "top_bvh_volume_ids", order, _data.top_bvh_volume_ids );
+    }
+
+    // Recursively build a bounding volume hierarchy node over the primitives
+    // in order[begin,end) given their boxes and centroids. Primitives are
+    // split at the median centroid along the longest axis of the centroid
+    // bounds until a leaf has a few primitives. Returns the index of the
+    // node.
+    static int buildBvhNode( const std::vector<float>& primitive_boxes,
+                             const std::vector<float>& centroids,
+                             std::vector<int>& order, const int begin,
+                             const int end, std::vector<float>& boxes,
+                             std::vector<int>& nodes )
+    {
+        const int max_leaf_primitive = 4;
+
+        // Add the node.
+        int node = nodes.size() / 2;
+        nodes.resize( nodes.size() + 2 );
+        boxes.resize( boxes.size() + 6 );
+
+        // Compute the node box and the centroid bounds.
+        float box[6] = { FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX,
+                         -FLT_MAX };
+        float centroid_box[6] = { FLT_MAX,  FLT_MAX,  FLT_MAX,
+                                  -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        for ( int n = begin; n < end; ++n )
+        {
+            int p = order[n];
+            for ( int d = 0; d < 3; ++d )
+            {
+                box[d] = std::min( box[d], primitive_boxes[6 * p + d] );
+                box[d + 3] =
+                    std::max( box[d + 3], primitive_boxes[6 * p + d + 3] );
+                centroid_box[d] =
+                    std::min( centroid_box[d], centroids[3 * p + d] );
+                centroid_box[d + 3] =
+                    std::max( centroid_box[d + 3], centroids[3 * p + d] );
+            }
+        }
+
+        // Pad the box so roundoff in the ray-box test does not miss
+        // intersections on its boundary.
+        for ( int d = 0; d < 3 && begin < end; ++d )
+        {
+            float pad = 1.0e-5 * ( box[d + 3] - box[d] +
+                                   std::max( std::abs( box[d] ),
+                                             std::abs( box[d + 3] ) ) ) +
+                        FLT_MIN;
+            box[d] -= pad;
+            box[d + 3] += pad;
+        }
         for ( int i = 0; i < 6; ++i )
-            _global_bounding_box[i] = global_box( i );
+            boxes[6 * node + i] = box[i];
+
+        // Leaf.
+        if ( end - begin <= max_leaf_primitive )
+        {
+            nodes[2 * node] = -1 - begin;
+            nodes[2 * node + 1] = end;
+            return node;
+        }
+
+        // Split at the median along the longest axis.
+        int axis = 0;
+        for ( int d = 1; d < 3; ++d )
+            if ( centroid_box[d + 3] - centroid_box[d] >
+                 centroid_box[axis + 3] - centroid_box[axis] )
+                axis = d;
+        int mid = ( begin + end ) / 2;
+        std::nth_element( order.begin() + begin, order.begin() + mid,
+                          order.begin() + end, [&]( const int a, const int b ) {
+                              return centroids[3 * a + axis] <
+                                     centroids[3 * b + axis];
+                          } );
+        int left = buildBvhNode( primitive_boxes, centroids, order, begin, mid,
+                                 boxes, nodes );
+        int right = buildBvhNode( primitive_boxes, centroids, order, mid, end,
+                                  boxes, nodes );
+        nodes[2 * node] = left;
+        nodes[2 * node + 1] = right;
+        return node;
     }
 
-    // Given a global volume id get the local volume id.
-    int localVolumeId( const int global_id ) const
+    // Get the reference point of a local domain for point-in-volume parity.
+    // It is offset from the center of the domain by irregular fractions of
+    // its width so it is unlikely to lie on a facet.
+    static Kokkos::Array<float, 3>
+    localReferencePoint( const Kokkos::Array<double, 6>& local_box )
     {
-        return _volume_ids.find( global_id )->second;
+        const double fraction[3] = { 0.5713, 0.3873, 0.5931 };
+        Kokkos::Array<float, 3> x;
+        for ( int d = 0; d < 3; ++d )
+            x[d] = local_box[d] +
+                   fraction[d] * ( local_box[d + 3] - local_box[d] );
+        return x;
     }
 
-    // Given a global surface id get the local surface id.
-    int localSurfaceId( const int global_id ) const
+    // Bin the facets of a geometry by the local domains of the ranks. The
+    // padded domains are put in a hierarchy, as are the domains mapped into
+    // the part space of each instance, and the box of each facet is queried
+    // once against the hierarchies of its solid. The facets of each rank
+    // are given by their index in facet order.
+    static void
+    binRankFacets( const FacetGeometry<Kokkos::HostSpace>& geometry,
+                   const std::vector<double>& local_boxes,
+                   std::vector<std::vector<int>>& rank_volume_facets,
+                   std::vector<std::vector<int>>& rank_surface_facets )
     {
-        return _surface_ids.find( global_id )->second;
+        const auto& geom = geometry.data();
+        int num_rank = local_boxes.size() / 6;
+
+        // Pad the domains so roundoff does not miss facets on their
+        // boundaries.
+        std::vector<float> rank_boxes( 6 * num_rank );
+        for ( int r = 0; r < num_rank; ++r )
+        {
+            const double* local_box = &local_boxes[6 * r];
+            for ( int d = 0; d < 3; ++d )
+            {
+                double pad =
+                    1.0e-5 * ( local_box[d + 3] - local_box[d] +
+                               std::max( std::abs( local_box[d] ),
+                                         std::abs( local_box[d + 3] ) ) );
+                rank_boxes[6 * r + d] = local_box[d] - pad;
+                rank_boxes[6 * r + d + 3] = local_box[d + 3] + pad;
+            }
+        }
+
+        // Build the hierarchy of the domains and of the domains in the part
+        // space of each instance. The first tree is that of the domains and
+        // is queried by every solid.
+        std::vector<BoxTree> trees( 1 );
+        std::vector<std::vector<int>> part_trees( geom.numVolume(),
+                                                  std::vector<int>( 1, 0 ) );
+        trees[0].build( rank_boxes );
+        for ( int v = 0; v < geom.numVolume(); ++v )
+        {
+            int part_id = geometry._volume_part_ids[v];
+            if ( part_id != v )
+            {
+                std::vector<float> part_boxes( 6 * num_rank );
+                for ( int r = 0; r < num_rank; ++r )
+                    transformBox( &geometry._volume_to_part[12 * v],
+                                  &rank_boxes[6 * r], &part_boxes[6 * r] );
+                part_trees[part_id].push_back( trees.size() );
+                trees.emplace_back();
+                trees.back().build( part_boxes );
+            }
+        }
+        std::vector<std::vector<int>> surface_trees(
+            geom.numSurface(), std::vector<int>( 1, 0 ) );
+
+        // Bin the facets.
+        binFacets( geom.volume_facets, geom.volume_offsets, trees, part_trees,
+                   num_rank, rank_volume_facets );
+        binFacets( geom.surface_facets, geom.surface_offsets, trees,
+                   surface_trees, num_rank, rank_surface_facets );
     }
 
-    // Given a local volume id get the number of facets that compose the
-    // volume.
-    int numVolumeFacet( const int local_id ) const
+    // Host hierarchy over a set of boxes used to bin facets.
+    struct BoxTree
     {
-        return _volume_facet_count[local_id];
+        std::vector<float> primitive_boxes;
+        std::vector<int> order;
+        std::vector<float> boxes;
+        std::vector<int> nodes;
+
+        void build( const std::vector<float>& primitives )
+        {
+            primitive_boxes = primitives;
+            int num_primitive = primitives.size() / 6;
+            std::vector<float> centroids( 3 * num_primitive );
+            order.resize( num_primitive );
+            for ( int p = 0; p < num_primitive; ++p )
+            {
+                order[p] = p;
+                for ( int d = 0; d < 3; ++d )
+                    centroids[3 * p + d] =
+                        0.5 * ( primitives[6 * p + d] +
+                                primitives[6 * p + d + 3] );
+            }
+            buildBvhNode( primitive_boxes, centroids, order, 0, num_primitive,
+                          boxes, nodes );
+        }
+
+        // Call a functor with each primitive whose box intersects a box.
+        template <class Functor>
+        void query( const float box[6], const Functor& functor ) const
+        {
+            std::vector<int> stack( 1, 0 );
+            while ( !stack.empty() )
+            {
+                int n = stack.back();
+                stack.pop_back();
+                if ( !boxesIntersect( &boxes[6 * n], box ) )
+                    continue;
+                if ( nodes[2 * n] < 0 )
+                {
+                    for ( int i = -1 - nodes[2 * n]; i < nodes[2 * n + 1];
+                          ++i )
+                        if ( boxesIntersect( &primitive_boxes[6 * order[i]],
+                                             box ) )
+                            functor( order[i] );
+                }
+                else
+                {
+                    stack.push_back( nodes[2 * n] );
+                    stack.push_back( nodes[2 * n + 1] );
+                }
+            }
+        }
+    };
+
+    // Determine if two boxes intersect.
+    static bool boxesIntersect( const float a[6], const float b[6] )
+    {
+        for ( int d = 0; d < 3; ++d )
+            if ( a[d + 3] < b[d] || a[d] > b[d + 3] )
+                return false;
+        return true;
     }
 
-    // Given a local surface id get the number of facets that compose the
-    // surface.
-    int numSurfaceFacet( const int local_id ) const
+    // Bin the facets of each solid by the ranks whose boxes in any of the
+    // trees of the solid intersect the facet bounding box.
+    static void
+    binFacets( const Kokkos::View<float* [4][3], Kokkos::HostSpace>& facets,
+               const Kokkos::View<int*, Kokkos::HostSpace>& offsets,
+               const std::vector<BoxTree>& trees,
+               const std::vector<std::vector<int>>& solid_trees,
+               const int num_rank, std::vector<std::vector<int>>& rank_facets )
     {
-        return _surface_facet_count[local_id];
+        rank_facets.assign( num_rank, std::vector<int>() );
+        std::vector<int> rank_last_facet( num_rank, -1 );
+        for ( std::size_t s = 0; s < offsets.extent( 0 ); ++s )
+        {
+            int begin = ( 0 == s ) ? 0 : offsets( s - 1 );
+            for ( int f = begin; f < offsets( s ); ++f )
+            {
+                float f_box[6];
+                for ( int d = 0; d < 3; ++d )
+                {
+                    f_box[d] = std::min(
+                        facets( f, 0, d ),
+                        std::min( facets( f, 1, d ), facets( f, 2, d ) ) );
+                    f_box[d + 3] = std::max(
+                        facets( f, 0, d ),
+                        std::max( facets( f, 1, d ), facets( f, 2, d ) ) );
+                }
+                for ( auto t : solid_trees[s] )
+                    trees[t].query( f_box, [&]( const int r ) {
+                        if ( rank_last_facet[r] != f )
+                        {
+                            rank_last_facet[r] = f;
+                            rank_facets[r].push_back( f );
+                        }
+                    } );
+            }
+        }
     }
 
-    // Get the global bounding box.
-    const Kokkos::Array<double, 6>& globalBoundingBox() const
+    // Gather the facets with the given indices, in facet order, into
+    // per-solid counts and facet coordinates.
+    static void
+    gatherFacets( const Kokkos::View<float* [4][3], Kokkos::HostSpace>& facets,
+                  const Kokkos::View<int*, Kokkos::HostSpace>& offsets,
+                  const std::vector<int>& indices,
+                  std::vector<int>& solid_facet_counts,
+                  std::vector<float>& solid_facets )
     {
-        return _global_bounding_box;
+        solid_facet_counts.assign( offsets.extent( 0 ), 0 );
+        solid_facets.resize( 9 * indices.size() );
+        std::size_t s = 0;
+        for ( std::size_t i = 0; i < indices.size(); ++i )
+        {
+            int f = indices[i];
+            while ( f >= offsets( s ) )
+                ++s;
+            ++solid_facet_counts[s];
+            for ( int v = 0; v < 3; ++v )
+                for ( int d = 0; d < 3; ++d )
+                    solid_facets[9 * i + 3 * v + d] = facets( f, v, d );
+        }
     }
 
-    // Get the geometry data.
-    const FacetGeometryData<MemorySpace>& data() const { return _data; }
+    // MPI data types of distributed values.
+    static MPI_Datatype mpiType( const int ) { return MPI_INT; }
+    static MPI_Datatype mpiType( const float ) { return MPI_FLOAT; }
+
+    // Broadcast a vector from the first rank. The values are sent in
+    // chunks so the count of each message fits in an int.
+    template <class T>
+    void broadcastVector( std::vector<T>& values ) const
+    {
+        std::uint64_t size = values.size();
+        MPI_Bcast( &size, 1, MPI_UINT64_T, 0, _comm );
+        values.resize( size );
+        for ( std::uint64_t offset = 0; offset < size; offset += INT_MAX )
+        {
+            int count = std::min<std::uint64_t>( INT_MAX, size - offset );
+            MPI_Bcast( values.data() + offset, count, mpiType( T() ), 0,
+                       _comm );
+        }
+    }
+
+    // Send a vector from the first rank to another rank in chunks.
+    template <class T>
+    void sendVector( const std::vector<T>& values, const int rank ) const
+    {
+        std::uint64_t size = values.size();
+        MPI_Send( &size, 1, MPI_UINT64_T, rank, 0, _comm );
+        for ( std::uint64_t offset = 0; offset < size; offset += INT_MAX )
+        {
+            int count = std::min<std::uint64_t>( INT_MAX, size - offset );
+            MPI_Send( values.data() + offset, count, mpiType( T() ), rank, 0,
+                      _comm );
+        }
+    }
+
+    // Receive a vector sent from the first rank.
+    template <class T>
+    void receiveVector( std::vector<T>& values ) const
+    {
+        std::uint64_t size;
+        MPI_Recv( &size, 1, MPI_UINT64_T, 0, 0, _comm, MPI_STATUS_IGNORE );
+        values.resize( size );
+        for ( std::uint64_t offset = 0; offset < size; offset += INT_MAX )
+        {
+            int count = std::min<std::uint64_t>( INT_MAX, size - offset );
+            MPI_Recv( values.data() + offset, count, mpiType( T() ), 0, 0,
+                      _comm, MPI_STATUS_IGNORE );
+        }
+    }
 
-  private:
     // Put file data on device.
     void putFileDataOnDevice(
         const std::vector<int>& solid_ids,
@@ -482,6 +1447,26 @@ class FacetGeometry
     // Global bounding box.
     Kokkos::Array<double, 6> _global_bounding_box;
 
+    // Whether the geometry was restored from a cache file.
+    bool _from_cache;
+
+    // Communicator of a distributed geometry.
+    MPI_Comm _comm;
+
+    // Local part volume id of each volume.
+    std::vector<int> _volume_part_ids;
+
+    // Affine maps from the part space of each volume to world space. 12
+    // floats per volume in the layout of the volume to part maps.
+    std::vector<float> _volume_to_world;
+
+    // Affine maps from world space to the part space of each volume.
+    std::vector<float> _volume_to_part;
+
+    // Full geometry on the first rank of a distributed geometry until it is
+    // distributed.
+    std::shared_ptr<FacetGeometry<Kokkos::HostSpace>> _root_geometry;
+
     // Data.
     FacetGeometryData<MemorySpace> _data;
 };
@@ -532,15 +1517,57 @@ KOKKOS_FUNCTION bool pointFacetProjection( const float x[3], const float r[3],
 
 //---------------------------------------------------------------------------//
 // Fire a ray from point x along the given direction, r, and determine if it
-// intersects the facet.
+// intersects the facet before the ray parameter t_end.
 template <class FacetView>
 KOKKOS_FUNCTION bool rayFacetIntersect( const float x[3], const float r[3],
-                                        const FacetView& facets, const int f )
+                                        const FacetView& facets, const int f,
+                                        const float t_end = FLT_MAX )
 {
     // Project the point and check the distance.
     float y[3];
     auto projects = pointFacetProjection( x, r, facets, f, y );
-    return projects && ( y[2] > 0.0 );
+    return projects && ( y[2] > 0.0 ) && ( y[2] < t_end );
+}
+
+//---------------------------------------------------------------------------//
+// Fire a ray from point x along the given direction, r, and determine if it
+// intersects the facet before the ray parameter t_end. This is the
+// Moller-Trumbore test which gives the same barycentric coordinates and
+// distance as the facet projection without a general 3x3 solve.
+template <class FacetView>
+KOKKOS_FUNCTION bool mollerTrumboreIntersect( const float x[3],
+                                              const float r[3],
+                                              const FacetView& facets,
+                                              const int f,
+                                              const float t_end = FLT_MAX )
+{
+    // Edges from the first vertex.
+    float e1[3];
+    float e2[3];
+    for ( int d = 0; d < 3; ++d )
+    {
+        e1[d] = facets( f, 1, d ) - facets( f, 0, d );
+        e2[d] = facets( f, 2, d ) - facets( f, 0, d );
+    }
+
+    // Determinant of the system. If zero the ray is parallel to the facet.
+    float p[3] = { r[1] * e2[2] - r[2] * e2[1], r[2] * e2[0] - r[0] * e2[2],
+                   r[0] * e2[1] - r[1] * e2[0] };
+    float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+    float det_inv = 1.0f / det;
+
+    // Barycentric coordinates and distance.
+    float s[3] = { x[0] - facets( f, 0, 0 ), x[1] - facets( f, 0, 1 ),
+                   x[2] - facets( f, 0, 2 ) };
+    float q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2],
+                   s[0] * e1[1] - s[1] * e1[0] };
+    float u = ( s[0] * p[0] + s[1] * p[1] + s[2] * p[2] ) * det_inv;
+    float v = ( r[0] * q[0] + r[1] * q[1] + r[2] * q[2] ) * det_inv;
+    float t = ( e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2] ) * det_inv;
+
+    // Check for inclusion in the triangle and the distance.
+    return ( 0.0f != det ) & ( u >= 0.0f ) & ( v >= 0.0f ) &
+           ( u + v <= 1.0f ) & ( t > 0.0f ) & ( t < t_end );
 }
 
 //---------------------------------------------------------------------------//
@@ -555,10 +1582,145 @@ distanceToFacetPlane( const float x[3], const FacetView& facets, const int f )
 }
 
 //---------------------------------------------------------------------------//
-// Determine if a point is in a volume represented by a view of facets.
+// Compute the squared distance from a point to the closest point on a facet.
+// The closest point is found by determining which vertex, edge, or the
+// interior of the facet the point projects to.
 template <class FacetView>
-KOKKOS_FUNCTION bool pointInVolume( const float x[3],
-                                    const FacetView& volume_facets )
+KOKKOS_FUNCTION float pointFacetDistanceSquared( const float x[3],
+                                                 const FacetView& facets,
+                                                 const int f )
+{
+    // Project the vectors from each vertex to the point onto the edges from
+    // the first vertex.
+    float ab[3];
+    float ac[3];
+    float ax[3];
+    float d1 = 0.0;
+    float d2 = 0.0;
+    float d3 = 0.0;
+    float d4 = 0.0;
+    float d5 = 0.0;
+    float d6 = 0.0;
+    for ( int d = 0; d < 3; ++d )
+    {
+        ab[d] = facets( f, 1, d ) - facets( f, 0, d );
+        ac[d] = facets( f, 2, d ) - facets( f, 0, d );
+        ax[d] = x[d] - facets( f, 0, d );
+        float bx = x[d] - facets( f, 1, d );
+        float cx = x[d] - facets( f, 2, d );
+        d1 += ab[d] * ax[d];
+        d2 += ac[d] * ax[d];
+        d3 += ab[d] * bx;
+        d4 += ac[d] * bx;
+        d5 += ab[d] * cx;
+        d6 += ac[d] * cx;
+    }
+    float va = d3 * d6 - d5 * d4;
+    float vb = d5 * d2 - d1 * d6;
+    float vc = d1 * d4 - d3 * d2;
+
+    // Barycentric coordinates of the closest point.
+    float v;
+    float w;
+
+    // Vertex a region.
+    if ( d1 <= 0.0 && d2 <= 0.0 )
+    {
+        v = 0.0;
+        w = 0.0;
+    }
+
+    // Vertex b region.
+    else if ( d3 >= 0.0 && d4 <= d3 )
+    {
+        v = 1.0;
+        w = 0.0;
+    }
+
+    // Vertex c region.
+    else if ( d6 >= 0.0 && d5 <= d6 )
+    {
+        v = 0.0;
+        w = 1.0;
+    }
+
+    // Edge ab region.
+    else if ( vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0 )
+    {
+        v = d1 / ( d1 - d3 );
+        w = 0.0;
+    }
+
+    // Edge ac region.
+    else if ( vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0 )
+    {
+        v = 0.0;
+        w = d2 / ( d2 - d6 );
+    }
+
+    // Edge bc region.
+    else if ( va <= 0.0 && ( d4 - d3 ) >= 0.0 && ( d5 - d6 ) >= 0.0 )
+    {
+        w = ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) );
+        v = 1.0 - w;
+    }
+
+    // Interior region.
+    else
+    {
+        float denom = 1.0 / ( va + vb + vc );
+        v = vb * denom;
+        w = vc * denom;
+    }
+
+    // Distance to the closest point.
+    float dist_sqr = 0.0;
+    for ( int d = 0; d < 3; ++d )
+    {
+        float dx = ax[d] - v * ab[d] - w * ac[d];
+        dist_sqr += dx * dx;
+    }
+    return dist_sqr;
+}
+
+//---------------------------------------------------------------------------//
+// Determine if a ray from point x along the given direction, r, intersects
+// an axis-aligned box before the ray parameter t_end.
+template <class BoxView>
+KOKKOS_FUNCTION bool rayBoxIntersect( const float x[3], const float r[3],
+                                      const BoxView& boxes, const int n,
+                                      const float t_end = FLT_MAX )
+{
+    float t_min = 0.0;
+    float t_max = t_end;
+    for ( int d = 0; d < 3; ++d )
+    {
+        // Parallel to the slab.
+        if ( 0.0 == r[d] )
+        {
+            if ( x[d] < boxes( n, d ) || x[d] > boxes( n, d + 3 ) )
+                return false;
+        }
+
+        // Clip the ray with the slab.
+        else
+        {
+            float r_inv = 1.0 / r[d];
+            float t_0 = ( boxes( n, d ) - x[d] ) * r_inv;
+            float t_1 = ( boxes( n, d + 3 ) - x[d] ) * r_inv;
+            t_min = fmax( t_min, fmin( t_0, t_1 ) );
+            t_max = fmin( t_max, fmax( t_0, t_1 ) );
+            if ( t_min > t_max )
+                return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+// Generate the ray direction for point-in-volume tests.
+template <class DeviceType>
+KOKKOS_FUNCTION void pointInVolumeRay( float r[3] )
 {
     // The choice of ray direction is arbitrary so generate a random one. This
     // could potentially help with robustness as floating point noise may
@@ -571,30 +1733,142 @@ KOKKOS_FUNCTION bool pointInVolume( const float x[3],
     // Note: Duan has indicated that doing tests with 3 different random rays
     // has been enough to be robust as one is likely to pass out of the 3 if
     // is a true intersection.
-    using rand_type =
-        Kokkos::Random_XorShift64<typename FacetView::device_type>;
+    using rand_type = Kokkos::Random_XorShift64<DeviceType>;
     rand_type rng( 0 );
-    float r[3] = { Kokkos::rand<rand_type, float>::draw( rng ),
-                   Kokkos::rand<rand_type, float>::draw( rng ),
-                   Kokkos::rand<rand_type, float>::draw( rng ) };
+    for ( int d = 0; d < 3; ++d )
+        r[d] = Kokkos::rand<rand_type, float>::draw( rng );
     float r_mag_inv = 1.0 / sqrt( r[0] * r[0] + r[1] * r[1] + r[2] * r[2] );
     for ( int d = 0; d < 3; ++d )
         r[d] *= r_mag_inv;
+}
+
+//---------------------------------------------------------------------------//
+// Determine if a point is in a volume represented by a view of facets.
+template <class FacetView>
+KOKKOS_FUNCTION bool pointInVolume( const float x[3],
+                                    const FacetView& volume_facets )
+{
+    float r[3];
+    pointInVolumeRay<typename FacetView::device_type>( r );
 
     // Fire rays through each facet and count intersections. If an
     // odd number of intersections, the point is in the volume. This works for
     // convex and non-convex volumes.
     int count = 0;
     for ( std::size_t f = 0; f < volume_facets.extent( 0 ); ++f )
-        if ( rayFacetIntersect( x, r, volume_facets, f ) )
-            ++count;
+        count += mollerTrumboreIntersect( x, r, volume_facets, f );
     return ( 1 == count % 2 );
 }
 
+//---------------------------------------------------------------------------//
+// Apply the affine transformation of the given index to a point.
+template <class TransformView>
+KOKKOS_FUNCTION void affineTransformPoint( const TransformView& transforms,
+                                           const int n, const float x[3],
+                                           float y[3] )
+{
+    for ( int i = 0; i < 3; ++i )
+        y[i] = transforms( n, i, 0 ) * x[0] + transforms( n, i, 1 ) * x[1] +
+               transforms( n, i, 2 ) * x[2] + transforms( n, i, 3 );
+}
+
+//---------------------------------------------------------------------------//
+// Determine if a point is in a volume of the given facet geometry. The same
+// ray is fired as for a view of facets but only the facets in the leaves of
+// the bounding volume hierarchy of the volume which the ray passes through
+// are tested. If the geometry is
+// distributed the segment from the point to the reference point of the local
+// domain is used instead and the parity of its intersections is relative to
+// the reference point. The point is mapped into the space of the part of the
+// volume and tested against the part facets so instances are located with
+// the facets of their part.
+template <class MemorySpace>
+KOKKOS_FUNCTION bool pointInVolume( const float x_world[3],
+                                    const FacetGeometryData<MemorySpace>& geom,
+                                    const int volume_id )
+{
+    int part_id = geom.volume_part_ids( volume_id );
+    float x[3];
+    affineTransformPoint( geom.volume_to_part, volume_id, x_world, x );
+
+    float r[3];
+    float t_end = FLT_MAX;
+    if ( geom.distributed )
+    {
+        float reference_point[3] = { geom.reference_point[0],
+                                     geom.reference_point[1],
+                                     geom.reference_point[2] };
+        affineTransformPoint( geom.volume_to_part, volume_id,
+                              reference_point, r );
+        for ( int d = 0; d < 3; ++d )
+            r[d] -= x[d];
+        t_end = 1.0;
+    }
+    else
+    {
+        pointInVolumeRay<
+            typename decltype( geom.volume_facets )::device_type>( r );
+    }
+
+    // Traverse the tree and count intersections with the facets of the
+    // leaves the ray passes through. The tree is balanced so the stack only
+    // needs to be as deep as the tree.
+    int facet_offset =
+        ( 0 == part_id ) ? 0 : geom.volume_offsets( part_id - 1 );
+    int stack[64];
+    int stack_size = 0;
+    stack[stack_size++] = geom.volumeBvhRoot( part_id );
+    int count = 0;
+    while ( stack_size > 0 )
+    {
+        int n = stack[--stack_size];
+        if ( !rayBoxIntersect( x, r, geom.volume_bvh_boxes, n, t_end ) )
+            continue;
+
+        // Leaf.
+        if ( geom.volume_bvh_nodes( n, 0 ) < 0 )
+        {
+            int begin = facet_offset - 1 - geom.volume_bvh_nodes( n, 0 );
+            int end = facet_offset + geom.volume_bvh_nodes( n, 1 );
+            for ( int f = begin; f < end; ++f )
+                count += mollerTrumboreIntersect( x, r, geom.volume_facets,
+                                                  f, t_end );
+        }
+
+        // Internal node.
+        else
+        {
+            stack[stack_size++] = geom.volume_bvh_nodes( n, 0 );
+            stack[stack_size++] = geom.volume_bvh_nodes( n, 1 );
+        }
+    }
+    if ( geom.distributed )
+        return ( 1 == count % 2 ) !=
+               ( 1 == geom.volume_reference_inside( volume_id ) );
+    return ( 1 == count % 2 );
+}
+
+//---------------------------------------------------------------------------//
+// Determine if a point is in an axis-aligned box.
+template <class BoxView>
+KOKKOS_FUNCTION bool pointInBox( const float x[3], const BoxView& boxes,
+                                 const int n )
+{
+    return ( boxes( n, 0 ) <= x[0] && boxes( n, 1 ) <= x[1] &&
+             boxes( n, 2 ) <= x[2] && boxes( n, 3 ) >= x[0] &&
+             boxes( n, 4 ) >= x[1] && boxes( n, 5 ) >= x[2] );
+}
+
 //---------------------------------------------------------------------------//
 // Given a point determine the volume in the given facet geometry in which it
 // is located.If it is in the implicit complement, return -1. If it is outside
 // of the entire domain, return -2;
+//
+// Volumes are prioritized by local id. If the point is in more than one
+// volume the one with the smallest local id is returned. Only the volumes in
+// the leaves of the top-level bounding volume hierarchy which contain the
+// point are tested and subtrees with no volume of higher priority than the
+// volume found so far are skipped.
 template <class MemorySpace>
 KOKKOS_FUNCTION int locatePoint( const float x[3],
                                  const FacetGeometryData<MemorySpace>& geom )
@@ -603,41 +1877,62 @@ KOKKOS_FUNCTION int locatePoint( const float x[3],
     int gbv = geom.global_bounding_volume_id;
 
     // Start by checking that the point is in the global bounding volume.
-    if ( geom.volume_bounding_boxes( gbv, 0 ) <= x[0] &&
-         geom.volume_bounding_boxes( gbv, 1 ) <= x[1] &&
-         geom.volume_bounding_boxes( gbv, 2 ) <= x[2] &&
-         geom.volume_bounding_boxes( gbv, 3 ) >= x[0] &&
-         geom.volume_bounding_boxes( gbv, 4 ) >= x[1] &&
-         geom.volume_bounding_boxes( gbv, 5 ) >= x[2] )
-    {
-        // Check each volume except the global bounding volume for point
-        // inclusion.
-        for ( int v = 0; v < geom.numVolume(); ++v )
+    if ( pointInBox( x, geom.volume_bounding_boxes, gbv ) )
+    {
+        // Traverse the tree over the volume bounding boxes. Children with
+        // the highest priority volumes are pushed last so they are visited
+        // first.
+        int volume_id = -1;
+        int stack[64];
+        int stack_size = 0;
+        stack[stack_size++] = 0;
+        while ( stack_size > 0 )
         {
-            if ( v != gbv )
+            int n = stack[--stack_size];
+            if ( ( volume_id >= 0 &&
+                   geom.top_bvh_min_volume_id( n ) >= volume_id ) ||
+                 !pointInBox( x, geom.top_bvh_boxes, n ) )
+                continue;
+
+            // Leaf. First check if the point is in the axis-aligned bounding
+            // box of each volume and if so check against the volume facets
+            // for point inclusion.
+            if ( geom.top_bvh_nodes( n, 0 ) < 0 )
             {
-                // First check if the point is in the axis-aligned
-                // bounding box of the volume.
-                if ( geom.volume_bounding_boxes( v, 0 ) <= x[0] &&
-                     geom.volume_bounding_boxes( v, 1 ) <= x[1] &&
-                     geom.volume_bounding_boxes( v, 2 ) <= x[2] &&
-                     geom.volume_bounding_boxes( v, 3 ) >= x[0] &&
-                     geom.volume_bounding_boxes( v, 4 ) >= x[1] &&
-                     geom.volume_bounding_boxes( v, 5 ) >= x[2] )
+                int begin = -1 - geom.top_bvh_nodes( n, 0 );
+                int end = geom.top_bvh_nodes( n, 1 );
+                for ( int i = begin; i < end; ++i )
                 {
-                    // If in the bounding box, check against each volume
-                    // facet for point inclusion.
-                    if ( pointInVolume( x, geom.volumeFacets( v ) ) )
-                    {
-                        return v;
-                    }
+                    int v = geom.top_bvh_volume_ids( i );
+                    if ( ( volume_id < 0 || v < volume_id ) &&
+                         pointInBox( x, geom.volume_bounding_boxes, v ) &&
+                         pointInVolume( x, geom, v ) )
+                        volume_id = v;
+                }
+            }
+
+            // Internal node.
+            else
+            {
+                int left = geom.top_bvh_nodes( n, 0 );
+                int right = geom.top_bvh_nodes( n, 1 );
+                if ( geom.top_bvh_min_volume_id( left ) <
+                     geom.top_bvh_min_volume_id( right ) )
+                {
+                    stack[stack_size++] = right;
+                    stack[stack_size++] = left;
+                }
+                else
+                {
+                    stack[stack_size++] = left;
+                    stack[stack_size++] = right;
                 }
             }
         }
 
         // If the point was not in any volume it is in the implicit
         // complement so return -1.
-        return -1;
+        return volume_id;
     }
 
     // Otherwise point is outside of the global domain including the
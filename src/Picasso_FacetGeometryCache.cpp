@@ -0,0 +1,176 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Picasso_BroadcastFile.hpp>
+#include <Picasso_FacetGeometryCache.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace Picasso
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+// Cache file identifier.
+const char cache_magic[8] = { 'P', 'I', 'C', 'F', 'G', 'E', 'O', 'M' };
+
+// Cache format version. Increment when the layout of the cache or of the
+// processed geometry data changes.
+const std::uint32_t cache_version = 1;
+
+//---------------------------------------------------------------------------//
+// Write a vector as its size followed by its values.
+template <class T>
+void writeVector( std::ofstream& file, const std::vector<T>& values )
+{
+    std::uint64_t size = values.size();
+    file.write( reinterpret_cast<const char*>( &size ), sizeof( size ) );
+    file.write( reinterpret_cast<const char*>( values.data() ),
+                size * sizeof( T ) );
+}
+
+//---------------------------------------------------------------------------//
+// Read a vector written by writeVector. The size is checked against the
+// remaining file size before allocating. A stream which cannot report its
+// position is treated as a failed read.
+template <class T>
+bool readVector( std::istream& file, const std::uint64_t file_size,
+                 std::vector<T>& values )
+{
+    std::uint64_t size;
+    if ( !file.read( reinterpret_cast<char*>( &size ), sizeof( size ) ) )
+        return false;
+    std::streamoff position = file.tellg();
+    if ( position < 0 || static_cast<std::uint64_t>( position ) > file_size )
+        return false;
+    std::uint64_t remaining =
+        file_size - static_cast<std::uint64_t>( position );
+    if ( size > remaining / sizeof( T ) )
+        return false;
+    values.resize( size );
+    return static_cast<bool>( file.read(
+        reinterpret_cast<char*>( values.data() ), size * sizeof( T ) ) );
+}
+
+//---------------------------------------------------------------------------//
+// Read a facet geometry cache from a stream of the given size.
+bool readCache( std::istream& file, const std::uint64_t file_size,
+                const std::uint64_t stl_hash, FacetGeometryCacheData& data )
+{
+    // Check the header.
+    char magic[8];
+    std::uint32_t version;
+    std::uint64_t hash;
+    if ( !file.read( magic, 8 ) ||
+         !file.read( reinterpret_cast<char*>( &version ), sizeof( version ) ) ||
+         !file.read( reinterpret_cast<char*>( &hash ), sizeof( hash ) ) )
+        return false;
+    if ( 0 != std::memcmp( magic, cache_magic, 8 ) ||
+         cache_version != version || stl_hash != hash )
+        return false;
+
+    // Read the data.
+    return readVector( file, file_size, data.volume_ids ) &&
+           readVector( file, file_size, data.volume_facet_count ) &&
+           readVector( file, file_size, data.volume_facets ) &&
+           readVector( file, file_size, data.volume_bounding_boxes ) &&
+           readVector( file, file_size, data.volume_bvh_boxes ) &&
+           readVector( file, file_size, data.volume_bvh_nodes ) &&
+           readVector( file, file_size, data.volume_bvh_offsets ) &&
+           readVector( file, file_size, data.surface_ids ) &&
+           readVector( file, file_size, data.surface_facet_count ) &&
+           readVector( file, file_size, data.surface_facets );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end anonymous namespace
+
+//---------------------------------------------------------------------------//
+// Read a facet geometry cache file.
+bool readFacetGeometryCache( const std::string& filename,
+                             const std::uint64_t stl_hash,
+                             FacetGeometryCacheData& data )
+{
+    std::ifstream file( filename, std::ios::binary | std::ios::ate );
+    if ( !file )
+        return false;
+    std::uint64_t file_size = file.tellg();
+    file.seekg( 0 );
+    return readCache( file, file_size, stl_hash, data );
+}
+
+//---------------------------------------------------------------------------//
+// Read a facet geometry cache file on the first rank and broadcast it.
+bool readFacetGeometryCache( const std::string& filename,
+                             const std::uint64_t stl_hash,
+                             FacetGeometryCacheData& data, MPI_Comm comm )
+{
+    std::vector<char> contents;
+    if ( !broadcastFile( filename, comm, contents ) )
+        return false;
+    ContentsStreamBuffer buffer( contents );
+    std::istream file( &buffer );
+    return readCache( file, contents.size(), stl_hash, data );
+}
+
+//---------------------------------------------------------------------------//
+// Write a facet geometry cache file.
+void writeFacetGeometryCache( const std::string& filename,
+                              const std::uint64_t stl_hash,
+                              const FacetGeometryCacheData& data )
+{
+    // Write to a temporary file unique to this process.
+    std::string temp_filename =
+        filename + ".tmp." + std::to_string( getpid() );
+    {
+        std::ofstream file( temp_filename, std::ios::binary );
+        if ( !file )
+            throw std::runtime_error( "Unable to write geometry cache " +
+                                      temp_filename );
+        file.write( cache_magic, 8 );
+        file.write( reinterpret_cast<const char*>( &cache_version ),
+                    sizeof( cache_version ) );
+        file.write( reinterpret_cast<const char*>( &stl_hash ),
+                    sizeof( stl_hash ) );
+        writeVector( file, data.volume_ids );
+        writeVector( file, data.volume_facet_count );
+        writeVector( file, data.volume_facets );
+        writeVector( file, data.volume_bounding_boxes );
+        writeVector( file, data.volume_bvh_boxes );
+        writeVector( file, data.volume_bvh_nodes );
+        writeVector( file, data.volume_bvh_offsets );
+        writeVector( file, data.surface_ids );
+        writeVector( file, data.surface_facet_count );
+        writeVector( file, data.surface_facets );
+        if ( !file )
+            throw std::runtime_error( "Unable to write geometry cache " +
+                                      temp_filename );
+    }
+
+    // Move the complete file into place.
+    if ( 0 != std::rename( temp_filename.c_str(), filename.c_str() ) )
+    {
+        std::remove( temp_filename.c_str() );
+        throw std::runtime_error( "Unable to write geometry cache " +
+                                  filename );
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
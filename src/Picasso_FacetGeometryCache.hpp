@@ -0,0 +1,109 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef PICASSO_FACETGEOMETRYCACHE_HPP
+#define PICASSO_FACETGEOMETRYCACHE_HPP
+
+#include <mpi.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Picasso
+{
+//---------------------------------------------------------------------------//
+/*!
+  \brief Host copy of the processed data of a facet geometry. This is
+  everything derived from the STL file so a geometry can be restored from it
+  without parsing the file. Arrays are flattened in the layout of the
+  corresponding FacetGeometryData views.
+*/
+struct FacetGeometryCacheData
+{
+    // Global ids of the volumes in local id order.
+    std::vector<int> volume_ids;
+
+    // Number of facets in each volume.
+    std::vector<int> volume_facet_count;
+
+    // Volume facet vertices and unit normals. 12 floats per facet.
+    std::vector<float> volume_facets;
+
+    // Volume axis-aligned bounding boxes. 6 floats per volume.
+    std::vector<float> volume_bounding_boxes;
+
+    // Volume bounding volume hierarchy boxes. 6 floats per node.
+    std::vector<float> volume_bvh_boxes;
+
+    // Volume bounding volume hierarchy connectivity. 2 ints per node.
+    std::vector<int> volume_bvh_nodes;
+
+    // Volume bounding volume hierarchy node offsets.
+    std::vector<int> volume_bvh_offsets;
+
+    // Global ids of the surfaces in local id order.
+    std::vector<int> surface_ids;
+
+    // Number of facets in each surface.
+    std::vector<int> surface_facet_count;
+
+    // Surface facet vertices and unit normals. 12 floats per facet.
+    std::vector<float> surface_facets;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read a facet geometry cache file.
+  \param filename The cache file name.
+  \param stl_hash The hash of the STL file the geometry is built from.
+  \param data The cached geometry data.
+  \return True if the file exists, has the current cache version, and was
+  built from an STL file with the given hash. Otherwise false and the data is
+  unspecified.
+*/
+bool readFacetGeometryCache( const std::string& filename,
+                             const std::uint64_t stl_hash,
+                             FacetGeometryCacheData& data );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read a facet geometry cache file on the first rank of a
+  communicator and broadcast it to all ranks.
+  \param filename The cache file name.
+  \param stl_hash The hash of the STL file the geometry is built from.
+  \param data The cached geometry data.
+  \param comm The communicator.
+  \return True on all ranks if the cache is valid as for a file read by
+  every rank. Otherwise false on all ranks and the data is unspecified.
+*/
+bool readFacetGeometryCache( const std::string& filename,
+                             const std::uint64_t stl_hash,
+                             FacetGeometryCacheData& data, MPI_Comm comm );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Write a facet geometry cache file. The file is written to a
+  temporary file which is then renamed so concurrent readers never see a
+  partially written cache.
+  \param filename The cache file name.
+  \param stl_hash The hash of the STL file the geometry was built from.
+  \param data The geometry data to cache.
+*/
+void writeFacetGeometryCache( const std::string& filename,
+                              const std::uint64_t stl_hash,
+                              const FacetGeometryCacheData& data );
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
+
+#endif // end PICASSO_FACETGEOMETRYCACHE_HPP
@@ -0,0 +1,323 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef PICASSO_FACETLEVELSET_HPP
+#define PICASSO_FACETLEVELSET_HPP
+
+#include <Picasso_FacetGeometry.hpp>
+#include <Picasso_LevelSet.hpp>
+#include <Picasso_Types.hpp>
+
+#include <Cajita.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <ArborX.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <cmath>
+#include <memory>
+
+//---------------------------------------------------------------------------//
+// ArborX Data
+//---------------------------------------------------------------------------//
+// Search primitives. We build the tree from the facets of the volume we want
+// the level set for.
+namespace Picasso
+{
+template <class MemorySpace>
+struct FacetLevelSetPrimitiveData
+{
+    using memory_space = MemorySpace;
+    using size_type = int;
+    Kokkos::View<float* [4][3], MemorySpace> facets;
+};
+
+// Predicate storage - store the the 3d index of the mesh entity we are going to
+// search the tree with along with its coordinates.
+struct FacetLevelSetPredicateStorage
+{
+    int i;
+    int j;
+    int k;
+    float x[3];
+};
+
+// Search predicates. We search the tree with the mesh entities on which we
+// want to build the level set for all facets within the narrow band.
+template <class LocalMesh, class EntityType>
+struct FacetLevelSetPredicateData
+{
+    using memory_space = typename LocalMesh::memory_space;
+    using size_type = int;
+    using entity_type = EntityType;
+    LocalMesh local_mesh;
+    size_type size;
+    size_type i_size;
+    size_type ij_size;
+    float cutoff;
+
+    template <class LocalGrid>
+    FacetLevelSetPredicateData( const LocalMesh& lm,
+                                const LocalGrid& local_grid, const float c )
+        : local_mesh( lm )
+        , cutoff( c )
+    {
+        auto ghost_entities = local_grid.indexSpace(
+            Cajita::Ghost(), entity_type(), Cajita::Local() );
+        size = ghost_entities.size();
+        i_size = ghost_entities.extent( Dim::I );
+        ij_size = i_size * ghost_entities.extent( Dim::J );
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Query callback. When a facet within the cutoff is found we min-reduce the
+// exact distance from the entity to the facet.
+template <class MemorySpace, class DistanceView>
+struct FacetLevelSetCallback
+{
+    FacetLevelSetPrimitiveData<MemorySpace> primitive_data;
+    DistanceView distance;
+
+    template <typename Predicate>
+    KOKKOS_FUNCTION void operator()( Predicate const& predicate,
+                                     int primitive_index ) const
+    {
+        auto storage = getData( predicate );
+        double dist = sqrt( FacetGeometryOps::pointFacetDistanceSquared(
+            storage.x, primitive_data.facets, primitive_index ) );
+        Kokkos::atomic_fetch_min(
+            &distance( storage.i, storage.j, storage.k, 0 ), dist );
+    }
+};
+
+} // end namespace Picasso
+
+//---------------------------------------------------------------------------//
+// ArborX traits.
+namespace ArborX
+{
+
+// Create the primitives we build the tree from. These are the bounding boxes
+// of the volume facets.
+template <class MemorySpace>
+struct AccessTraits<Picasso::FacetLevelSetPrimitiveData<MemorySpace>,
+                    PrimitivesTag>
+{
+    using primitive_data = Picasso::FacetLevelSetPrimitiveData<MemorySpace>;
+    using memory_space = typename primitive_data::memory_space;
+    using size_type = typename primitive_data::size_type;
+    static size_type size( const primitive_data& data )
+    {
+        return data.facets.extent( 0 );
+    }
+    static KOKKOS_FUNCTION Box get( const primitive_data& data, size_type i )
+    {
+        const auto& f = data.facets;
+        return { { fmin( f( i, 0, 0 ), fmin( f( i, 1, 0 ), f( i, 2, 0 ) ) ),
+                   fmin( f( i, 0, 1 ), fmin( f( i, 1, 1 ), f( i, 2, 1 ) ) ),
+                   fmin( f( i, 0, 2 ), fmin( f( i, 1, 2 ), f( i, 2, 2 ) ) ) },
+                 { fmax( f( i, 0, 0 ), fmax( f( i, 1, 0 ), f( i, 2, 0 ) ) ),
+                   fmax( f( i, 0, 1 ), fmax( f( i, 1, 1 ), f( i, 2, 1 ) ) ),
+                   fmax( f( i, 0, 2 ), fmax( f( i, 1, 2 ), f( i, 2, 2 ) ) ) } };
+    }
+};
+
+// Create the predicates we search the tree with. These are the mesh entities
+// on which we build the level set.
+template <class LocalMesh, class EntityType>
+struct AccessTraits<Picasso::FacetLevelSetPredicateData<LocalMesh, EntityType>,
+                    PredicatesTag>
+{
+    using predicate_data =
+        Picasso::FacetLevelSetPredicateData<LocalMesh, EntityType>;
+    using entity_type = typename predicate_data::entity_type;
+    using memory_space = typename predicate_data::memory_space;
+    using size_type = typename predicate_data::size_type;
+    static size_type size( const predicate_data& data ) { return data.size; }
+    static KOKKOS_FUNCTION auto get( const predicate_data& data, size_type n )
+    {
+        // Get the entity index.
+        Picasso::FacetLevelSetPredicateStorage storage;
+        storage.k = n / data.ij_size;
+        storage.j = ( n - storage.k * data.ij_size ) / data.i_size;
+        storage.i = n - storage.j * data.i_size - storage.k * data.ij_size;
+        int index[3] = { storage.i, storage.j, storage.k };
+
+        // Get the coordinates of the entity.
+        double x[3];
+        data.local_mesh.coordinates( entity_type(), index, x );
+        for ( int d = 0; d < 3; ++d )
+            storage.x[d] = x[d];
+
+        // Find all facets within the cutoff of the entity. Attach the entity
+        // index to use in the callback.
+        return attach( intersects( Sphere{ Point{ storage.x[0], storage.x[1],
+                                                  storage.x[2] },
+                                           data.cutoff } ),
+                       storage );
+    }
+};
+
+} // end namespace ArborX
+
+//---------------------------------------------------------------------------//
+namespace Picasso
+{
+//---------------------------------------------------------------------------//
+/*!
+  \class FacetLevelSet
+  \brief Composes a signed distance function for a volume of a facet
+  geometry.
+
+  The distance from each entity to the volume surface is computed exactly
+  within the narrow band of the level set by querying a tree over the volume
+  facets for the facets within the band of the entity. The sign is given by
+  the parity of the volume facet crossings of a ray from the entity and is
+  negative inside the volume. Entities outside of the band get the band
+  width with the appropriate sign. Both the distance estimate and the signed
+  distance function of the level set are assigned so it does not need to be
+  redistanced.
+*/
+template <class MeshType, class SignedDistanceLocation>
+class FacetLevelSet
+{
+  public:
+    using mesh_type = MeshType;
+    using memory_space = typename mesh_type::memory_space;
+    using location_type = SignedDistanceLocation;
+    using entity_type = typename location_type::entity_type;
+    using level_set = LevelSet<MeshType, SignedDistanceLocation>;
+
+    /*!
+      \brief Construct the level set for a volume of a facet geometry.
+      \param ptree Level set settings.
+      \param mesh The mesh over which to build the signed distance function.
+      \param geometry The facet geometry. A distributed geometry must
+      already be distributed with the ghosted local domain of the mesh padded
+      by the band width.
+      \param volume_id The global id of the volume to build the level set
+      for.
+      \param exec_space The execution space to use for building the facet
+      tree.
+    */
+    template <class ExecutionSpace>
+    FacetLevelSet( const boost::property_tree::ptree& ptree,
+                   const std::shared_ptr<MeshType>& mesh,
+                   const FacetGeometry<memory_space>& geometry,
+                   const int volume_id, const ExecutionSpace& exec_space )
+        : _geom( geometry.data() )
+        , _volume_id( geometry.localVolumeId( volume_id ) )
+        , _ls( createLevelSet<SignedDistanceLocation>( ptree, mesh ) )
+    {
+        // Build the tree over the volume facets in world space. The geometry
+        // does not change so this is only done once.
+        _primitive_data.facets =
+            geometry.worldVolumeFacets( exec_space, _volume_id );
+        _bvh = ArborX::BVH<memory_space>( exec_space, _primitive_data );
+    }
+
+    /*!
+      \brief Compute the signed distance function from the volume facets.
+      Every rank has the facets within its ghosted local domain, either
+      because the geometry is replicated or because it was distributed with
+      that domain padded by the band width, so ghost entities are computed
+      directly and no halo exchange is needed.
+      \param exec_space The execution space to use for parallel kernels.
+    */
+    template <class ExecutionSpace>
+    void computeSignedDistance( const ExecutionSpace& exec_space )
+    {
+        // Arrays.
+        auto distance_estimate = _ls->getDistanceEstimate();
+        auto estimate_view = distance_estimate->view();
+        auto distance_view = _ls->getSignedDistance()->view();
+
+        // Local mesh.
+        auto local_grid = distance_estimate->layout()->localGrid();
+        auto local_mesh = Cajita::createLocalMesh<memory_space>( *local_grid );
+
+        // Compute the unsigned distance to the facets within the band of each
+        // entity. Entities with no facets in the band keep the band width.
+        double band_width = _ls->bandWidth();
+        Cajita::ArrayOp::assign( *distance_estimate, band_width,
+                                 Cajita::Ghost() );
+        FacetLevelSetPredicateData<decltype( local_mesh ), entity_type>
+            predicate_data( local_mesh, *local_grid, band_width );
+        FacetLevelSetCallback<memory_space, decltype( estimate_view )>
+            distance_callback;
+        distance_callback.primitive_data = _primitive_data;
+        distance_callback.distance = estimate_view;
+        _bvh.query( exec_space, predicate_data, distance_callback );
+
+        // Sign the distance by locating each entity in the volume.
+        auto geom = _geom;
+        int volume_id = _volume_id;
+        auto ghost_entities = local_grid->indexSpace(
+            Cajita::Ghost(), entity_type(), Cajita::Local() );
+        Kokkos::parallel_for(
+            "facet_level_set_sign",
+            Cajita::createExecutionPolicy( ghost_entities, exec_space ),
+            KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+                int entity_index[3] = { i, j, k };
+                double x[3];
+                local_mesh.coordinates( entity_type(), entity_index, x );
+                float xf[3] = { float( x[0] ), float( x[1] ), float( x[2] ) };
+                double dist = estimate_view( i, j, k, 0 );
+                if ( FacetGeometryOps::pointInVolume( xf, geom, volume_id ) )
+                    dist = -dist;
+                estimate_view( i, j, k, 0 ) = dist;
+                distance_view( i, j, k, 0 ) = dist;
+            } );
+    }
+
+    // Get the local id of the volume.
+    int localVolumeId() const { return _volume_id; }
+
+    // Get the level set.
+    std::shared_ptr<level_set> levelSet() const { return _ls; }
+
+  private:
+    FacetGeometryData<memory_space> _geom;
+    int _volume_id;
+    FacetLevelSetPrimitiveData<memory_space> _primitive_data;
+    ArborX::BVH<memory_space> _bvh;
+    std::shared_ptr<level_set> _ls;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Create a level set for a volume of a facet geometry.
+  \param ptree Level set settings.
+  \param mesh The mesh over which to build the signed distance function.
+  \param geometry The facet geometry.
+  \param volume_id The global id of the volume to build the level set for.
+  \param exec_space The execution space to use for building the facet tree.
+*/
+template <class SignedDistanceLocation, class MeshType, class ExecutionSpace>
+std::shared_ptr<FacetLevelSet<MeshType, SignedDistanceLocation>>
+createFacetLevelSet(
+    const boost::property_tree::ptree& ptree,
+    const std::shared_ptr<MeshType>& mesh,
+    const FacetGeometry<typename MeshType::memory_space>& geometry,
+    const int volume_id, const ExecutionSpace& exec_space )
+{
+    return std::make_shared<FacetLevelSet<MeshType, SignedDistanceLocation>>(
+        ptree, mesh, geometry, volume_id, exec_space );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
+
+#endif // end PICASSO_FACETLEVELSET_HPP
@@ -444,6 +444,11 @@ struct LogicalPosition : Vector<double, 3>
     static std::string label() { return "logical_position"; }
 };
 
+struct LogicalCellIndex : Vector<int, 3>
+{
+    static std::string label() { return "logical_cell_index"; }
+};
+
 struct SignedDistance : Scalar<double>
 {
     static std::string label() { return "signed_distance"; }
@@ -454,6 +459,11 @@ struct DistanceEstimate : Scalar<double>
     static std::string label() { return "distance_estimate"; }
 };
 
+struct ClosestPoint : Vector<double, 3>
+{
+    static std::string label() { return "closest_point"; }
+};
+
 struct Color : Scalar<int>
 {
     static std::string label() { return "color"; }
@@ -14,6 +14,7 @@
 
 #include <Picasso_FieldManager.hpp>
 #include <Picasso_FieldTypes.hpp>
+#include <Picasso_ParticleBins.hpp>
 
 #include <Cajita.hpp>
 
@@ -21,7 +22,10 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <cmath>
+#include <initializer_list>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
 
 namespace Picasso
@@ -351,6 +355,184 @@ struct GridOperatorDependencies<LocalDependencies<Layouts...>>
     }
 };
 
+//---------------------------------------------------------------------------//
+// Particle gather mode.
+//
+// By default particle operators are applied as a scatter where each particle
+// evaluates the kernel once and atomically adds its contributions to the
+// scatter dependencies. The floating point summation order then depends on
+// thread scheduling. In gather mode the particles are instead binned by cell
+// and each entity of a scatter dependency evaluates the kernel of every
+// particle in the neighboring cells in a fixed order, keeping only the
+// contributions made to itself. No atomics are used and results on a rank
+// are bitwise identical for any number of threads.
+//
+// The kernel is evaluated once per particle for each entity it could
+// contribute to so gather mode kernels must only read particle data and
+// write to scatter dependencies. Each entity only visits the cells in the
+// support of its spline of the given order and P2G interpolation only
+// evaluates the weight of the entity. The spline order must be the highest
+// order used by the kernel and may be at most cubic.
+struct ParticleGather
+{
+    int spline_order = 3;
+};
+
+//---------------------------------------------------------------------------//
+// Offset of the center of an entity from its low cell corner in each
+// dimension in units of half cells.
+template <class EntityType>
+struct EntityCenterOffset;
+
+template <>
+struct EntityCenterOffset<Cajita::Node>
+{
+    static int value( const int ) { return 0; }
+};
+
+template <>
+struct EntityCenterOffset<Cajita::Cell>
+{
+    static int value( const int ) { return 1; }
+};
+
+template <int D>
+struct EntityCenterOffset<Cajita::Face<D>>
+{
+    static int value( const int d ) { return ( d == D ) ? 0 : 1; }
+};
+
+template <int D>
+struct EntityCenterOffset<Cajita::Edge<D>>
+{
+    static int value( const int d ) { return ( d == D ) ? 1 : 0; }
+};
+
+//---------------------------------------------------------------------------//
+// Scatter dependency accumulator used in particle gather mode. Provides the
+// Kokkos::ScatterView access interface so kernels are unchanged between
+// modes. Contributions to the target entity are summed and all other
+// contributions are discarded. An accumulator with no target discards all
+// contributions.
+template <class Layout>
+struct GatherAccumulator
+{
+    using original_value_type = typename Layout::tag::value_type;
+    using value_type = original_value_type;
+
+    // Only the target entity receives contributions. See
+    // P2G::is_targeted_accumulator.
+    using targeted_accumulator = std::true_type;
+
+    // Local index of the target entity.
+    int i = -1;
+    int j = -1;
+    int k = -1;
+
+    // Target entity sum.
+    value_type* sum = nullptr;
+
+    // Sink for contributions to all other entities.
+    mutable value_type sink = 0;
+
+    // Get the accessor. The accumulator is its own accessor.
+    KOKKOS_INLINE_FUNCTION
+    const GatherAccumulator& access() const { return *this; }
+
+    // Get the contribution destination of an entity component.
+    KOKKOS_INLINE_FUNCTION
+    value_type& operator()( const int i0, const int i1, const int i2,
+                            const int i3 ) const
+    {
+        return ( i0 == i && i1 == j && i2 == k ) ? sum[i3] : sink;
+    }
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
+
+namespace Cajita
+{
+namespace P2G
+{
+// Allow the gather mode accumulator in the Cajita P2G interface.
+template <class Layout>
+struct is_scatter_view_impl<Picasso::GatherAccumulator<Layout>>
+    : public std::true_type
+{
+};
+
+} // end namespace P2G
+} // end namespace Cajita
+
+namespace Picasso
+{
+//---------------------------------------------------------------------------//
+// Particle tile mode.
+//
+// By default each particle in a particle loop reads the stencil of its gather
+// dependencies directly from global memory with no reuse between neighboring
+// particles. In tile mode the particles are binned by cell and the cells are
+// grouped into cubic tiles. Each tile is assigned to a thread team which
+// loads the gather dependencies of the tile and its stencil halo into team
+// scratch memory once, after which every particle in the tile reads from
+// scratch. Kernels are unchanged between modes.
+//
+// The tile size is the number of cells in each dimension of a tile. The halo
+// width is the number of entities loaded on each side of a tile and the
+// default covers all spline orders up to cubic on any entity type. The tiles
+// of all gather dependencies must fit in the scratch memory of the scratch
+// level.
+struct ParticleTile
+{
+    int tile_size = 4;
+    int halo_width = 2;
+    int scratch_level = 0;
+};
+
+//---------------------------------------------------------------------------//
+// Gather dependency tile used in particle tile mode. Provides the Kokkos::View
+// access interface over the team scratch copy of a field so field view
+// wrappers and kernels are unchanged between modes. Tile data is indexed
+// with local grid indices.
+template <class Layout>
+struct GridTile
+{
+    using value_type = typename Layout::tag::value_type;
+
+    static constexpr int extent = Layout::tag::size;
+
+    // Tile data.
+    value_type* data = nullptr;
+
+    // Local index of the first tile entity.
+    int origin[3] = { 0, 0, 0 };
+
+    // Number of tile entities in each dimension.
+    int width = 0;
+
+    // Get the stride of a dimension.
+    KOKKOS_FORCEINLINE_FUNCTION
+    int stride( const int d ) const
+    {
+        return ( 3 == d )   ? 1
+               : ( 2 == d ) ? extent
+               : ( 1 == d ) ? extent * width
+                            : extent * width * width;
+    }
+
+    // Access the tile data through full index arguments.
+    KOKKOS_FORCEINLINE_FUNCTION
+    value_type& operator()( const int i0, const int i1, const int i2,
+                            const int i3 ) const
+    {
+        return data[stride( 0 ) * ( i0 - origin[0] ) +
+                    stride( 1 ) * ( i1 - origin[1] ) +
+                    stride( 2 ) * ( i2 - origin[2] ) + i3];
+    }
+};
+
 //---------------------------------------------------------------------------//
 // Grid operator.
 //
@@ -431,6 +613,75 @@ class GridOperator
         applyImpl<void>( fm, exec_space, FieldLocation::Particle(), pl, func );
     }
 
+    // Apply the operator in a loop over particles as a deterministic grid
+    // gather. A work tag specifies the functor instance to use.
+    //
+    // Functor signature:
+    // func( work_tag, local_mesh,
+    //       gather_deps, scatter_deps, local_deps, particle_view )
+    //
+    // The functor may only read particle data. See ParticleGather.
+    template <class ExecutionSpace, class ParticleList_t, class WorkTag,
+              class Func>
+    void apply( FieldLocation::Particle, const ParticleGather& gather,
+                const ExecutionSpace& exec_space, const FieldManager<Mesh>& fm,
+                const ParticleList_t& pl, const WorkTag&,
+                const Func& func ) const
+    {
+        applyGatherImpl<WorkTag>( fm, exec_space, gather, pl, func );
+    }
+
+    // Apply the operator in a loop over particles as a deterministic grid
+    // gather. Functor does not have a work tag.
+    //
+    // Functor signature:
+    // func( local_mesh, gather_deps, scatter_deps, local_deps, particle_view )
+    //
+    // The functor may only read particle data. See ParticleGather.
+    template <class ExecutionSpace, class ParticleList_t, class Func>
+    void apply( FieldLocation::Particle, const ParticleGather& gather,
+                const ExecutionSpace& exec_space, const FieldManager<Mesh>& fm,
+                const ParticleList_t& pl, const Func& func ) const
+    {
+        applyGatherImpl<void>( fm, exec_space, gather, pl, func );
+    }
+
+    // Apply the operator in a loop over particles with gather dependencies
+    // read from team scratch tiles. A work tag specifies the functor
+    // instance to use.
+    //
+    // Functor signature:
+    // func( work_tag, local_mesh,
+    //       gather_deps, scatter_deps, local_deps, particle_view )
+    //
+    // The functor is given a ParticleView allowing the kernel to read and
+    // write particle data. See ParticleTile.
+    template <class ExecutionSpace, class ParticleList_t, class WorkTag,
+              class Func>
+    void apply( FieldLocation::Particle, const ParticleTile& tile,
+                const ExecutionSpace& exec_space, const FieldManager<Mesh>& fm,
+                const ParticleList_t& pl, const WorkTag&,
+                const Func& func ) const
+    {
+        applyTileImpl<WorkTag>( fm, exec_space, tile, pl, func );
+    }
+
+    // Apply the operator in a loop over particles with gather dependencies
+    // read from team scratch tiles. Functor does not have a work tag.
+    //
+    // Functor signature:
+    // func( local_mesh, gather_deps, scatter_deps, local_deps, particle_view )
+    //
+    // The functor is given a ParticleView allowing the kernel to read and
+    // write particle data. See ParticleTile.
+    template <class ExecutionSpace, class ParticleList_t, class Func>
+    void apply( FieldLocation::Particle, const ParticleTile& tile,
+                const ExecutionSpace& exec_space, const FieldManager<Mesh>& fm,
+                const ParticleList_t& pl, const Func& func ) const
+    {
+        applyTileImpl<void>( fm, exec_space, tile, pl, func );
+    }
+
     // Apply the operator in a loop over the owned entities of the given
     // type. A work tag specifies the functor instance to use.
     //
@@ -493,6 +744,112 @@ class GridOperator
         field_deps::scatter( _scatter_halo, fm, exec_space );
     }
 
+    // Manage field dependencies and apply the operator as a particle gather.
+    template <class WorkTag, class ExecutionSpace, class ParticleList_t,
+              class Func>
+    void applyGatherImpl( const FieldManager<Mesh>& fm,
+                          const ExecutionSpace& exec_space,
+                          const ParticleGather& gather,
+                          const ParticleList_t& pl, const Func& func ) const
+    {
+        // Gather distributed dependencies.
+        field_deps::gather( _gather_halo, fm, exec_space );
+
+        // Create gather dependency data structure for device capture.
+        auto gather_deps =
+            createDependencies( fm, typename field_deps::gather_dep_type() );
+
+        // Create local dependency data structure for device capture.
+        auto local_deps =
+            createDependencies( fm, typename field_deps::local_dep_type() );
+
+        // Create local mesh.
+        auto local_mesh =
+            Cajita::createLocalMesh<ExecutionSpace>( *( _mesh->localGrid() ) );
+
+        // Bin the particles by cell.
+        auto bins = binParticles( exec_space, pl );
+
+        // Gather the particle contributions to each scatter dependency.
+        applyGatherOp<WorkTag>( local_mesh, gather_deps, local_deps,
+                                exec_space, gather, bins, fm, pl, func,
+                                typename field_deps::scatter_dep_type() );
+
+        // Scatter distributed dependencies.
+        field_deps::scatter( _scatter_halo, fm, exec_space );
+    }
+
+    // Manage field dependencies and apply the operator in particle tiles.
+    template <class WorkTag, class ExecutionSpace, class ParticleList_t,
+              class Func>
+    void applyTileImpl( const FieldManager<Mesh>& fm,
+                        const ExecutionSpace& exec_space,
+                        const ParticleTile& tile, const ParticleList_t& pl,
+                        const Func& func ) const
+    {
+        // Gather distributed dependencies.
+        field_deps::gather( _gather_halo, fm, exec_space );
+
+        // Create gather dependency data structure for device capture.
+        auto gather_deps =
+            createDependencies( fm, typename field_deps::gather_dep_type() );
+
+        // Create scatter dependency data structure for device capture.
+        auto scatter_deps =
+            createDependencies( fm, typename field_deps::scatter_dep_type() );
+
+        // Create local dependency data structure for device capture.
+        auto local_deps =
+            createDependencies( fm, typename field_deps::local_dep_type() );
+
+        // Create local mesh.
+        auto local_mesh =
+            Cajita::createLocalMesh<ExecutionSpace>( *( _mesh->localGrid() ) );
+
+        // Bin the particles by cell.
+        auto bins = binParticles( exec_space, pl );
+
+        // Apply the operator.
+        applyTileOp<WorkTag>( local_mesh, gather_deps, scatter_deps,
+                              local_deps, exec_space, tile, bins, pl, func,
+                              typename field_deps::gather_dep_type() );
+
+        // Contribute local scatter view results.
+        contributeScatterDependencies( fm, scatter_deps );
+
+        // Scatter distributed dependencies.
+        field_deps::scatter( _scatter_halo, fm, exec_space );
+    }
+
+    // Bin particles by cell using their cached cell index. The index is
+    // computed at initialization and on every redistribution and must be
+    // updated by kernels which move particles in between.
+    template <class ExecutionSpace, class ParticleList_t>
+    std::enable_if_t<ParticleList_t::template has_field<
+                         Field::LogicalCellIndex>::value,
+                     ParticleBins<memory_space>>
+    binParticles( const ExecutionSpace& exec_space,
+                  const ParticleList_t& pl ) const
+    {
+        ParticleBins<memory_space> bins;
+        bins.buildFromCellIndex( exec_space, *( _mesh->localGrid() ),
+                                 pl.slice( Field::LogicalCellIndex() ) );
+        return bins;
+    }
+
+    // Bin particles by cell using their positions.
+    template <class ExecutionSpace, class ParticleList_t>
+    std::enable_if_t<!ParticleList_t::template has_field<
+                         Field::LogicalCellIndex>::value,
+                     ParticleBins<memory_space>>
+    binParticles( const ExecutionSpace& exec_space,
+                  const ParticleList_t& pl ) const
+    {
+        return ParticleBins<memory_space>(
+            exec_space, *( _mesh->localGrid() ),
+            pl.slice( Field::LogicalPosition() ) );
+    }
+
     // Create parameter pack of gather dependency views. Gather dependencies
     // don't require a scatter in a kernel so we store them as a parameter
     // pack Kokkos::View for on-device access. The resulting views are stored
@@ -671,6 +1028,311 @@ class GridOperator
             } );
     }
 
+    // Apply the operator as a particle gather. Each scatter dependency is
+    // gathered in a separate pass with the accumulators of all other scatter
+    // dependencies left without a target.
+    template <class WorkTag, class LocalMesh, class GatherFields,
+              class LocalFields, class ExecutionSpace, class ParticleList_t,
+              class Func, class... Layouts>
+    void applyGatherOp( const LocalMesh& local_mesh,
+                        const GatherFields& gather_deps,
+                        const LocalFields& local_deps,
+                        const ExecutionSpace& exec_space,
+                        const ParticleGather& gather,
+                        const ParticleBins<memory_space>& bins,
+                        const FieldManager<Mesh>& fm, const ParticleList_t& pl,
+                        const Func& func,
+                        ScatterDependencies<Layouts...> ) const
+    {
+        // Create the accumulators with no targets.
+        auto accumulators =
+            Cajita::makeParameterPack( GatherAccumulator<Layouts>()... );
+        auto scatter_deps = createFieldViewTuple<Layouts...>( accumulators );
+
+        // Gather each dependency. Use the initializer list here to achieve a
+        // C++17 fold expression in C++14.
+        std::ignore = std::initializer_list<int>{
+            ( applyGatherLayoutOp<WorkTag, Layouts>(
+                  local_mesh, gather_deps, scatter_deps, local_deps,
+                  exec_space, gather, bins, fm, pl, func ),
+              0 )... };
+    }
+
+    // Gather the particle contributions to a single scatter dependency in a
+    // loop over its ghosted entities. Contributions to ghosted entities are
+    // completed by the halo scatter.
+    template <class WorkTag, class Layout, class LocalMesh,
+              class GatherFields, class ScatterFields, class LocalFields,
+              class ExecutionSpace, class ParticleList_t, class Func>
+    void applyGatherLayoutOp( const LocalMesh& local_mesh,
+                              const GatherFields& gather_deps,
+                              const ScatterFields& inactive_deps,
+                              const LocalFields& local_deps,
+                              const ExecutionSpace& exec_space,
+                              const ParticleGather& gather,
+                              const ParticleBins<memory_space>& bins,
+                              const FieldManager<Mesh>& fm,
+                              const ParticleList_t& pl,
+                              const Func& func ) const
+    {
+        using location = typename Layout::location;
+        using tag = typename Layout::tag;
+        using value_type = typename tag::value_type;
+
+        // Get the particle aosoa.
+        const int vector_length = ParticleList_t::aosoa_type::vector_length;
+        auto aosoa = pl.aosoa();
+
+        // Get the destination field.
+        auto view = fm.view( location(), tag() );
+
+        // Cells in the spline support of an entity relative to the entity
+        // index. A particle contributes to an entity if it is closer than
+        // half of the spline order plus one cells to the entity center.
+        if ( gather.spline_order < 0 || gather.spline_order > 3 )
+            throw std::runtime_error(
+                "Particle gather spline order must be between 0 and 3" );
+        Kokkos::Array<int, 3> cell_lo;
+        Kokkos::Array<int, 3> cell_hi;
+        for ( int d = 0; d < 3; ++d )
+        {
+            int offset = EntityCenterOffset<
+                typename location::entity_type>::value( d );
+            cell_lo[d] = static_cast<int>(
+                std::floor( 0.5 * ( offset - gather.spline_order - 1 ) ) );
+            cell_hi[d] = static_cast<int>(
+                             std::ceil( 0.5 * ( offset + gather.spline_order +
+                                                1 ) ) ) -
+                         1;
+        }
+
+        // Apply the kernel of every particle near each entity. Particles are
+        // visited in a fixed order so the summation order is independent of
+        // thread scheduling.
+        auto entities = _mesh->localGrid()->indexSpace(
+            Cajita::Ghost(), typename location::entity_type(),
+            Cajita::Local() );
+        Kokkos::parallel_for(
+            "operator_apply_gather",
+            Cajita::createExecutionPolicy( entities, exec_space ),
+            KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+                // Target entity sum.
+                value_type sum[tag::size];
+                for ( int n = 0; n < tag::size; ++n )
+                    sum[n] = 0.0;
+
+                // Target this entity with the dependency accumulator.
+                auto scatter_deps = inactive_deps;
+                auto& target = scatter_deps.get( location(), tag() );
+                target.i = i;
+                target.j = j;
+                target.k = k;
+                target.sum = sum;
+
+                // Neighboring cells.
+                int entity[3] = { i, j, k };
+                int cell_min[3];
+                int cell_max[3];
+                for ( int d = 0; d < 3; ++d )
+                {
+                    cell_min[d] = entity[d] + cell_lo[d];
+                    cell_min[d] = ( cell_min[d] < 0 ) ? 0 : cell_min[d];
+                    cell_max[d] = entity[d] + cell_hi[d];
+                    cell_max[d] = ( cell_max[d] < bins.numBin( d ) )
+                                      ? cell_max[d]
+                                      : bins.numBin( d ) - 1;
+                }
+
+                // Apply the kernel of each particle in the neighboring cells.
+                for ( int ci = cell_min[Dim::I]; ci <= cell_max[Dim::I]; ++ci )
+                    for ( int cj = cell_min[Dim::J]; cj <= cell_max[Dim::J];
+                          ++cj )
+                        for ( int ck = cell_min[Dim::K];
+                              ck <= cell_max[Dim::K]; ++ck )
+                        {
+                            int offset = bins.binOffset( ci, cj, ck );
+                            int size = bins.binSize( ci, cj, ck );
+                            for ( int n = offset; n < offset + size; ++n )
+                            {
+                                int p = bins.permutation( n );
+                                typename ParticleList_t::particle_view_type
+                                    particle(
+                                        aosoa.access( p / vector_length ),
+                                        p % vector_length );
+                                functorTagDispatch<WorkTag>(
+                                    func, local_mesh, gather_deps,
+                                    scatter_deps, local_deps, particle );
+                            }
+                        }
+
+                // Write the result.
+                for ( int n = 0; n < tag::size; ++n )
+                    view( i, j, k, n ) = sum[n];
+            } );
+    }
+
+    // Apply the operator in particle tiles. Each team loads a tile of each
+    // gather dependency into scratch and then applies the kernel to every
+    // particle located in the cells of the tile.
+    template <class WorkTag, class LocalMesh, class GatherFields,
+              class ScatterFields, class LocalFields, class ExecutionSpace,
+              class ParticleList_t, class Func, class... Layouts>
+    void applyTileOp( const LocalMesh& local_mesh,
+                      const GatherFields& gather_deps,
+                      const ScatterFields& scatter_deps,
+                      const LocalFields& local_deps,
+                      const ExecutionSpace& exec_space,
+                      const ParticleTile& tile,
+                      const ParticleBins<memory_space>& bins,
+                      const ParticleList_t& pl, const Func& func,
+                      GatherDependencies<Layouts...> ) const
+    {
+        using team_policy = Kokkos::TeamPolicy<ExecutionSpace>;
+        using scratch_space = typename ExecutionSpace::scratch_memory_space;
+
+        // Get the particle aosoa.
+        const int vector_length = ParticleList_t::aosoa_type::vector_length;
+        auto aosoa = pl.aosoa();
+
+        // Tile geometry.
+        const int tile_size = tile.tile_size;
+        const int halo_width = tile.halo_width;
+        const int tile_width = tile_size + 2 * halo_width + 1;
+        const int tile_volume = tile_width * tile_width * tile_width;
+        Kokkos::Array<int, 3> num_tile;
+        for ( int d = 0; d < 3; ++d )
+            num_tile[d] = ( bins.numBin( d ) + tile_size - 1 ) / tile_size;
+
+        // Create the gather dependency tiles. Tile data is assigned in each
+        // team.
+        auto tile_views = Cajita::makeParameterPack(
+            Field::createViewWrapper( Layouts(), GridTile<Layouts>() )... );
+        auto tiles = createFieldViewTuple<Layouts...>( tile_views );
+
+        // Compute the scratch size of one tile of each gather dependency.
+        std::size_t scratch_size = 0;
+        std::ignore = std::initializer_list<int>{
+            ( scratch_size +=
+              Kokkos::View<typename Layouts::tag::value_type*, scratch_space,
+                           Kokkos::MemoryUnmanaged>::
+                  shmem_size( tile_volume * Layouts::tag::size ),
+              0 )... };
+
+        // Check that the tiles fit in the scratch level.
+        const int scratch_level = tile.scratch_level;
+        const std::size_t scratch_size_max =
+            team_policy::scratch_size_max( scratch_level );
+        if ( scratch_size > scratch_size_max )
+            throw std::runtime_error(
+                "Particle tile exceeds the maximum scratch size of its level" );
+
+        // Apply kernel to each particle in each tile. The user functor gets
+        // gather dependencies which read from the team scratch tiles.
+        team_policy policy( exec_space,
+                            num_tile[Dim::I] * num_tile[Dim::J] *
+                                num_tile[Dim::K],
+                            Kokkos::AUTO );
+        Kokkos::parallel_for(
+            "operator_apply_tile",
+            policy.set_scratch_size( scratch_level,
+                                     Kokkos::PerTeam( scratch_size ) ),
+            KOKKOS_LAMBDA( const typename team_policy::member_type& team ) {
+                // Get the first cell of the tile.
+                int t = team.league_rank();
+                int ti = t % num_tile[Dim::I];
+                int tj = ( t / num_tile[Dim::I] ) % num_tile[Dim::J];
+                int tk = t / ( num_tile[Dim::I] * num_tile[Dim::J] );
+                Kokkos::Array<int, 3> cell_origin = {
+                    tile_size * ti, tile_size * tj, tile_size * tk };
+
+                // Load the gather dependency tiles. The dummy array expands
+                // the loads in device code.
+                auto tile_deps = tiles;
+                int loads[] = { 0, ( loadTile<Layouts>(
+                                         team, scratch_level, cell_origin,
+                                         halo_width, tile_width, gather_deps,
+                                         tile_deps ),
+                                     0 )... };
+                (void)loads;
+                team.team_barrier();
+
+                // Apply the kernel to the particles in each cell of the tile.
+                const int tile_cells = tile_size * tile_size * tile_size;
+                Kokkos::parallel_for(
+                    Kokkos::TeamThreadRange( team, tile_cells ),
+                    [&]( const int n ) {
+                        int ci = cell_origin[Dim::I] + n % tile_size;
+                        int cj = cell_origin[Dim::J] + ( n / tile_size ) %
+                                                           tile_size;
+                        int ck = cell_origin[Dim::K] +
+                                 n / ( tile_size * tile_size );
+                        if ( ci < bins.numBin( Dim::I ) &&
+                             cj < bins.numBin( Dim::J ) &&
+                             ck < bins.numBin( Dim::K ) )
+                        {
+                            int offset = bins.binOffset( ci, cj, ck );
+                            int size = bins.binSize( ci, cj, ck );
+                            for ( int m = offset; m < offset + size; ++m )
+                            {
+                                int p = bins.permutation( m );
+                                typename ParticleList_t::particle_view_type
+                                    particle(
+                                        aosoa.access( p / vector_length ),
+                                        p % vector_length );
+                                functorTagDispatch<WorkTag>(
+                                    func, local_mesh, tile_deps, scatter_deps,
+                                    local_deps, particle );
+                            }
+                        }
+                    } );
+            } );
+    }
+
+    // Load a tile of a gather dependency into team scratch.
+    template <class Layout, class TeamMember, class GatherFields,
+              class TileFields>
+    KOKKOS_INLINE_FUNCTION void
+    loadTile( const TeamMember& team, const int scratch_level,
+              const Kokkos::Array<int, 3>& cell_origin, const int halo_width,
+              const int tile_width, const GatherFields& gather_deps,
+              TileFields& tile_deps ) const
+    {
+        using location = typename Layout::location;
+        using tag = typename Layout::tag;
+        using value_type = typename tag::value_type;
+        using scratch_view =
+            Kokkos::View<value_type*,
+                         typename TeamMember::execution_space::
+                             scratch_memory_space,
+                         Kokkos::MemoryUnmanaged>;
+
+        // Allocate the tile.
+        const int tile_volume = tile_width * tile_width * tile_width;
+        scratch_view scratch( team.team_scratch( scratch_level ),
+                              tile_volume * tag::size );
+        auto& dst = tile_deps.get( location(), tag() )._v;
+        dst.data = scratch.data();
+        dst.width = tile_width;
+        for ( int d = 0; d < 3; ++d )
+            dst.origin[d] = cell_origin[d] - halo_width;
+
+        // Copy the entities of the tile that are in the local grid.
+        const auto& src = gather_deps.get( location(), tag() )._v;
+        Kokkos::parallel_for(
+            Kokkos::TeamThreadRange( team, tile_volume ), [&]( const int n ) {
+                int i = dst.origin[Dim::I] + n / ( tile_width * tile_width );
+                int j = dst.origin[Dim::J] + ( n / tile_width ) % tile_width;
+                int k = dst.origin[Dim::K] + n % tile_width;
+                if ( i >= 0 && i < static_cast<int>( src.extent( 0 ) ) &&
+                     j >= 0 && j < static_cast<int>( src.extent( 1 ) ) &&
+                     k >= 0 && k < static_cast<int>( src.extent( 2 ) ) )
+                {
+                    for ( int c = 0; c < tag::size; ++c )
+                        dst( i, j, k, c ) = src( i, j, k, c );
+                }
+            } );
+    }
+
   private:
     std::shared_ptr<Mesh> _mesh;
     std::shared_ptr<Cajita::Halo<memory_space>> _gather_halo;
@@ -0,0 +1,219 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef PICASSO_GRIDTRANSFER_HPP
+#define PICASSO_GRIDTRANSFER_HPP
+
+#include <Picasso_Types.hpp>
+
+#include <Cajita.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Picasso
+{
+namespace GridTransfer
+{
+//---------------------------------------------------------------------------//
+/*
+  Transfer operators between uniform meshes over the same domain with the
+  same domain decomposition whose cell sizes differ by an integer factor
+  (e.g. a mesh and one created from it with a scaled cell size). Because each
+  rank owns the same region of space in both meshes all transfers are local
+  to a rank.
+*/
+//---------------------------------------------------------------------------//
+// Range of fine entity offsets from the first fine entity of a coarse entity
+// and their averaging weights for a given coarsening factor. A coarse node
+// averages the fine nodes within one coarse cell of it with tent weights and
+// a coarse cell averages the fine cells it contains with uniform weights.
+// These weights are the transpose of linear interpolation scaled such that
+// they sum to one in which case the average of the fine values over the
+// domain is preserved.
+KOKKOS_INLINE_FUNCTION
+int averageBegin( Cajita::Node, const int factor ) { return 1 - factor; }
+
+KOKKOS_INLINE_FUNCTION
+int averageBegin( Cajita::Cell, const int ) { return 0; }
+
+KOKKOS_INLINE_FUNCTION
+int averageEnd( Cajita::Node, const int factor ) { return factor; }
+
+KOKKOS_INLINE_FUNCTION
+int averageEnd( Cajita::Cell, const int factor ) { return factor; }
+
+KOKKOS_INLINE_FUNCTION
+double averageWeight( Cajita::Node, const int offset, const int factor )
+{
+    int distance = ( offset < 0 ) ? -offset : offset;
+    return static_cast<double>( factor - distance ) / ( factor * factor );
+}
+
+KOKKOS_INLINE_FUNCTION
+double averageWeight( Cajita::Cell, const int, const int factor )
+{
+    return 1.0 / factor;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Interpolate an array to the owned entities of an array on another
+  mesh with linear interpolation. Linear functions are reproduced exactly.
+  This is typically used to transfer from a coarse mesh to a fine mesh.
+  \param exec_space The execution space to use for parallel kernels.
+  \param source The array to interpolate from. Its ghost values must be
+  current.
+  \param target The array to interpolate to. Must have the same number of
+  degrees of freedom as the source.
+*/
+template <class ExecutionSpace, class SourceArray, class TargetArray>
+void interpolate( const ExecutionSpace& exec_space, const SourceArray& source,
+                  TargetArray& target )
+{
+    using memory_space = typename TargetArray::memory_space;
+    using source_entity = typename SourceArray::entity_type;
+    using target_entity = typename TargetArray::entity_type;
+
+    // Local meshes.
+    auto source_mesh = Cajita::createLocalMesh<memory_space>(
+        *( source.layout()->localGrid() ) );
+    auto target_mesh = Cajita::createLocalMesh<memory_space>(
+        *( target.layout()->localGrid() ) );
+
+    // Interpolate to each owned target entity.
+    auto source_view = source.view();
+    auto target_view = target.view();
+    int num_dof = target_view.extent( 3 );
+    auto own_entities = target.layout()->localGrid()->indexSpace(
+        Cajita::Own(), target_entity(), Cajita::Local() );
+    Kokkos::parallel_for(
+        "grid_transfer_interpolate",
+        Cajita::createExecutionPolicy( own_entities, exec_space ),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            // Get the entity location in the source mesh. Clamp to guard
+            // against roundoff at the boundary of the local domain.
+            int entity_index[3] = { i, j, k };
+            double x[3];
+            target_mesh.coordinates( target_entity(), entity_index, x );
+            for ( int d = 0; d < 3; ++d )
+                x[d] = fmin( source_mesh.highCorner( Cajita::Ghost(), d ),
+                             fmax( source_mesh.lowCorner( Cajita::Ghost(), d ),
+                                   x[d] ) );
+
+            // Evaluate the linear basis.
+            Cajita::SplineData<double, 1, source_entity> sd;
+            Cajita::evaluateSpline( source_mesh, x, sd );
+
+            // Interpolate each degree of freedom.
+            for ( int n = 0; n < num_dof; ++n )
+            {
+                double value = 0.0;
+                for ( int si = 0; si < 2; ++si )
+                    for ( int sj = 0; sj < 2; ++sj )
+                        for ( int sk = 0; sk < 2; ++sk )
+                            value += sd.w[Dim::I][si] * sd.w[Dim::J][sj] *
+                                     sd.w[Dim::K][sk] *
+                                     source_view( sd.s[Dim::I][si],
+                                                  sd.s[Dim::J][sj],
+                                                  sd.s[Dim::K][sk], n );
+                target_view( i, j, k, n ) = value;
+            }
+        } );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Average an array on a fine mesh to the owned entities of an array
+  on a coarser mesh. The averaging weights are the transpose of linear
+  interpolation normalized to sum to one so the average of a field over the
+  domain is preserved.
+  \param exec_space The execution space to use for parallel kernels.
+  \param fine The array on the fine mesh. Its ghost values must be current
+  and its halo must be at least one fewer cells wide than the coarsening
+  factor.
+  \param coarse The array on the coarse mesh. Must have the same entity type
+  and number of degrees of freedom as the fine array.
+*/
+template <class ExecutionSpace, class FineArray, class CoarseArray>
+void average( const ExecutionSpace& exec_space, const FineArray& fine,
+              CoarseArray& coarse )
+{
+    using entity_type = typename CoarseArray::entity_type;
+    static_assert(
+        std::is_same<entity_type, typename FineArray::entity_type>::value,
+        "Fine and coarse arrays must have the same entity type" );
+
+    // Get the coarsening factor.
+    auto fine_grid = fine.layout()->localGrid();
+    auto coarse_grid = coarse.layout()->localGrid();
+    double fine_dx = fine_grid->globalGrid().globalMesh().cellSize( 0 );
+    double coarse_dx = coarse_grid->globalGrid().globalMesh().cellSize( 0 );
+    int factor = std::rint( coarse_dx / fine_dx );
+    if ( factor < 1 )
+        throw std::logic_error( "Fine array mesh is coarser than coarse mesh" );
+    if ( fine_grid->haloCellWidth() < factor - 1 )
+        throw std::logic_error( "Fine array halo too narrow to average" );
+
+    // Get the local index offset between the meshes. The first local entity
+    // of each mesh is at the low corner of its ghosted domain.
+    auto fine_mesh = Cajita::createLocalMesh<Kokkos::HostSpace>( *fine_grid );
+    auto coarse_mesh =
+        Cajita::createLocalMesh<Kokkos::HostSpace>( *coarse_grid );
+    Kokkos::Array<int, 3> origin;
+    for ( int d = 0; d < 3; ++d )
+        origin[d] = std::rint( ( coarse_mesh.lowCorner( Cajita::Ghost(), d ) -
+                                 fine_mesh.lowCorner( Cajita::Ghost(), d ) ) /
+                               fine_dx );
+
+    // Average the fine entities about each owned coarse entity.
+    auto fine_view = fine.view();
+    auto coarse_view = coarse.view();
+    int num_dof = coarse_view.extent( 3 );
+    int begin = averageBegin( entity_type(), factor );
+    int end = averageEnd( entity_type(), factor );
+    auto own_entities = coarse_grid->indexSpace( Cajita::Own(), entity_type(),
+                                                 Cajita::Local() );
+    Kokkos::parallel_for(
+        "grid_transfer_average",
+        Cajita::createExecutionPolicy( own_entities, exec_space ),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            // First fine entity of the coarse entity.
+            int fi = origin[Dim::I] + factor * i;
+            int fj = origin[Dim::J] + factor * j;
+            int fk = origin[Dim::K] + factor * k;
+
+            // Average each degree of freedom.
+            for ( int n = 0; n < num_dof; ++n )
+            {
+                double value = 0.0;
+                for ( int oi = begin; oi < end; ++oi )
+                    for ( int oj = begin; oj < end; ++oj )
+                        for ( int ok = begin; ok < end; ++ok )
+                            value +=
+                                averageWeight( entity_type(), oi, factor ) *
+                                averageWeight( entity_type(), oj, factor ) *
+                                averageWeight( entity_type(), ok, factor ) *
+                                fine_view( fi + oi, fj + oj, fk + ok, n );
+                coarse_view( i, j, k, n ) = value;
+            }
+        } );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace GridTransfer
+} // end namespace Picasso
+
+#endif // end PICASSO_GRIDTRANSFER_HPP
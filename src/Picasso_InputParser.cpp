@@ -9,16 +9,20 @@
  * SPDX-License-Identifier: BSD-3-Clause                                    *
  ****************************************************************************/
 
+#include <Picasso_BroadcastFile.hpp>
 #include <Picasso_InputParser.hpp>
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
+#include <istream>
+#include <vector>
+
 namespace Picasso
 {
 //---------------------------------------------------------------------------//
 //! Input argument constructor.
-InputParser::InputParser( int argc, char* argv[] )
+InputParser::InputParser( int argc, char* argv[], MPI_Comm comm )
 {
     // Get the filename from the input.
     bool found_arg = false;
@@ -29,14 +33,14 @@ InputParser::InputParser( int argc, char* argv[] )
         {
             filename = std::string( argv[n + 1] );
             found_arg = true;
-            parse( filename, "json" );
+            parse( filename, "json", comm );
             break;
         }
         else if ( 0 == std::strcmp( argv[n], "--picasso-input-xml" ) )
         {
             filename = std::string( argv[n + 1] );
             found_arg = true;
-            parse( filename, "xml" );
+            parse( filename, "xml", comm );
             break;
         }
     }
@@ -50,9 +54,10 @@ InputParser::InputParser( int argc, char* argv[] )
 
 //---------------------------------------------------------------------------//
 //! Filename constructor.
-InputParser::InputParser( const std::string& filename, const std::string& type )
+InputParser::InputParser( const std::string& filename, const std::string& type,
+                          MPI_Comm comm )
 {
-    parse( filename, type );
+    parse( filename, type, comm );
 }
 
 //---------------------------------------------------------------------------//
@@ -64,16 +69,24 @@ const boost::property_tree::ptree& InputParser::propertyTree() const
 
 //---------------------------------------------------------------------------//
 // Parse the field.
-void InputParser::parse( const std::string& filename, const std::string& type )
+void InputParser::parse( const std::string& filename, const std::string& type,
+                         MPI_Comm comm )
 {
+    // Read the file on the first rank and parse it from memory on all ranks.
+    std::vector<char> contents;
+    if ( !broadcastFile( filename, comm, contents ) )
+        throw std::runtime_error( "Unable to read input file " + filename );
+    ContentsStreamBuffer buffer( contents );
+    std::istream stream( &buffer );
+
     // Get the filename from the input.
     if ( 0 == type.compare( "json" ) )
     {
-        boost::property_tree::read_json( filename, _ptree );
+        boost::property_tree::read_json( stream, _ptree );
     }
     else if ( 0 == type.compare( "xml" ) )
     {
-        boost::property_tree::read_xml( filename, _ptree );
+        boost::property_tree::read_xml( stream, _ptree );
     }
     else
     // Check that we found the filename.
@@ -14,6 +14,8 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <mpi.h>
+
 #include <string>
 
 namespace Picasso
@@ -22,17 +24,21 @@ namespace Picasso
 class InputParser
 {
   public:
-    //! Input argument constructor.
-    InputParser( int argc, char* argv[] );
+    //! Input argument constructor. The file is read by the first rank of
+    //! the communicator and broadcast to the others.
+    InputParser( int argc, char* argv[], MPI_Comm comm = MPI_COMM_WORLD );
 
-    //! Filename constructor.
-    InputParser( const std::string& filename, const std::string& type );
+    //! Filename constructor. The file is read by the first rank of the
+    //! communicator and broadcast to the others.
+    InputParser( const std::string& filename, const std::string& type,
+                 MPI_Comm comm = MPI_COMM_WORLD );
 
     //! Get the ptree.
     const boost::property_tree::ptree& propertyTree() const;
 
   private:
-    void parse( const std::string& filename, const std::string& type );
+    void parse( const std::string& filename, const std::string& type,
+                MPI_Comm comm );
 
   private:
     boost::property_tree::ptree _ptree;
@@ -13,19 +13,38 @@
 #define PICASSO_LEVELSET_HPP
 
 #include <Picasso_FieldManager.hpp>
+#include <Picasso_GridTransfer.hpp>
+#include <Picasso_LevelSetNarrowBand.hpp>
 #include <Picasso_LevelSetRedistance.hpp>
 #include <Picasso_Types.hpp>
+#include <Picasso_UniformMesh.hpp>
 
 #include <Cajita.hpp>
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <mpi.h>
+
 #include <cfloat>
 #include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 //---------------------------------------------------------------------------//
 namespace Picasso
 {
+//---------------------------------------------------------------------------//
+// Redistancing methods.
+enum class RedistanceMethod
+{
+    // Hopf-Lax projection. Accurate but expensive.
+    HopfLax,
+
+    // Parallel fast sweeping. First-order accurate but inexpensive.
+    FastSweeping
+};
+
 //---------------------------------------------------------------------------//
 // Level set. Composes a signed distance function.
 template <class MeshType, class SignedDistanceLocation>
@@ -39,18 +58,30 @@ class LevelSet
     using array_type = Cajita::Array<double, entity_type,
                                      Cajita::UniformMesh<double>, memory_space>;
     using halo_type = Cajita::Halo<memory_space>;
+    using narrow_band_type = NarrowBand<memory_space>;
 
     /*!
       \brief Construct the level set over the given mesh.
       \param ptree Level set settings.
       \param mesh The mesh over which to build the signed distance function.
-      \param The particle color over which to build the level set. Use -1 if
-      the level set is to be built over all particles.
+      If a cell size ratio other than one is given in the settings the signed
+      distance function is instead built over a mesh derived from this mesh
+      with the cell size scaled by that ratio.
     */
     LevelSet( const boost::property_tree::ptree& ptree,
               const std::shared_ptr<MeshType>& mesh )
         : _mesh( mesh )
     {
+        // Extract parameters.
+        const auto& params = ptree.get_child( "level_set" );
+
+        // Create a mesh with the level set resolution if it differs from the
+        // input mesh. The derived mesh has the same halo cell width.
+        double cell_size_ratio = params.get<double>( "cell_size_ratio", 1.0 );
+        if ( cell_size_ratio != 1.0 )
+            _mesh = createUniformMesh( *mesh, cell_size_ratio,
+                                       mesh->localGrid()->haloCellWidth() );
+
         // Create array data.
         _distance_estimate =
             createArray( *_mesh, location_type(), Field::DistanceEstimate() );
@@ -62,8 +93,15 @@ class LevelSet
         // Cell size.
         _dx = _mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
 
-        // Extract parameters.
-        const auto& params = ptree.get_child( "level_set" );
+        // Get the redistancing method.
+        auto method =
+            params.get<std::string>( "redistance_method", "hopf_lax" );
+        if ( method.compare( "hopf_lax" ) == 0 )
+            _redistance_method = RedistanceMethod::HopfLax;
+        else if ( method.compare( "fast_sweeping" ) == 0 )
+            _redistance_method = RedistanceMethod::FastSweeping;
+        else
+            throw std::runtime_error( "Unknown redistance method: " + method );
 
         // Get the Hopf-Lax redistancing parameters.
         _redistance_secant_tol =
@@ -76,6 +114,54 @@ class LevelSet
             params.get<double>( "redistance_projection_tol", 1.0e-4 );
         _redistance_max_projection_iter =
             params.get<int>( "redistance_max_projection_iter", 200 );
+
+        // Get the number of levels in the Hopf-Lax redistancing
+        // hierarchy. Interpolating from a level needs ghost entities up to
+        // one level stride away.
+        _redistance_num_level = params.get<int>( "redistance_num_level", 2 );
+        if ( _redistance_num_level < 1 ||
+             ( 1 << ( _redistance_num_level - 1 ) ) - 1 >
+                 _mesh->localGrid()->haloCellWidth() )
+            throw std::runtime_error(
+                "Redistance level count not supported by the halo width" );
+
+        // Optionally compute the coarse levels redundantly over the ghost
+        // entities so only the estimate is gathered. The outer ghost layers
+        // are only partially computed so this costs one coarsest level
+        // stride of the resolvable narrow band width.
+        _redistance_redundant_ghosts =
+            params.get<bool>( "redistance_redundant_ghosts", false );
+        if ( resolvedCellWidth() < 1 )
+            throw std::runtime_error(
+                "Halo too narrow for redundant ghost redistancing" );
+
+        // Optionally store the closest point of each entity to warm start
+        // the next Hopf-Lax redistance. Entities start without a closest
+        // point.
+        _redistance_warm_start =
+            params.get<bool>( "redistance_warm_start", false );
+        if ( _redistance_warm_start )
+        {
+            _closest_point =
+                createArray( *_mesh, location_type(), Field::ClosestPoint() );
+            Cajita::ArrayOp::assign( *_closest_point, DBL_MAX,
+                                     Cajita::Ghost() );
+        }
+
+        // Get the fast sweeping redistancing parameters.
+        _redistance_max_sweep_iter =
+            params.get<int>( "redistance_max_sweep_iter", 10 );
+        _redistance_sweep_tol =
+            params.get<double>( "redistance_sweep_tol", 1.0e-3 );
+
+        // Get the advection error monitor parameters. The maximum
+        // displacement is given in cells.
+        _advect_max_steps = params.get<int>( "advect_max_steps", 5 );
+        _advect_max_displacement =
+            _dx * params.get<double>( "advect_max_displacement", 1.0 );
+        _advect_max_gradient_error =
+            params.get<double>( "advect_max_gradient_error", 0.5 );
+        resetAdvectionMonitor();
     }
 
     /*!
@@ -86,178 +172,272 @@ class LevelSet
     */
     template <class ExecutionSpace>
     void redistance( const ExecutionSpace& exec_space )
+    {
+        // Gather to get updated ghost values.
+        _halo->gather( exec_space, *_distance_estimate );
+
+        // Build the narrow band from the estimate and assign the far field.
+        // Only the band entities are redistanced.
+        auto own_entities = _mesh->localGrid()->indexSpace(
+            Cajita::Own(), entity_type(), Cajita::Local() );
+        _band.build( exec_space, own_entities, _distance_estimate->view(),
+                     bandWidth(), _signed_distance->view() );
+
+        // When computing redundantly over the ghosts, also build a band over
+        // the ghost entities. Only those which have all of their level
+        // neighbors are redistanced.
+        if ( _redistance_redundant_ghosts &&
+             RedistanceMethod::HopfLax == _redistance_method )
+        {
+            auto ghost_entities = _mesh->localGrid()->indexSpace(
+                Cajita::Ghost(), entity_type(), Cajita::Local() );
+            _ghost_band.build( exec_space, ghost_entities,
+                               _distance_estimate->view(), bandWidth(),
+                               _signed_distance->view() );
+        }
+
+        // Redistance.
+        if ( RedistanceMethod::FastSweeping == _redistance_method )
+            redistanceFastSweeping( exec_space );
+        else
+            redistanceHopfLax( exec_space );
+
+        // The signed distance is now a distance function again.
+        resetAdvectionMonitor();
+    }
+
+    /*!
+      \brief Advect the signed distance function with a grid velocity using
+      a semi-Lagrangian step. The distance at each owned entity is
+      interpolated from the point reached by tracing the entity location back
+      along its velocity. The traced point must be within the halo of the
+      local domain so the displacement of any entity in a step may not exceed
+      the halo width.
+
+      Advection does not preserve the distance property of the function so
+      the level set should be rebuilt from the particles and redistanced when
+      needsRebuild() indicates the error monitor thresholds have been
+      exceeded. The narrow band is rebuilt from the advected distance so it
+      follows the interface until then.
+
+      \param exec_space The execution space to use for parallel kernels.
+      \param velocity A view of the grid velocity collocated with the signed
+      distance function. Only owned values are used.
+      \param dt The time step size.
+    */
+    template <class ExecutionSpace, class VelocityView>
+    void advect( const ExecutionSpace& exec_space, const VelocityView& velocity,
+                 const double dt )
     {
         // Local mesh.
         auto local_mesh =
             Cajita::createLocalMesh<memory_space>( *( _mesh->localGrid() ) );
+        auto own_entities = _mesh->localGrid()->indexSpace(
+            Cajita::Own(), entity_type(), Cajita::Local() );
+        MPI_Comm comm = _mesh->localGrid()->globalGrid().comm();
 
-        // Views.
-        auto estimate_view = _distance_estimate->view();
+        // Maximum displacement. The departure points must be in the halo.
+        double max_displacement = 0.0;
+        Kokkos::parallel_reduce(
+            "level_set_advect_displacement",
+            Cajita::createExecutionPolicy( own_entities, exec_space ),
+            KOKKOS_LAMBDA( const int i, const int j, const int k,
+                           double& displacement ) {
+                double u_sqr = 0.0;
+                for ( int d = 0; d < 3; ++d )
+                    u_sqr += velocity( i, j, k, d ) * velocity( i, j, k, d );
+                double dist = fabs( dt ) * sqrt( u_sqr );
+                displacement = ( dist > displacement ) ? dist : displacement;
+            },
+            Kokkos::Max<double>( max_displacement ) );
+        MPI_Allreduce( MPI_IN_PLACE, &max_displacement, 1, MPI_DOUBLE, MPI_MAX,
+                       comm );
+        if ( max_displacement > _dx * _mesh->localGrid()->haloCellWidth() )
+            throw std::runtime_error(
+                "Level set advection displacement exceeds the halo width" );
+
+        // Gather to get updated ghost values and copy the current distance
+        // to interpolate from.
+        _halo->gather( exec_space, *_signed_distance );
+        auto phi_old =
+            Cajita::ArrayOp::cloneCopy( *_signed_distance, Cajita::Ghost() );
+        auto phi_old_view = phi_old->view();
         auto distance_view = _signed_distance->view();
 
-        // Local-to-global indexer.
-        auto l2g = Cajita::IndexConversion::createL2G( *( _mesh->localGrid() ),
-                                                       entity_type() );
-
-        // Gather to get updated ghost values.
-        _halo->gather( exec_space, *_distance_estimate );
-
-        // Redistance on the coarse grid.
-        auto own_entities = _mesh->localGrid()->indexSpace(
-            Cajita::Own(), entity_type(), Cajita::Local() );
+        // Trace back each entity and interpolate. The clamp only guards
+        // against roundoff at the halo boundary.
         Kokkos::parallel_for(
-            "redistance_coarse",
+            "level_set_advect",
             Cajita::createExecutionPolicy( own_entities, exec_space ),
             KOKKOS_LAMBDA( const int i, const int j, const int k ) {
-                // Get the global id of the entity.
-                int gi, gj, gk;
-                l2g( i, j, k, gi, gj, gk );
-
-                // Only redistance on even-numbered entities. This effectively
-                // generates a coarse grid where 2x2x2 blocks of cells on the
-                // fine grid are combined.
-                if ( !( gi % 2 ) && !( gj % 2 ) && !( gk % 2 ) )
-                {
-                    int entity_index[3] = { i, j, k };
-                    distance_view( i, j, k, 0 ) =
-                        LevelSetRedistance::redistanceEntity(
-                            entity_type(), estimate_view, local_mesh,
-                            entity_index, _redistance_secant_tol,
-                            _redistance_max_secant_iter,
-                            _redistance_num_random_guess,
-                            _redistance_projection_tol,
-                            _redistance_max_projection_iter );
-                }
+                // Departure point.
+                int entity_index[3] = { i, j, k };
+                double x[3];
+                local_mesh.coordinates( entity_type(), entity_index, x );
+                for ( int d = 0; d < 3; ++d )
+                    x[d] -= dt * velocity( i, j, k, d );
+                LevelSetRedistance::clampPointToLocalDomain( local_mesh, x );
+
+                // Interpolate.
+                using SplineTags =
+                    Cajita::SplineDataMemberTypes<Cajita::SplineWeightValues>;
+                Cajita::SplineData<double, 1, entity_type, SplineTags> sd;
+                Cajita::evaluateSpline( local_mesh, x, sd );
+                double phi;
+                Cajita::G2P::value( phi_old_view, sd, phi );
+                distance_view( i, j, k, 0 ) = phi;
             } );
 
-        // Gather the coarse grid estimate to get updated ghost values.
+        // Gather the advected distance and monitor its gradient magnitude
+        // error within the resolved narrow band with central differences.
         _halo->gather( exec_space, *_signed_distance );
-
-        // Interpolate from coarse grid to fine grid.
-        Kokkos::parallel_for(
-            "redistance_interpolate",
+        double threshold = _dx * resolvedCellWidth();
+        double inv_2dx = 0.5 / _dx;
+        double max_gradient_error = 0.0;
+        Kokkos::parallel_reduce(
+            "level_set_advect_gradient_error",
             Cajita::createExecutionPolicy( own_entities, exec_space ),
-            KOKKOS_LAMBDA( const int i, const int j, const int k ) {
-                // Get the global id of the entity.
-                int gi, gj, gk;
-                l2g( i, j, k, gi, gj, gk );
-
-                // Interpolate even-numbered entities to the other entities.
-                // All odd case
-                if ( ( gi % 2 ) && ( gj % 2 ) && ( gk % 2 ) )
+            KOKKOS_LAMBDA( const int i, const int j, const int k,
+                           double& gradient_error ) {
+                if ( fabs( distance_view( i, j, k, 0 ) ) < threshold )
                 {
-                    estimate_view( i, j, k, 0 ) =
-                        0.125 * ( distance_view( i - 1, j - 1, k - 1, 0 ) +
-                                  distance_view( i - 1, j - 1, k + 1, 0 ) +
-                                  distance_view( i - 1, j + 1, k - 1, 0 ) +
-                                  distance_view( i - 1, j + 1, k + 1, 0 ) +
-                                  distance_view( i + 1, j - 1, k - 1, 0 ) +
-                                  distance_view( i + 1, j - 1, k + 1, 0 ) +
-                                  distance_view( i + 1, j + 1, k - 1, 0 ) +
-                                  distance_view( i + 1, j + 1, k + 1, 0 ) );
+                    double grad[3] = {
+                        inv_2dx * ( distance_view( i + 1, j, k, 0 ) -
+                                    distance_view( i - 1, j, k, 0 ) ),
+                        inv_2dx * ( distance_view( i, j + 1, k, 0 ) -
+                                    distance_view( i, j - 1, k, 0 ) ),
+                        inv_2dx * ( distance_view( i, j, k + 1, 0 ) -
+                                    distance_view( i, j, k - 1, 0 ) ) };
+                    double error = fabs(
+                        sqrt( grad[0] * grad[0] + grad[1] * grad[1] +
+                              grad[2] * grad[2] ) -
+                        1.0 );
+                    gradient_error =
+                        ( error > gradient_error ) ? error : gradient_error;
                 }
+            },
+            Kokkos::Max<double>( max_gradient_error ) );
+        MPI_Allreduce( MPI_IN_PLACE, &max_gradient_error, 1, MPI_DOUBLE,
+                       MPI_MAX, comm );
+
+        // Update the monitor.
+        ++_advect_steps;
+        _advect_gradient_error = max_gradient_error;
+        _advect_displacement += max_displacement;
+
+        // Rebuild the band around the advected interface. The advected far
+        // field is reset to the signed band width.
+        _band.build( exec_space, own_entities, distance_view, bandWidth(),
+                     distance_view );
+    }
 
-                // Even i case
-                else if ( !( gi % 2 ) && ( gj % 2 ) && ( gk % 2 ) )
-                {
-                    estimate_view( i, j, k, 0 ) =
-                        0.25 * ( distance_view( i, j - 1, k - 1, 0 ) +
-                                 distance_view( i, j - 1, k + 1, 0 ) +
-                                 distance_view( i, j + 1, k - 1, 0 ) +
-                                 distance_view( i, j + 1, k + 1, 0 ) );
-                }
+    /*!
+      \brief Transfer the signed distance to an array on another mesh over
+      the same domain and decomposition whose cell size differs from that of
+      the level set mesh by an integer factor (e.g. the simulation mesh when
+      the level set has a different resolution). The distance is linearly
+      interpolated to a mesh at least as fine as the level set mesh and
+      averaged to a coarser mesh.
+      \param exec_space The execution space to use for parallel kernels.
+      \param target The array to transfer to. Must be collocated with the
+      signed distance with a single degree of freedom. Only the owned values
+      are assigned.
+    */
+    template <class ExecutionSpace, class TargetArray>
+    void transferSignedDistance( const ExecutionSpace& exec_space,
+                                 TargetArray& target )
+    {
+        // Gather to get updated ghost values.
+        _halo->gather( exec_space, *_signed_distance );
 
-                // Even j case
-                else if ( ( gi % 2 ) && !( gj % 2 ) && ( gk % 2 ) )
-                {
-                    estimate_view( i, j, k, 0 ) =
-                        0.25 * ( distance_view( i - 1, j, k - 1, 0 ) +
-                                 distance_view( i - 1, j, k + 1, 0 ) +
-                                 distance_view( i + 1, j, k - 1, 0 ) +
-                                 distance_view( i + 1, j, k + 1, 0 ) );
-                }
+        // Transfer.
+        double target_dx = target.layout()
+                               ->localGrid()
+                               ->globalGrid()
+                               .globalMesh()
+                               .cellSize( 0 );
+        if ( target_dx < 1.5 * _dx )
+            GridTransfer::interpolate( exec_space, *_signed_distance, target );
+        else
+            GridTransfer::average( exec_space, *_signed_distance, target );
+    }
 
-                // Even k case.
-                else if ( ( gi % 2 ) && ( gj % 2 ) && !( gk % 2 ) )
-                {
-                    estimate_view( i, j, k, 0 ) =
-                        0.25 * ( distance_view( i - 1, j - 1, k, 0 ) +
-                                 distance_view( i - 1, j + 1, k, 0 ) +
-                                 distance_view( i + 1, j - 1, k, 0 ) +
-                                 distance_view( i + 1, j + 1, k, 0 ) );
-                }
+    // Get the number of advection steps since the last redistance.
+    int advectSteps() const { return _advect_steps; }
 
-                // Even ij
-                else if ( !( gi % 2 ) && !( gj % 2 ) && ( gk % 2 ) )
-                {
-                    estimate_view( i, j, k, 0 ) =
-                        0.5 * ( distance_view( i, j, k - 1, 0 ) +
-                                distance_view( i, j, k + 1, 0 ) );
-                }
+    // Get the accumulated maximum displacement since the last redistance.
+    double advectDisplacement() const { return _advect_displacement; }
 
-                // Even ik
-                else if ( !( gi % 2 ) && ( gj % 2 ) && !( gk % 2 ) )
-                {
-                    estimate_view( i, j, k, 0 ) =
-                        0.5 * ( distance_view( i, j - 1, k, 0 ) +
-                                distance_view( i, j + 1, k, 0 ) );
-                }
+    // Get the maximum gradient magnitude error in the narrow band at the
+    // last advection step.
+    double advectGradientError() const { return _advect_gradient_error; }
 
-                // Even jk
-                else if ( ( gi % 2 ) && !( gj % 2 ) && !( gk % 2 ) )
-                {
-                    estimate_view( i, j, k, 0 ) =
-                        0.5 * ( distance_view( i - 1, j, k, 0 ) +
-                                distance_view( i + 1, j, k, 0 ) );
-                }
+    // Determine if the advected level set should be rebuilt from the
+    // particles and redistanced.
+    bool needsRebuild() const
+    {
+        return ( _advect_steps >= _advect_max_steps ||
+                 _advect_displacement > _advect_max_displacement ||
+                 _advect_gradient_error > _advect_max_gradient_error );
+    }
 
-                // Even-numbered entities don't change.
-                else
-                {
-                    estimate_view( i, j, k, 0 ) = distance_view( i, j, k, 0 );
-                }
-            } );
+    // Reset the advection error monitor. This is done with each redistance.
+    void resetAdvectionMonitor()
+    {
+        _advect_steps = 0;
+        _advect_displacement = 0.0;
+        _advect_gradient_error = 0.0;
+    }
 
-        // Gather to get updated ghost values.
-        _halo->gather( exec_space, *_distance_estimate );
+    // Get the narrow band width. The band extends one coarsest level stride
+    // past the threshold distance we can resolve so the coarse entities
+    // needed to interpolate to the fine entities within the threshold are
+    // active.
+    double bandWidth() const
+    {
+        return _dx *
+               ( resolvedCellWidth() + ( 1 << ( _redistance_num_level - 1 ) ) );
+    }
 
-        // Narrow-band redistance on the fine grid. Only redistance within the
-        // threshold tolerance. We can't resolve the level set any further
-        // than the width of the halo.
-        auto threshold = _dx * _mesh->localGrid()->haloCellWidth();
-        Kokkos::parallel_for(
-            "redistance_fine",
-            Cajita::createExecutionPolicy( own_entities, exec_space ),
-            KOKKOS_LAMBDA( const int i, const int j, const int k ) {
-                // Only redistance on the fine grid if the estimate is less
-                // than the threshold distance.
-                if ( fabs( estimate_view( i, j, k, 0 ) ) < threshold )
-                {
-                    int entity_index[3] = { i, j, k };
-                    distance_view( i, j, k, 0 ) =
-                        LevelSetRedistance::redistanceEntity(
-                            entity_type(), estimate_view, local_mesh,
-                            entity_index, _redistance_secant_tol,
-                            _redistance_max_secant_iter,
-                            _redistance_num_random_guess,
-                            _redistance_projection_tol,
-                            _redistance_max_projection_iter );
-                }
+    // Get the number of cells from an owned entity within which the
+    // Hopf-Lax redistance resolves the level set. This is the halo width
+    // less the ghost layers which are only partially computed when computing
+    // redundantly over the ghosts.
+    int resolvedCellWidth() const
+    {
+        return _mesh->localGrid()->haloCellWidth() - redundantGhostWidth();
+    }
 
-                // Otherwise just assign the distance to be our estimate.
-                else
-                {
-                    distance_view( i, j, k, 0 ) = estimate_view( i, j, k, 0 );
-                }
-            } );
+    // Get the number of outer ghost layers which are not computed when
+    // computing redundantly over the ghosts. Interpolating from the coarsest
+    // level needs entities up to one stride away.
+    int redundantGhostWidth() const
+    {
+        return _redistance_redundant_ghosts
+                   ? ( 1 << ( _redistance_num_level - 1 ) )
+                   : 0;
     }
 
+    // Get the narrow band of the signed distance function. The band is
+    // rebuilt with each redistance and advection step.
+    const narrow_band_type& narrowBand() const { return _band; }
+
+    // Get the redistancing method.
+    RedistanceMethod redistanceMethod() const { return _redistance_method; }
+
+    // Get the Hopf-Lax secant tolerance in cells. Points within this
+    // distance of the zero isocontour are accepted as on the interface.
+    double redistanceSecantTol() const { return _redistance_secant_tol; }
+
     // Get the signed distance estimate.
     std::shared_ptr<array_type> getDistanceEstimate() const
     {
         return _distance_estimate;
     }
 
+    // Get the mesh over which the signed distance function is defined.
+    std::shared_ptr<MeshType> mesh() const { return _mesh; }
+
     // Get the redistanced signed distance function.
     std::shared_ptr<array_type> getSignedDistance() const
     {
@@ -267,17 +447,393 @@ class LevelSet
     // Get the halo for the signed distance arrays.
     std::shared_ptr<halo_type> getHalo() const { return _halo; }
 
+    // Get the closest points found by the last Hopf-Lax redistance. Only
+    // allocated when warm starting is enabled. Entities which were not
+    // redistanced have DBL_MAX in their first component.
+    std::shared_ptr<array_type> getClosestPoint() const
+    {
+        return _closest_point;
+    }
+
+    // Redistance with the Hopf-Lax formulation over a hierarchy of
+    // levels. Level l consists of the entities whose global ids are all
+    // multiples of 2^l. The coarsest level is redistanced over the whole
+    // narrow band and each level is interpolated to the finer entities to
+    // improve their estimate before the next level is redistanced within a
+    // threshold of the interface that halves with each level down to the
+    // halo width on the finest level. Only the narrow band entities are
+    // computed and all others have the far-field value assigned when the
+    // band was built.
+    //
+    // Each level is gathered before it is interpolated and again after
+    // interpolation. If computing redundantly over the ghosts the coarse
+    // levels and interpolation are instead also computed on the ghost
+    // entities with the ghost band and no gathers are needed beyond the
+    // initial estimate gather.
+    template <class ExecutionSpace>
+    void redistanceHopfLax( const ExecutionSpace& exec_space )
+    {
+        // Local mesh.
+        auto local_mesh =
+            Cajita::createLocalMesh<memory_space>( *( _mesh->localGrid() ) );
+
+        // Views.
+        auto estimate_view = _distance_estimate->view();
+        auto distance_view = _signed_distance->view();
+
+        // Local-to-global indexer.
+        auto l2g = Cajita::IndexConversion::createL2G( *( _mesh->localGrid() ),
+                                                       entity_type() );
+
+        // Narrow band. The finest level only needs the owned entities. When
+        // computing redundantly over the ghosts only the ghost entities which
+        // have all of their level neighbors are computed and the outer ghost
+        // layers keep the estimate.
+        bool redundant = _redistance_redundant_ghosts;
+        auto band = redundant ? _ghost_band : _band;
+        auto own_entities = _mesh->localGrid()->indexSpace(
+            Cajita::Own(), entity_type(), Cajita::Local() );
+        Kokkos::Array<int, 3> own_min = { own_entities.min( Dim::I ),
+                                          own_entities.min( Dim::J ),
+                                          own_entities.min( Dim::K ) };
+        Kokkos::Array<int, 3> own_max = { own_entities.max( Dim::I ),
+                                          own_entities.max( Dim::J ),
+                                          own_entities.max( Dim::K ) };
+        auto ghost_entities = _mesh->localGrid()->indexSpace(
+            Cajita::Ghost(), entity_type(), Cajita::Local() );
+        int outer_width = redundantGhostWidth();
+        Kokkos::Array<int, 3> inner_min;
+        Kokkos::Array<int, 3> inner_max;
+        for ( int d = 0; d < 3; ++d )
+        {
+            inner_min[d] = ghost_entities.min( d ) + outer_width;
+            inner_max[d] = ghost_entities.max( d ) - outer_width;
+        }
+
+        // Closest points for warm starting. Entities are warm started when
+        // closest points are stored and the entity was redistanced by the
+        // previous redistance or by a coarser level. Entities which have left
+        // the band since then no longer have a closest point so they take the
+        // cold path if they return to it.
+        bool store_closest_point = _redistance_warm_start;
+        Kokkos::View<double****, memory_space> closest_point_view;
+        if ( store_closest_point )
+        {
+            closest_point_view = _closest_point->view();
+            auto last_band = _closest_point_band;
+            double width = bandWidth();
+            Kokkos::parallel_for(
+                "closest_point_invalidate",
+                Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                                     last_band.size() ),
+                KOKKOS_LAMBDA( const int n ) {
+                    int i, j, k;
+                    last_band.entity( n, i, j, k );
+                    if ( fabs( estimate_view( i, j, k, 0 ) ) >= width )
+                        closest_point_view( i, j, k, 0 ) = DBL_MAX;
+                } );
+            _closest_point_band = band;
+        }
+
+        // Redistance each level from coarsest to finest.
+        int num_level = _redistance_num_level;
+        for ( int level = num_level - 1; level >= 0; --level )
+        {
+            // Level entity stride.
+            int stride = 1 << level;
+
+            // Level threshold. We can't resolve the level set any further
+            // than the width of the halo on the finest level.
+            bool coarsest = ( num_level > 1 && level == num_level - 1 );
+            double threshold = _dx * resolvedCellWidth() * stride;
+            bool own_only = redundant && ( 0 == level );
+
+            // Redistance the level entities. The coarsest level redistances
+            // all of its entities and the finer levels only redistance within
+            // the threshold.
+            Kokkos::parallel_for(
+                "redistance_level",
+                Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                                     band.size() ),
+                KOKKOS_LAMBDA( const int n ) {
+                    // Get the band entity.
+                    int i, j, k;
+                    band.entity( n, i, j, k );
+
+                    // The outer ghost layers keep the estimate.
+                    if ( i < inner_min[Dim::I] || i >= inner_max[Dim::I] ||
+                         j < inner_min[Dim::J] || j >= inner_max[Dim::J] ||
+                         k < inner_min[Dim::K] || k >= inner_max[Dim::K] )
+                    {
+                        distance_view( i, j, k, 0 ) =
+                            estimate_view( i, j, k, 0 );
+                        return;
+                    }
+
+                    // Get the global id of the entity.
+                    int gi, gj, gk;
+                    l2g( i, j, k, gi, gj, gk );
+
+                    // Only redistance entities on this level.
+                    if ( ( gi % stride ) || ( gj % stride ) ||
+                         ( gk % stride ) )
+                        return;
+
+                    // Only redistance owned entities on the finest level.
+                    if ( own_only &&
+                         ( i < own_min[Dim::I] || i >= own_max[Dim::I] ||
+                           j < own_min[Dim::J] || j >= own_max[Dim::J] ||
+                           k < own_min[Dim::K] || k >= own_max[Dim::K] ) )
+                        return;
+
+                    // Only redistance if the estimate is less than the
+                    // threshold distance.
+                    if ( coarsest ||
+                         fabs( estimate_view( i, j, k, 0 ) ) < threshold )
+                    {
+                        int entity_index[3] = { i, j, k };
+                        double y[3];
+                        bool warm_start =
+                            store_closest_point &&
+                            closest_point_view( i, j, k, 0 ) != DBL_MAX;
+                        if ( warm_start )
+                            for ( int d = 0; d < 3; ++d )
+                                y[d] = closest_point_view( i, j, k, d );
+                        distance_view( i, j, k, 0 ) =
+                            LevelSetRedistance::redistanceEntity(
+                                entity_type(), estimate_view, local_mesh,
+                                entity_index, _redistance_secant_tol,
+                                _redistance_max_secant_iter,
+                                _redistance_num_random_guess,
+                                _redistance_projection_tol,
+                                _redistance_max_projection_iter, warm_start,
+                                y );
+                        if ( store_closest_point )
+                            for ( int d = 0; d < 3; ++d )
+                                closest_point_view( i, j, k, d ) = y[d];
+                    }
+
+                    // Otherwise just assign the distance to be our estimate.
+                    // The entity has no closest point.
+                    else
+                    {
+                        distance_view( i, j, k, 0 ) =
+                            estimate_view( i, j, k, 0 );
+                        if ( store_closest_point )
+                            closest_point_view( i, j, k, 0 ) = DBL_MAX;
+                    }
+                } );
+
+            // The finest level is complete.
+            if ( 0 == level )
+                break;
+
+            // Gather the level distance to get updated ghost values.
+            if ( !redundant )
+                _halo->gather( exec_space, *_signed_distance );
+
+            // Interpolate from the level entities to all entities.
+            Kokkos::parallel_for(
+                "redistance_interpolate",
+                Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                                     band.size() ),
+                KOKKOS_LAMBDA( const int n ) {
+                    // Get the band entity. The outer ghost layers do not have
+                    // all of their level neighbors.
+                    int i, j, k;
+                    band.entity( n, i, j, k );
+                    if ( i < inner_min[Dim::I] || i >= inner_max[Dim::I] ||
+                         j < inner_min[Dim::J] || j >= inner_max[Dim::J] ||
+                         k < inner_min[Dim::K] || k >= inner_max[Dim::K] )
+                        return;
+
+                    // Get the global id of the entity.
+                    int gi, gj, gk;
+                    l2g( i, j, k, gi, gj, gk );
+
+                    // Interpolate. Ghost global ids may be negative on
+                    // periodic boundaries.
+                    int offset[3] = { ( gi % stride + stride ) % stride,
+                                      ( gj % stride + stride ) % stride,
+                                      ( gk % stride + stride ) % stride };
+                    estimate_view( i, j, k, 0 ) =
+                        LevelSetRedistance::interpolateFromLevel(
+                            distance_view, i, j, k, offset, stride );
+                } );
+
+            // Gather to get updated ghost values.
+            if ( !redundant )
+                _halo->gather( exec_space, *_distance_estimate );
+        }
+    }
+
+    // Redistance with parallel fast sweeping. Entities adjacent to the zero
+    // isocontour are fixed by their distance to the interpolated isocontour
+    // and the eikonal equation is solved outward from them with Gauss-Seidel
+    // sweeps in each of the 8 diagonal orderings. Within a sweep the entities
+    // on each diagonal plane i+j+k have no mutual dependencies and are
+    // updated in parallel. Sweeps are repeated with a halo gather between
+    // them to propagate across ranks until the update converges. Only the
+    // narrow band entities are visited: they are sorted by plane once for
+    // each pair of opposite orderings and each plane update only launches
+    // over the band entities on that plane. The far field has the value
+    // assigned when the band was built.
+    template <class ExecutionSpace>
+    void redistanceFastSweeping( const ExecutionSpace& exec_space )
+    {
+        // Views.
+        auto estimate_view = _distance_estimate->view();
+        auto distance_view = _signed_distance->view();
+
+        // Only the narrow band is resolved so the distance is bounded by the
+        // threshold. This also bounds the number of sweeps needed.
+        auto threshold = _dx * _mesh->localGrid()->haloCellWidth();
+        auto dx = _dx;
+        auto band = _band;
+
+        // Initialize. Interface entities get their distance to the
+        // isocontour and all other band entities start at the threshold.
+        Kokkos::parallel_for(
+            "redistance_sweep_init",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, band.size() ),
+            KOKKOS_LAMBDA( const int n ) {
+                int i, j, k;
+                band.entity( n, i, j, k );
+                if ( LevelSetRedistance::isInterfaceEntity( estimate_view, i,
+                                                            j, k ) )
+                    distance_view( i, j, k, 0 ) =
+                        LevelSetRedistance::interfaceDistance(
+                            estimate_view, i, j, k, dx );
+                else
+                    distance_view( i, j, k, 0 ) =
+                        copysign( threshold, estimate_view( i, j, k, 0 ) );
+            } );
+
+        // Sort the band by plane for the first 4 orderings. The other 4
+        // orderings are their reverses.
+        Kokkos::View<int*, memory_space> order[4];
+        std::vector<int> plane_offsets[4];
+        for ( int s = 0; s < 4; ++s )
+        {
+            Kokkos::Array<int, 3> dir = { ( s & 1 ) ? -1 : 1,
+                                          ( s & 2 ) ? -1 : 1, 1 };
+            band.sweepOrder( exec_space, dir, order[s], plane_offsets[s] );
+        }
+
+        // Previous iterate for the convergence check.
+        Kokkos::View<double*, memory_space> distance_old(
+            Kokkos::ViewAllocateWithoutInitializing( "distance_old" ),
+            band.size() );
+
+        // Sweep.
+        int num_plane = band.numSweepPlane();
+        MPI_Comm comm = _mesh->localGrid()->globalGrid().comm();
+        for ( int iter = 0; iter < _redistance_max_sweep_iter; ++iter )
+        {
+            // Gather to get updated ghost values.
+            _halo->gather( exec_space, *_signed_distance );
+
+            // Store the current iterate.
+            Kokkos::parallel_for(
+                "redistance_sweep_copy",
+                Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                                     band.size() ),
+                KOKKOS_LAMBDA( const int n ) {
+                    int i, j, k;
+                    band.entity( n, i, j, k );
+                    distance_old( n ) = distance_view( i, j, k, 0 );
+                } );
+
+            // Sweep each diagonal ordering. Planes without band entities are
+            // skipped.
+            for ( int s = 0; s < 8; ++s )
+            {
+                int f = ( s < 4 ) ? s : 7 - s;
+                auto plane_order = order[f];
+                for ( int p = 0; p < num_plane; ++p )
+                {
+                    int plane = ( s < 4 ) ? p : num_plane - 1 - p;
+                    int begin = plane_offsets[f][plane];
+                    int end = plane_offsets[f][plane + 1];
+                    if ( begin == end )
+                        continue;
+                    Kokkos::parallel_for(
+                        "redistance_sweep",
+                        Kokkos::RangePolicy<ExecutionSpace>( exec_space, begin,
+                                                             end ),
+                        KOKKOS_LAMBDA( const int n ) {
+                            int i, j, k;
+                            band.entity( plane_order( n ), i, j, k );
+                            if ( !LevelSetRedistance::isInterfaceEntity(
+                                     estimate_view, i, j, k ) )
+                                distance_view( i, j, k, 0 ) =
+                                    LevelSetRedistance::sweepEntity(
+                                        distance_view, i, j, k, dx );
+                        } );
+                }
+            }
+
+            // Check for convergence.
+            double max_change = 0.0;
+            Kokkos::parallel_reduce(
+                "redistance_sweep_change",
+                Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                                     band.size() ),
+                KOKKOS_LAMBDA( const int n, double& result ) {
+                    int i, j, k;
+                    band.entity( n, i, j, k );
+                    double change =
+                        fabs( distance_view( i, j, k, 0 ) - distance_old( n ) );
+                    result = ( change > result ) ? change : result;
+                },
+                Kokkos::Max<double>( max_change ) );
+            MPI_Allreduce( MPI_IN_PLACE, &max_change, 1, MPI_DOUBLE, MPI_MAX,
+                           comm );
+            if ( max_change < _redistance_sweep_tol * dx )
+                break;
+        }
+
+        // Band entities beyond the threshold that the sweeps did not reach
+        // keep their estimate.
+        Kokkos::parallel_for(
+            "redistance_sweep_far",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, band.size() ),
+            KOKKOS_LAMBDA( const int n ) {
+                int i, j, k;
+                band.entity( n, i, j, k );
+                if ( fabs( estimate_view( i, j, k, 0 ) ) >= threshold &&
+                     fabs( distance_view( i, j, k, 0 ) ) >= threshold )
+                    distance_view( i, j, k, 0 ) = estimate_view( i, j, k, 0 );
+            } );
+    }
+
   private:
     std::shared_ptr<MeshType> _mesh;
     std::shared_ptr<array_type> _distance_estimate;
     std::shared_ptr<array_type> _signed_distance;
     std::shared_ptr<halo_type> _halo;
+    narrow_band_type _band;
+    narrow_band_type _ghost_band;
     double _dx;
+    RedistanceMethod _redistance_method;
     double _redistance_secant_tol;
     int _redistance_max_secant_iter;
     int _redistance_num_random_guess;
     double _redistance_projection_tol;
     int _redistance_max_projection_iter;
+    int _redistance_num_level;
+    bool _redistance_redundant_ghosts;
+    bool _redistance_warm_start;
+    narrow_band_type _closest_point_band;
+    std::shared_ptr<array_type> _closest_point;
+    int _redistance_max_sweep_iter;
+    double _redistance_sweep_tol;
+    int _advect_max_steps;
+    double _advect_max_displacement;
+    double _advect_max_gradient_error;
+    int _advect_steps;
+    double _advect_displacement;
+    double _advect_gradient_error;
 };
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,252 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef PICASSO_LEVELSETNARROWBAND_HPP
+#define PICASSO_LEVELSETNARROWBAND_HPP
+
+#include <Picasso_Types.hpp>
+
+#include <Cajita.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace Picasso
+{
+//---------------------------------------------------------------------------//
+/*!
+  \class NarrowBand
+  \brief Narrow-band index of a signed distance function.
+
+  Entities with an estimated signed distance magnitude less than the band
+  width are active and the local ijk index of each is stored in a list so
+  kernels over the band only visit the active entities. All other entities
+  are in the far field where the signed distance function only carries their
+  sign: their value is the band width with the sign of the estimate. The
+  values themselves live in the dense signed distance array, which the grid
+  operators and interpolation read directly, so the band adds only its index
+  to the level set storage. The band is device-accessible and may be captured
+  by value in parallel kernels.
+*/
+template <class MemorySpace>
+class NarrowBand
+{
+  public:
+    using memory_space = MemorySpace;
+
+    // Default constructor.
+    NarrowBand() = default;
+
+    /*!
+      \brief Build the band from a signed distance estimate and assign the
+      far-field values. This is the only pass over all of the entities.
+      \param exec_space The execution space to use for parallel kernels.
+      \param entities The local index space of the entities over which to
+      build the band.
+      \param estimate A view of the signed distance estimate.
+      \param width The band width.
+      \param phi A view of the signed distance function. Far-field entities
+      are assigned the band width with the sign of their estimate. Active
+      entities are not modified. May be the same view as the estimate.
+    */
+    template <class ExecutionSpace, class IndexSpaceType, class EstimateView,
+              class SignedDistanceView>
+    void build( const ExecutionSpace& exec_space,
+                const IndexSpaceType& entities, const EstimateView& estimate,
+                const double width, const SignedDistanceView& phi )
+    {
+        // Band geometry.
+        _width = width;
+        for ( int d = 0; d < 3; ++d )
+        {
+            _min[d] = entities.min( d );
+            _extent[d] = entities.extent( d );
+        }
+        int num_entity = entities.size();
+
+        // Count the active entities and assign the far field.
+        auto band = *this;
+        int num_active = 0;
+        Kokkos::parallel_reduce(
+            "narrow_band_count",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, num_entity ),
+            KOKKOS_LAMBDA( const int n, int& count ) {
+                int i, j, k;
+                band.entityFromOffset( n, i, j, k );
+                double p = estimate( i, j, k, 0 );
+                if ( fabs( p ) < width )
+                    ++count;
+                else
+                    phi( i, j, k, 0 ) = copysign( width, p );
+            },
+            num_active );
+
+        // Compact the active entities. The scan preserves the entity order
+        // so the band is the same regardless of the number of threads.
+        _entities = Kokkos::View<int* [3], memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "band_entities" ),
+            num_active );
+        auto active = _entities;
+        Kokkos::parallel_scan(
+            "narrow_band_compact",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, num_entity ),
+            KOKKOS_LAMBDA( const int n, int& offset, const bool final_pass ) {
+                int i, j, k;
+                band.entityFromOffset( n, i, j, k );
+                if ( fabs( estimate( i, j, k, 0 ) ) < width )
+                {
+                    if ( final_pass )
+                    {
+                        active( offset, Dim::I ) = i;
+                        active( offset, Dim::J ) = j;
+                        active( offset, Dim::K ) = k;
+                    }
+                    ++offset;
+                }
+            } );
+    }
+
+    // Get the band width.
+    KOKKOS_INLINE_FUNCTION
+    double width() const { return _width; }
+
+    // Get the number of active entities.
+    KOKKOS_INLINE_FUNCTION
+    int size() const { return _entities.extent( 0 ); }
+
+    // Get the local ijk index of an active entity.
+    KOKKOS_INLINE_FUNCTION
+    void entity( const int n, int& i, int& j, int& k ) const
+    {
+        i = _entities( n, Dim::I );
+        j = _entities( n, Dim::J );
+        k = _entities( n, Dim::K );
+    }
+
+    // Get the far-field value of an entity with the given estimate.
+    KOKKOS_INLINE_FUNCTION
+    double farValue( const double estimate ) const
+    {
+        return copysign( _width, estimate );
+    }
+
+    // Given an offset into the band index space get the local ijk index of
+    // the entity.
+    KOKKOS_INLINE_FUNCTION
+    void entityFromOffset( const int n, int& i, int& j, int& k ) const
+    {
+        int ij_size = _extent[Dim::I] * _extent[Dim::J];
+        int kn = n / ij_size;
+        int jn = ( n - kn * ij_size ) / _extent[Dim::I];
+        i = _min[Dim::I] + n - kn * ij_size - jn * _extent[Dim::I];
+        j = _min[Dim::J] + jn;
+        k = _min[Dim::K] + kn;
+    }
+
+    // Given a diagonal sweep ordering with the given direction in each
+    // dimension get the diagonal plane of an entity in the band index
+    // space. Entities on the same plane have no mutual dependencies in a
+    // sweep.
+    KOKKOS_INLINE_FUNCTION
+    int sweepPlane( const int i, const int j, const int k,
+                    const Kokkos::Array<int, 3>& dir ) const
+    {
+        int ijk[3] = { i - _min[Dim::I], j - _min[Dim::J], k - _min[Dim::K] };
+        int plane = 0;
+        for ( int d = 0; d < 3; ++d )
+            plane += ( dir[d] > 0 ) ? ijk[d] : _extent[d] - 1 - ijk[d];
+        return plane;
+    }
+
+    // Get the number of diagonal planes in the band index space.
+    KOKKOS_INLINE_FUNCTION
+    int numSweepPlane() const
+    {
+        return _extent[Dim::I] + _extent[Dim::J] + _extent[Dim::K] - 2;
+    }
+
+    /*!
+      \brief Order the active entities by diagonal plane for a sweep
+      ordering. Only the active entities are visited.
+      \param exec_space The execution space to use for parallel kernels.
+      \param dir The sweep direction in each dimension.
+      \param order The band offsets of the active entities sorted by plane.
+      \param plane_offsets The offset into the order of the first entity of
+      each plane on the host. Has one more entry than the number of planes.
+    */
+    template <class ExecutionSpace>
+    void sweepOrder( const ExecutionSpace& exec_space,
+                     const Kokkos::Array<int, 3>& dir,
+                     Kokkos::View<int*, memory_space>& order,
+                     std::vector<int>& plane_offsets ) const
+    {
+        // Count the entities on each plane.
+        auto band = *this;
+        int num_plane = numSweepPlane();
+        Kokkos::View<int*, memory_space> plane_count( "plane_count",
+                                                      num_plane + 1 );
+        Kokkos::parallel_for(
+            "narrow_band_plane_count",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, size() ),
+            KOKKOS_LAMBDA( const int n ) {
+                int i, j, k;
+                band.entity( n, i, j, k );
+                Kokkos::atomic_increment(
+                    &plane_count( band.sweepPlane( i, j, k, dir ) + 1 ) );
+            } );
+
+        // Plane offsets.
+        auto host_count = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(), plane_count );
+        plane_offsets.resize( num_plane + 1 );
+        plane_offsets[0] = 0;
+        for ( int p = 0; p < num_plane; ++p )
+            plane_offsets[p + 1] = plane_offsets[p] + host_count( p + 1 );
+        Kokkos::View<int*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>
+            host_offsets( plane_offsets.data(), plane_offsets.size() );
+        auto offsets =
+            Kokkos::create_mirror_view_and_copy( memory_space(), host_offsets );
+
+        // Sort. The order within a plane does not matter.
+        order = Kokkos::View<int*, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "sweep_order" ),
+            size() );
+        Kokkos::deep_copy( plane_count, 0 );
+        Kokkos::parallel_for(
+            "narrow_band_plane_sort",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, size() ),
+            KOKKOS_LAMBDA( const int n ) {
+                int i, j, k;
+                band.entity( n, i, j, k );
+                int plane = band.sweepPlane( i, j, k, dir );
+                order( offsets( plane ) +
+                       Kokkos::atomic_fetch_add( &plane_count( plane ), 1 ) ) =
+                    n;
+            } );
+    }
+
+    // Get the active entity list.
+    Kokkos::View<int* [3], memory_space> entities() const { return _entities; }
+
+  private:
+    Kokkos::Array<int, 3> _min;
+    Kokkos::Array<int, 3> _extent;
+    double _width;
+    Kokkos::View<int* [3], memory_space> _entities;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
+
+#endif // end PICASSO_LEVELSETNARROWBAND_HPP
@@ -197,13 +197,22 @@ globalMin( const SignedDistanceView& phi_0, const double sign,
 //
 // NOTE - If needed, this function could also be easily modified to return the
 // normal field per section 2.4 in the reference.
+//
+// If warm_start is true the search is seeded with the closest point given in
+// y, typically the closest point found the last time the entity was
+// redistanced. The first secant iterate is then taken at the distance to that
+// point and if the projection from it alone already converges, and a
+// projection from the entity location does not find the interface closer, the
+// entity is done without evaluating any random points. If warm_start is false
+// y is ignored on input. On output y is the closest point found.
 template <class EntityType, class SignedDistanceView, class LocalMeshType>
 KOKKOS_INLINE_FUNCTION double
 redistanceEntity( EntityType, const SignedDistanceView& phi_0,
                   const LocalMeshType& local_mesh, const int entity_index[3],
                   const double secant_tol, const int max_secant_iter,
                   const int num_random, const double projection_tol,
-                  const int max_projection_iter )
+                  const int max_projection_iter, const bool warm_start,
+                  double y[3] )
 {
     // Grid interpolant.
     using SplineTags =
@@ -240,9 +249,53 @@ redistanceEntity( EntityType, const SignedDistanceView& phi_0,
     double t_new = secant_tol * dx;
     double phi_new;
 
-    // Initial argmin at the entity location. The ball radius starts at 0 so
-    // this is the only point that would be in the ball.
-    double y[3] = { x[0], x[1], x[2] };
+    // If warm starting, the first step is to the previous closest point. If
+    // that point is within the first step fall back to a cold start.
+    if ( warm_start )
+    {
+        double z[3];
+        double t_warm = distance( x, y, z );
+        if ( t_warm > t_new )
+        {
+            t_new = t_warm;
+
+            // Check if the projection from the previous closest point alone
+            // converges. The interface may have moved closer to the entity
+            // elsewhere so verify the result with a projection from the
+            // entity location as in a cold start. If that finds the interface
+            // inside of the ball fall back to a cold start.
+            phi_new = evaluate( phi_0, sign, local_mesh, x, t_new,
+                                projection_tol, max_projection_iter, sd, y );
+            if ( fabs( phi_new ) < dx * secant_tol )
+            {
+                double y_check[3] = { x[0], x[1], x[2] };
+                double phi_check =
+                    evaluate( phi_0, sign, local_mesh, x, t_new,
+                              projection_tol, max_projection_iter, sd,
+                              y_check );
+                if ( phi_check > -dx * secant_tol )
+                    return sign * t_new;
+
+                t_new = secant_tol * dx;
+                for ( int d = 0; d < 3; ++d )
+                    y[d] = x[d];
+            }
+        }
+        else
+        {
+            for ( int d = 0; d < 3; ++d )
+                y[d] = x[d];
+        }
+    }
+
+    // Otherwise the initial argmin is at the entity location. The ball
+    // radius starts at 0 so this is the only point that would be in the
+    // ball.
+    else
+    {
+        for ( int d = 0; d < 3; ++d )
+            y[d] = x[d];
+    }
 
     // Secant step.
     double delta_t;
@@ -292,6 +345,171 @@ redistanceEntity( EntityType, const SignedDistanceView& phi_0,
     return sign * t_new;
 }
 
+//---------------------------------------------------------------------------//
+// Redistance a signed distance function at a single entity with the Hopf-Lax
+// method starting the search from the entity location.
+template <class EntityType, class SignedDistanceView, class LocalMeshType>
+KOKKOS_INLINE_FUNCTION double
+redistanceEntity( EntityType, const SignedDistanceView& phi_0,
+                  const LocalMeshType& local_mesh, const int entity_index[3],
+                  const double secant_tol, const int max_secant_iter,
+                  const int num_random, const double projection_tol,
+                  const int max_projection_iter )
+{
+    double y[3];
+    return redistanceEntity( EntityType(), phi_0, local_mesh, entity_index,
+                             secant_tol, max_secant_iter, num_random,
+                             projection_tol, max_projection_iter, false, y );
+}
+
+//---------------------------------------------------------------------------//
+// Trilinearly interpolate a signed distance function to an entity from the
+// entities of a coarser level whose global ids are multiples of the given
+// stride. The offset of the entity from the level entity below it in each
+// dimension is given. Level entities interpolate to themselves.
+template <class SignedDistanceView>
+KOKKOS_INLINE_FUNCTION double
+interpolateFromLevel( const SignedDistanceView& phi, const int i, const int j,
+                      const int k, const int offset[3], const int stride )
+{
+    int low[3] = { i - offset[0], j - offset[1], k - offset[2] };
+    double f[3];
+    for ( int d = 0; d < 3; ++d )
+        f[d] = static_cast<double>( offset[d] ) / stride;
+
+    // Only read entities with a nonzero weight so level entities need no
+    // ghosts above them.
+    double result = 0.0;
+    for ( int a = 0; a < 2; ++a )
+        for ( int b = 0; b < 2; ++b )
+            for ( int c = 0; c < 2; ++c )
+            {
+                double w = ( a ? f[0] : 1.0 - f[0] ) *
+                           ( b ? f[1] : 1.0 - f[1] ) *
+                           ( c ? f[2] : 1.0 - f[2] );
+                if ( w > 0.0 )
+                    result += w * phi( low[0] + a * stride, low[1] + b * stride,
+                                       low[2] + c * stride, 0 );
+            }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+// Fast sweeping.
+//---------------------------------------------------------------------------//
+// Determine if an entity is adjacent to the zero isocontour of the signed
+// distance estimate. An entity is adjacent if the estimate changes sign
+// between it and any of its face neighbors.
+template <class SignedDistanceView>
+KOKKOS_INLINE_FUNCTION bool isInterfaceEntity( const SignedDistanceView& phi_0,
+                                               const int i, const int j,
+                                               const int k )
+{
+    double phi = phi_0( i, j, k, 0 );
+    return ( phi * phi_0( i - 1, j, k, 0 ) <= 0.0 ||
+             phi * phi_0( i + 1, j, k, 0 ) <= 0.0 ||
+             phi * phi_0( i, j - 1, k, 0 ) <= 0.0 ||
+             phi * phi_0( i, j + 1, k, 0 ) <= 0.0 ||
+             phi * phi_0( i, j, k - 1, 0 ) <= 0.0 ||
+             phi * phi_0( i, j, k + 1, 0 ) <= 0.0 );
+}
+
+//---------------------------------------------------------------------------//
+// Compute the signed distance from an entity adjacent to the zero isocontour
+// to the isocontour. The crossing of the isocontour along each dimension is
+// located by linear interpolation of the estimate and the distance is that
+// to the plane through the crossings. This is exact for planar isocontours.
+template <class SignedDistanceView>
+KOKKOS_INLINE_FUNCTION double
+interfaceDistance( const SignedDistanceView& phi_0, const int i, const int j,
+                   const int k, const double dx )
+{
+    double phi = phi_0( i, j, k, 0 );
+    if ( 0.0 == phi )
+        return 0.0;
+
+    // Neighbor estimates in each dimension.
+    double phi_n[3][2] = {
+        { phi_0( i - 1, j, k, 0 ), phi_0( i + 1, j, k, 0 ) },
+        { phi_0( i, j - 1, k, 0 ), phi_0( i, j + 1, k, 0 ) },
+        { phi_0( i, j, k - 1, 0 ), phi_0( i, j, k + 1, 0 ) } };
+
+    // Accumulate the inverse square distance to the crossing in each
+    // dimension.
+    double inv_dist_sqr = 0.0;
+    for ( int d = 0; d < 3; ++d )
+    {
+        double h = std::numeric_limits<double>::max();
+        for ( int n = 0; n < 2; ++n )
+        {
+            if ( phi * phi_n[d][n] <= 0.0 )
+                h = fmin( h, dx * phi / ( phi - phi_n[d][n] ) );
+        }
+        if ( h < std::numeric_limits<double>::max() )
+            inv_dist_sqr += 1.0 / fmax( h * h, 1.0e-12 * dx * dx );
+    }
+
+    return copysign( 1.0 / sqrt( inv_dist_sqr ), phi );
+}
+
+//---------------------------------------------------------------------------//
+// Godunov upwind update of the eikonal equation |grad(phi)| = 1 at an entity
+// from the current values of its face neighbors. The entity magnitude only
+// ever decreases and its sign is preserved.
+template <class SignedDistanceView>
+KOKKOS_INLINE_FUNCTION double sweepEntity( const SignedDistanceView& phi,
+                                           const int i, const int j,
+                                           const int k, const double dx )
+{
+    // Upwind neighbor magnitudes in each dimension.
+    double a[3] = { fmin( fabs( phi( i - 1, j, k, 0 ) ),
+                          fabs( phi( i + 1, j, k, 0 ) ) ),
+                    fmin( fabs( phi( i, j - 1, k, 0 ) ),
+                          fabs( phi( i, j + 1, k, 0 ) ) ),
+                    fmin( fabs( phi( i, j, k - 1, 0 ) ),
+                          fabs( phi( i, j, k + 1, 0 ) ) ) };
+
+    // Sort in ascending order.
+    double t;
+    if ( a[0] > a[1] )
+    {
+        t = a[0];
+        a[0] = a[1];
+        a[1] = t;
+    }
+    if ( a[1] > a[2] )
+    {
+        t = a[1];
+        a[1] = a[2];
+        a[2] = t;
+    }
+    if ( a[0] > a[1] )
+    {
+        t = a[0];
+        a[0] = a[1];
+        a[1] = t;
+    }
+
+    // Solve the quadratic using the smallest number of upwind dimensions
+    // consistent with the solution.
+    double u = a[0] + dx;
+    if ( u > a[1] )
+    {
+        u = 0.5 * ( a[0] + a[1] +
+                    sqrt( 2.0 * dx * dx - ( a[0] - a[1] ) * ( a[0] - a[1] ) ) );
+        if ( u > a[2] )
+        {
+            double s = a[0] + a[1] + a[2];
+            double s2 = a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+            u = ( s + sqrt( fmax( s * s - 3.0 * ( s2 - dx * dx ), 0.0 ) ) ) /
+                3.0;
+        }
+    }
+
+    double phi_old = phi( i, j, k, 0 );
+    return copysign( fmin( u, fabs( phi_old ) ), phi_old );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace LevelSetRedistance
@@ -0,0 +1,351 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef PICASSO_PARTICLEBINS_HPP
+#define PICASSO_PARTICLEBINS_HPP
+
+#include <Picasso_Types.hpp>
+
+#include <Cajita.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+
+namespace Picasso
+{
+//---------------------------------------------------------------------------//
+/*!
+  \class CellLocator
+  \brief Locates positions in the ghosted cells of a local grid.
+
+  Cell indices are local indices of the ghosted cell index space. Positions
+  outside of the ghosted domain are clamped to the boundary cells. The
+  locator is device-accessible and may be captured by value in parallel
+  kernels.
+*/
+class CellLocator
+{
+  public:
+    // Default constructor.
+    CellLocator() = default;
+
+    /*!
+      \brief Create a locator over the ghosted cells of a local grid.
+      \param local_grid The local grid in which positions are located.
+    */
+    template <class LocalGridType>
+    CellLocator( const LocalGridType& local_grid )
+    {
+        auto ghost_cells = local_grid.indexSpace(
+            Cajita::Ghost(), Cajita::Cell(), Cajita::Local() );
+        auto local_mesh =
+            Cajita::createLocalMesh<Kokkos::HostSpace>( local_grid );
+        const auto& global_mesh = local_grid.globalGrid().globalMesh();
+        for ( int d = 0; d < 3; ++d )
+        {
+            _num_cell[d] = ghost_cells.extent( d );
+            _low[d] = local_mesh.lowCorner( Cajita::Ghost(), d );
+            _inv_dx[d] = 1.0 / global_mesh.cellSize( d );
+        }
+    }
+
+    // Get the number of cells in a given dimension.
+    KOKKOS_INLINE_FUNCTION
+    int numCell( const int d ) const { return _num_cell[d]; }
+
+    // Given a position in the logical frame get the local ijk index of the
+    // cell in which it is located.
+    KOKKOS_INLINE_FUNCTION
+    void cellIndex( const double x[3], int ijk[3] ) const
+    {
+        for ( int d = 0; d < 3; ++d )
+        {
+            ijk[d] =
+                static_cast<int>( floor( ( x[d] - _low[d] ) * _inv_dx[d] ) );
+            ijk[d] = ( ijk[d] < 0 ) ? 0 : ijk[d];
+            ijk[d] = ( ijk[d] < _num_cell[d] ) ? ijk[d] : _num_cell[d] - 1;
+        }
+    }
+
+    // Given a position in the logical frame and the local ijk index of a
+    // nearby cell update the index to the cell in which the position is
+    // located. Positions typically move less than a cell between updates so
+    // the index is stepped from its previous value.
+    KOKKOS_INLINE_FUNCTION
+    void updateCellIndex( const double x[3], int ijk[3] ) const
+    {
+        for ( int d = 0; d < 3; ++d )
+        {
+            double xl = ( x[d] - _low[d] ) * _inv_dx[d];
+            while ( ijk[d] > 0 && xl < ijk[d] )
+                --ijk[d];
+            while ( ijk[d] < _num_cell[d] - 1 && xl >= ijk[d] + 1 )
+                ++ijk[d];
+        }
+    }
+
+  private:
+    Kokkos::Array<int, 3> _num_cell;
+    Kokkos::Array<double, 3> _low;
+    Kokkos::Array<double, 3> _inv_dx;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class ParticleBins
+  \brief Cell-to-particle bin lists over the ghosted cells of a local grid.
+
+  Particles are binned by the local cell in which they are located. Within a
+  bin the particles are ordered by increasing particle index so traversals of
+  a bin always visit particles in the same order regardless of the number of
+  threads used to build the bins. The bins are device-accessible and may be
+  captured by value in parallel kernels.
+*/
+template <class MemorySpace>
+class ParticleBins
+{
+  public:
+    using memory_space = MemorySpace;
+
+    // Default constructor.
+    ParticleBins() = default;
+
+    /*!
+      \brief Bin particles in the ghosted cells of a local grid.
+      \param exec_space The execution space to use for parallel kernels.
+      \param local_grid The local grid in which the particles are located.
+      \param x_p A view or slice of particle positions in the logical frame.
+    */
+    template <class ExecutionSpace, class LocalGridType,
+              class ParticlePositions>
+    ParticleBins( const ExecutionSpace& exec_space,
+                  const LocalGridType& local_grid,
+                  const ParticlePositions& x_p )
+    {
+        build( exec_space, local_grid, x_p );
+    }
+
+    /*!
+      \brief Rebuild the bins with the current particle positions.
+      \param exec_space The execution space to use for parallel kernels.
+      \param local_grid The local grid in which the particles are located.
+      \param x_p A view or slice of particle positions in the logical frame.
+    */
+    template <class ExecutionSpace, class LocalGridType,
+              class ParticlePositions>
+    void build( const ExecutionSpace& exec_space,
+                const LocalGridType& local_grid, const ParticlePositions& x_p )
+    {
+        // Bin geometry.
+        _locator = CellLocator( local_grid );
+
+        // Locate each particle in a bin.
+        auto bins = *this;
+        Kokkos::View<int*, memory_space> bin_id(
+            Kokkos::ViewAllocateWithoutInitializing( "bin_id" ), x_p.size() );
+        Kokkos::parallel_for(
+            "particle_bins_locate",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, x_p.size() ),
+            KOKKOS_LAMBDA( const int p ) {
+                double x[3] = { x_p( p, Dim::I ), x_p( p, Dim::J ),
+                                x_p( p, Dim::K ) };
+                int ijk[3];
+                bins.locator().cellIndex( x, ijk );
+                bin_id( p ) =
+                    bins.cardinalIndex( ijk[Dim::I], ijk[Dim::J], ijk[Dim::K] );
+            } );
+
+        // Assign bins from the particle locations.
+        fill( exec_space, bin_id );
+    }
+
+    /*!
+      \brief Rebuild the bins from the cached cell index of each particle.
+      \param exec_space The execution space to use for parallel kernels.
+      \param local_grid The local grid in which the particles are located.
+      \param c_p A view or slice of particle local cell indices as given by
+      CellLocator. Indices outside of the ghosted cells are clamped to the
+      boundary cells.
+    */
+    template <class ExecutionSpace, class LocalGridType, class ParticleCells>
+    void buildFromCellIndex( const ExecutionSpace& exec_space,
+                             const LocalGridType& local_grid,
+                             const ParticleCells& c_p )
+    {
+        // Bin geometry.
+        _locator = CellLocator( local_grid );
+
+        // Get the bin of each particle.
+        auto bins = *this;
+        Kokkos::View<int*, memory_space> bin_id(
+            Kokkos::ViewAllocateWithoutInitializing( "bin_id" ), c_p.size() );
+        Kokkos::parallel_for(
+            "particle_bins_index",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, c_p.size() ),
+            KOKKOS_LAMBDA( const int p ) {
+                int ijk[3];
+                for ( int d = 0; d < 3; ++d )
+                {
+                    ijk[d] = ( c_p( p, d ) < 0 ) ? 0 : c_p( p, d );
+                    ijk[d] = ( ijk[d] < bins.numBin( d ) )
+                                 ? ijk[d]
+                                 : bins.numBin( d ) - 1;
+                }
+                bin_id( p ) = bins.cardinalIndex( ijk[Dim::I], ijk[Dim::J],
+                                                  ijk[Dim::K] );
+            } );
+
+        // Assign bins from the particle cells.
+        fill( exec_space, bin_id );
+    }
+
+    // Get the cell locator of the bins.
+    KOKKOS_INLINE_FUNCTION
+    const CellLocator& locator() const { return _locator; }
+
+    // Get the number of bins in a given dimension.
+    KOKKOS_INLINE_FUNCTION
+    int numBin( const int d ) const { return _locator.numCell( d ); }
+
+    // Get the total number of bins.
+    KOKKOS_INLINE_FUNCTION
+    int totalBins() const
+    {
+        return numBin( Dim::I ) * numBin( Dim::J ) * numBin( Dim::K );
+    }
+
+    // Get the number of binned particles.
+    KOKKOS_INLINE_FUNCTION
+    int numParticle() const { return _permute.extent( 0 ); }
+
+    // Given the local ijk index of a cell get its cardinal bin index.
+    KOKKOS_INLINE_FUNCTION
+    int cardinalIndex( const int i, const int j, const int k ) const
+    {
+        return i + numBin( Dim::I ) * ( j + numBin( Dim::J ) * k );
+    }
+
+    // Get the number of particles in a bin.
+    KOKKOS_INLINE_FUNCTION
+    int binSize( const int i, const int j, const int k ) const
+    {
+        return _counts( cardinalIndex( i, j, k ) );
+    }
+
+    // Get the offset of a bin into the permutation vector.
+    KOKKOS_INLINE_FUNCTION
+    int binOffset( const int i, const int j, const int k ) const
+    {
+        return _offsets( cardinalIndex( i, j, k ) );
+    }
+
+    // Given a binned index get the local particle index.
+    KOKKOS_INLINE_FUNCTION
+    int permutation( const int n ) const { return _permute( n ); }
+
+    // Fill the bins from the cardinal bin index of each particle. This is
+    // public only because device lambdas may not be defined in private
+    // member functions.
+    template <class ExecutionSpace, class BinIdView>
+    void fill( const ExecutionSpace& exec_space, const BinIdView& bin_id )
+    {
+        int num_particle = bin_id.extent( 0 );
+        int num_bin = totalBins();
+
+        // Allocate.
+        _counts = Kokkos::View<int*, memory_space>( "bin_counts", num_bin );
+        _offsets = Kokkos::View<int*, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "bin_offsets" ),
+            num_bin );
+        _permute = Kokkos::View<int*, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "bin_permute" ),
+            num_particle );
+
+        // Count the particles in each bin.
+        auto counts = _counts;
+        auto offsets = _offsets;
+        auto permute = _permute;
+        Kokkos::parallel_for(
+            "particle_bins_count",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, num_particle ),
+            KOKKOS_LAMBDA( const int p ) {
+                Kokkos::atomic_increment( &counts( bin_id( p ) ) );
+            } );
+
+        // Compute the bin offsets.
+        Kokkos::parallel_scan(
+            "particle_bins_offset",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, num_bin ),
+            KOKKOS_LAMBDA( const int b, int& offset, const bool final_pass ) {
+                if ( final_pass )
+                    offsets( b ) = offset;
+                offset += counts( b );
+            } );
+
+        // Fill the bins. The counts are reset and used as fill cursors so
+        // when complete they again hold the bin sizes.
+        Kokkos::deep_copy( exec_space, _counts, 0 );
+        Kokkos::parallel_for(
+            "particle_bins_fill",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, num_particle ),
+            KOKKOS_LAMBDA( const int p ) {
+                int b = bin_id( p );
+                permute( offsets( b ) +
+                         Kokkos::atomic_fetch_add( &counts( b ), 1 ) ) = p;
+            } );
+
+        // The fill order within a bin depends on thread scheduling. Sort each
+        // bin by particle index so bin traversal order is deterministic. Bins
+        // hold a handful of particles so an insertion sort is sufficient.
+        Kokkos::parallel_for(
+            "particle_bins_sort",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, num_bin ),
+            KOKKOS_LAMBDA( const int b ) {
+                int begin = offsets( b );
+                int end = begin + counts( b );
+                for ( int n = begin + 1; n < end; ++n )
+                {
+                    int p = permute( n );
+                    int m = n - 1;
+                    while ( m >= begin && permute( m ) > p )
+                    {
+                        permute( m + 1 ) = permute( m );
+                        --m;
+                    }
+                    permute( m + 1 ) = p;
+                }
+            } );
+    }
+
+  private:
+    CellLocator _locator;
+    Kokkos::View<int*, memory_space> _counts;
+    Kokkos::View<int*, memory_space> _offsets;
+    Kokkos::View<int*, memory_space> _permute;
+};
+
+//---------------------------------------------------------------------------//
+// Creation function.
+template <class ExecutionSpace, class LocalGridType, class ParticlePositions>
+auto createParticleBins( const ExecutionSpace& exec_space,
+                         const LocalGridType& local_grid,
+                         const ParticlePositions& x_p )
+{
+    return ParticleBins<typename ParticlePositions::memory_space>(
+        exec_space, local_grid, x_p );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
+
+#endif // end PICASSO_PARTICLEBINS_HPP
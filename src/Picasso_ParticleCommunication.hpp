@@ -80,6 +80,105 @@ int communicationCount( const LocalGridType& local_grid,
     return comm_count;
 }
 
+//---------------------------------------------------------------------------//
+// Check for the global number of particles that must be communicated using
+// the local cell index of each particle in the ghosted cells of the local
+// grid. Cell indices are clamped to the ghosted cells so particles in the
+// boundary cells are also checked by position.
+template <class LocalGridType, class CoordSliceType, class CellSliceType>
+int communicationCount( const LocalGridType& local_grid,
+                        const CoordSliceType& coords,
+                        const CellSliceType& cells,
+                        const int minimum_halo_width )
+{
+    using execution_space = typename CoordSliceType::execution_space;
+
+    // Get the range of cells inside of the minimum halo and the
+    // corresponding positions.
+    auto local_mesh = Cajita::createLocalMesh<Kokkos::HostSpace>( local_grid );
+    auto dx = local_grid.globalGrid().globalMesh().cellSize( 0 );
+    auto ghost_cells = local_grid.indexSpace( Cajita::Ghost(), Cajita::Cell(),
+                                              Cajita::Local() );
+    Kokkos::Array<int, 3> num_cell;
+    Kokkos::Array<double, 3> local_low;
+    Kokkos::Array<double, 3> local_high;
+    for ( int d = 0; d < 3; ++d )
+    {
+        num_cell[d] = ghost_cells.extent( d );
+        local_low[d] = local_mesh.lowCorner( Cajita::Ghost(), d ) +
+                       minimum_halo_width * dx;
+        local_high[d] = local_mesh.highCorner( Cajita::Ghost(), d ) -
+                        minimum_halo_width * dx;
+    }
+    int comm_count = 0;
+    Kokkos::parallel_reduce(
+        "redistribute_count_cell",
+        Kokkos::RangePolicy<execution_space>( 0, coords.size() ),
+        KOKKOS_LAMBDA( const int p, int& result ) {
+            bool exited = false;
+            for ( int d = 0; d < 3; ++d )
+            {
+                int c = cells( p, d );
+                if ( c == 0 || c == num_cell[d] - 1 )
+                    exited = exited || coords( p, d ) < local_low[d] ||
+                             coords( p, d ) > local_high[d];
+                exited = exited || c < minimum_halo_width ||
+                         c >= num_cell[d] - minimum_halo_width;
+            }
+            if ( exited )
+                result += 1;
+        },
+        comm_count );
+
+    MPI_Allreduce( MPI_IN_PLACE, &comm_count, 1, MPI_INT, MPI_SUM,
+                   local_grid.globalGrid().comm() );
+
+    return comm_count;
+}
+
+//---------------------------------------------------------------------------//
+// Shift particle coordinates which crossed a periodic boundary.
+//---------------------------------------------------------------------------//
+class PeriodicShift
+{
+  public:
+    template <class LocalGridType>
+    PeriodicShift( const LocalGridType& local_grid )
+    {
+        const auto& global_grid = local_grid.globalGrid();
+        const auto& global_mesh = global_grid.globalMesh();
+        for ( int d = 0; d < 3; ++d )
+        {
+            _period[d] = global_grid.isPeriodic( d );
+            _global_low[d] = global_mesh.lowCorner( d );
+            _global_high[d] = global_mesh.highCorner( d );
+            _global_span[d] = global_mesh.extent( d );
+        }
+    }
+
+    template <class CoordSliceType>
+    KOKKOS_INLINE_FUNCTION void operator()( const CoordSliceType& coords,
+                                            const int p ) const
+    {
+        for ( int d = 0; d < 3; ++d )
+        {
+            if ( _period[d] )
+            {
+                if ( coords( p, d ) > _global_high[d] )
+                    coords( p, d ) -= _global_span[d];
+                else if ( coords( p, d ) < _global_low[d] )
+                    coords( p, d ) += _global_span[d];
+            }
+        }
+    }
+
+  private:
+    Kokkos::Array<bool, 3> _period;
+    Kokkos::Array<double, 3> _global_low;
+    Kokkos::Array<double, 3> _global_high;
+    Kokkos::Array<double, 3> _global_span;
+};
+
 //---------------------------------------------------------------------------//
 // Compute particle destinations and shift periodic coordinates.
 //---------------------------------------------------------------------------//
@@ -98,8 +197,6 @@ void prepareCommunication( const LocalGridType& local_grid,
     // rank. If the particle crosses a periodic boundary update it's
     // coordinates to represent the shift.
     auto local_mesh = Cajita::createLocalMesh<Kokkos::HostSpace>( local_grid );
-    const auto& global_grid = local_grid.globalGrid();
-    const auto& global_mesh = global_grid.globalMesh();
     const Kokkos::Array<double, 3> local_low = {
         local_mesh.lowCorner( Cajita::Own(), Dim::I ),
         local_mesh.lowCorner( Cajita::Own(), Dim::J ),
@@ -108,18 +205,7 @@ void prepareCommunication( const LocalGridType& local_grid,
         local_mesh.highCorner( Cajita::Own(), Dim::I ),
         local_mesh.highCorner( Cajita::Own(), Dim::J ),
         local_mesh.highCorner( Cajita::Own(), Dim::K ) };
-    const Kokkos::Array<bool, 3> period = { global_grid.isPeriodic( Dim::I ),
-                                            global_grid.isPeriodic( Dim::J ),
-                                            global_grid.isPeriodic( Dim::K ) };
-    const Kokkos::Array<double, 3> global_low = {
-        global_mesh.lowCorner( Dim::I ), global_mesh.lowCorner( Dim::J ),
-        global_mesh.lowCorner( Dim::K ) };
-    const Kokkos::Array<double, 3> global_high = {
-        global_mesh.highCorner( Dim::I ), global_mesh.highCorner( Dim::J ),
-        global_mesh.highCorner( Dim::K ) };
-    const Kokkos::Array<double, 3> global_span = {
-        global_mesh.extent( Dim::I ), global_mesh.extent( Dim::J ),
-        global_mesh.extent( Dim::K ) };
+    PeriodicShift periodic_shift( local_grid );
     Kokkos::parallel_for(
         "redistribute_locate_shift",
         Kokkos::RangePolicy<execution_space>( 0, coords.size() ),
@@ -139,45 +225,118 @@ void prepareCommunication( const LocalGridType& local_grid,
                 nid[Dim::I] + 3 * ( nid[Dim::J] + 3 * nid[Dim::K] ) );
 
             // Shift periodic coordinates if needed.
+            periodic_shift( coords, p );
+        } );
+}
+
+//---------------------------------------------------------------------------//
+// Compute particle destinations from the local cell index of each particle
+// in the ghosted cells of the local grid and shift periodic
+// coordinates. Cell indices are clamped to the ghosted cells so particles in
+// the boundary cells are located by position. Particles which leave the
+// owned cells are either sent to another rank or shifted across a periodic
+// boundary so their cell index is invalidated by setting it to -1.
+//---------------------------------------------------------------------------//
+template <class LocalGridType, class CoordSliceType, class CellSliceType,
+          class NeighborRankView, class DestinationRankView>
+void prepareCommunication( const LocalGridType& local_grid,
+                           const NeighborRankView& neighbor_ranks,
+                           DestinationRankView& destinations,
+                           CoordSliceType& coords, CellSliceType& cells )
+{
+    using execution_space = typename CoordSliceType::execution_space;
+
+    // Get the owned cells and their bounding positions.
+    auto local_mesh = Cajita::createLocalMesh<Kokkos::HostSpace>( local_grid );
+    auto ghost_cells = local_grid.indexSpace( Cajita::Ghost(), Cajita::Cell(),
+                                              Cajita::Local() );
+    auto own_cells = local_grid.indexSpace( Cajita::Own(), Cajita::Cell(),
+                                            Cajita::Local() );
+    Kokkos::Array<int, 3> num_cell;
+    Kokkos::Array<int, 3> own_min;
+    Kokkos::Array<int, 3> own_max;
+    Kokkos::Array<double, 3> local_low;
+    Kokkos::Array<double, 3> local_high;
+    for ( int d = 0; d < 3; ++d )
+    {
+        num_cell[d] = ghost_cells.extent( d );
+        own_min[d] = own_cells.min( d );
+        own_max[d] = own_cells.max( d );
+        local_low[d] = local_mesh.lowCorner( Cajita::Own(), d );
+        local_high[d] = local_mesh.highCorner( Cajita::Own(), d );
+    }
+    PeriodicShift periodic_shift( local_grid );
+    Kokkos::parallel_for(
+        "redistribute_locate_shift_cell",
+        Kokkos::RangePolicy<execution_space>( 0, coords.size() ),
+        KOKKOS_LAMBDA( const int p ) {
+            // Compute the logical index of the neighbor we are sending to.
+            int nid[3] = { 1, 1, 1 };
             for ( int d = 0; d < 3; ++d )
             {
-                if ( period[d] )
+                int c = cells( p, d );
+                if ( c == 0 || c == num_cell[d] - 1 )
                 {
-                    if ( coords( p, d ) > global_high[d] )
-                        coords( p, d ) -= global_span[d];
-                    else if ( coords( p, d ) < global_low[d] )
-                        coords( p, d ) += global_span[d];
+                    if ( coords( p, d ) < local_low[d] )
+                        nid[d] = 0;
+                    else if ( coords( p, d ) > local_high[d] )
+                        nid[d] = 2;
                 }
+                else if ( c < own_min[d] )
+                    nid[d] = 0;
+                else if ( c >= own_max[d] )
+                    nid[d] = 2;
             }
-        } );
-}
 
-//---------------------------------------------------------------------------//
-// Particle redistribution
-//---------------------------------------------------------------------------//
-/*!
-  \brief Redistribute particles to new owning ranks based on their location.
+            // Compute the destination MPI rank.
+            int n = nid[Dim::I] + 3 * ( nid[Dim::J] + 3 * nid[Dim::K] );
+            destinations( p ) = neighbor_ranks( n );
 
-  \param local_grid The local_grid in which the particles are currently
-  located.
+            // Invalidate the cell index of particles leaving the owned
+            // cells.
+            if ( 13 != n )
+                for ( int d = 0; d < 3; ++d )
+                    cells( p, d ) = -1;
 
-  \param minimum_halo_width The minimum halo size needed for local
-  operations.
+            // Shift periodic coordinates if needed.
+            periodic_shift( coords, p );
+        } );
+}
 
-  \param particles The particles to redistribute.
+//---------------------------------------------------------------------------//
+// Placeholder for particles which are located by position only.
+struct NoCellIndex
+{
+};
 
-  \param Member index in the AoSoA of the particle coordinates.
+template <class LocalGridType, class CoordSliceType>
+int communicationCount( const LocalGridType& local_grid,
+                        const CoordSliceType& coords, NoCellIndex,
+                        const int minimum_halo_width )
+{
+    return communicationCount( local_grid, coords, minimum_halo_width );
+}
 
-  \param force_communication If true communication will always occur even if
-  particles have not exited the halo.
+template <class LocalGridType, class CoordSliceType, class NeighborRankView,
+          class DestinationRankView>
+void prepareCommunication( const LocalGridType& local_grid,
+                           const NeighborRankView& neighbor_ranks,
+                           DestinationRankView& destinations,
+                           CoordSliceType& coords, NoCellIndex& )
+{
+    prepareCommunication( local_grid, neighbor_ranks, destinations, coords );
+}
 
-  \return Return true if redistribution was performed.
- */
-template <class LocalGridType, class ParticleContainer, class Coordinates>
-bool redistribute( const LocalGridType& local_grid,
-                   const int minimum_halo_width, const Coordinates& coords,
-                   ParticleContainer& particles,
-                   const bool force_communication = false )
+//---------------------------------------------------------------------------//
+// Particle redistribution
+//---------------------------------------------------------------------------//
+// Redistribute particles located by position or by cell index.
+template <class LocalGridType, class ParticleContainer, class Coordinates,
+          class Cells>
+bool redistributeImpl( const LocalGridType& local_grid,
+                       const int minimum_halo_width, const Coordinates& coords,
+                       Cells cells, ParticleContainer& particles,
+                       const bool force_communication )
 {
     using device_type = typename ParticleContainer::device_type;
 
@@ -186,8 +345,8 @@ bool redistribute( const LocalGridType& local_grid,
     if ( !force_communication )
     {
         // Check to see if we need to communicate.
-        auto comm_count =
-            communicationCount( local_grid, coords, minimum_halo_width );
+        auto comm_count = communicationCount( local_grid, coords, cells,
+                                              minimum_halo_width );
 
         // If we have no particle communication to do then exit.
         if ( 0 == comm_count )
@@ -213,7 +372,7 @@ bool redistribute( const LocalGridType& local_grid,
     Kokkos::View<int*, device_type> destinations(
         Kokkos::ViewAllocateWithoutInitializing( "destinations" ),
         particles.size() );
-    prepareCommunication( local_grid, nr_mirror, destinations, coords );
+    prepareCommunication( local_grid, nr_mirror, destinations, coords, cells );
 
     // Make the topology a list of unique and valid ranks.
     auto remove_end = std::remove( topology.begin(), topology.end(), -1 );
@@ -232,6 +391,73 @@ bool redistribute( const LocalGridType& local_grid,
     return true;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+  \brief Redistribute particles to new owning ranks based on their location.
+
+  \param local_grid The local_grid in which the particles are currently
+  located.
+
+  \param minimum_halo_width The minimum halo size needed for local
+  operations.
+
+  \param particles The particles to redistribute.
+
+  \param Member index in the AoSoA of the particle coordinates.
+
+  \param force_communication If true communication will always occur even if
+  particles have not exited the halo.
+
+  \return Return true if redistribution was performed.
+ */
+template <class LocalGridType, class ParticleContainer, class Coordinates>
+bool redistribute( const LocalGridType& local_grid,
+                   const int minimum_halo_width, const Coordinates& coords,
+                   ParticleContainer& particles,
+                   const bool force_communication = false )
+{
+    return redistributeImpl( local_grid, minimum_halo_width, coords,
+                             NoCellIndex(), particles, force_communication );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Redistribute particles to new owning ranks based on their local
+  cell index. The cell indices must be current with the particle coordinates.
+  The cell index of each particle which leaves the owned cells, whether it is
+  sent to another rank or shifted across a periodic boundary, is set to -1
+  and must be recomputed after redistribution. The cell indices of all other
+  particles remain valid.
+
+  \param local_grid The local_grid in which the particles are currently
+  located.
+
+  \param minimum_halo_width The minimum halo size needed for local
+  operations.
+
+  \param coords The particle coordinates.
+
+  \param cells The local cell index of each particle in the ghosted cells of
+  the local grid as given by CellLocator.
+
+  \param particles The particles to redistribute.
+
+  \param force_communication If true communication will always occur even if
+  particles have not exited the halo.
+
+  \return Return true if redistribution was performed.
+ */
+template <class LocalGridType, class ParticleContainer, class Coordinates,
+          class Cells>
+bool redistribute( const LocalGridType& local_grid,
+                   const int minimum_halo_width, const Coordinates& coords,
+                   const Cells& cells, ParticleContainer& particles,
+                   const bool force_communication = false )
+{
+    return redistributeImpl( local_grid, minimum_halo_width, coords, cells,
+                             particles, force_communication );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace ParticleCommunication
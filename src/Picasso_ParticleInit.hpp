@@ -12,6 +12,7 @@
 #ifndef PICASSO_PARTICLEINIT_HPP
 #define PICASSO_PARTICLEINIT_HPP
 
+#include <Picasso_FieldTypes.hpp>
 #include <Picasso_Types.hpp>
 
 #include <Cabana_Core.hpp>
@@ -20,6 +21,8 @@
 #include <Kokkos_Core.hpp>
 #include <Kokkos_Random.hpp>
 
+#include <type_traits>
+
 namespace Picasso
 {
 //---------------------------------------------------------------------------//
@@ -78,6 +81,23 @@ void filterEmpties( const ExecutionSpace& exec_space,
     particles.shrinkToFit();
 }
 
+//---------------------------------------------------------------------------//
+// Compute the cell index of the created particles if they have one.
+template <class ParticleListType>
+std::enable_if_t<ParticleListType::template has_field<
+    Field::LogicalCellIndex>::value>
+initializeCellIndex( ParticleListType& particle_list )
+{
+    particle_list.updateCellIndex();
+}
+
+template <class ParticleListType>
+std::enable_if_t<!ParticleListType::template has_field<
+    Field::LogicalCellIndex>::value>
+initializeCellIndex( ParticleListType& )
+{
+}
+
 //---------------------------------------------------------------------------//
 /*!
   \brief Initialize a random number of particles in each cell given an
@@ -101,7 +121,7 @@ void filterEmpties( const ExecutionSpace& exec_space,
 
   \param particle_list The list of particles to populate. This will be filled
   with particles and resized to a size equal to the number of particles
-  created.
+  created. The particle cell index, if present, is computed.
 */
 template <class ParticleListType, class InitFunctor, class ExecutionSpace>
 void initializeParticles( InitRandom, const ExecutionSpace& exec_space,
@@ -216,6 +236,9 @@ void initializeParticles( InitRandom, const ExecutionSpace& exec_space,
 
     // Filter empties.
     filterEmpties( exec_space, local_num_create, particle_created, particles );
+
+    // Compute the cell index.
+    initializeCellIndex( particle_list );
 }
 
 //---------------------------------------------------------------------------//
@@ -242,7 +265,7 @@ void initializeParticles( InitRandom, const ExecutionSpace& exec_space,
 
   \param particle_list The list of particles to populate. This will be filled
   with particles and resized to a size equal to the number of particles
-  created.
+  created. The particle cell index, if present, is computed.
 */
 template <class ParticleListType, class InitFunctor, class ExecutionSpace>
 void initializeParticles( InitUniform, const ExecutionSpace& exec_space,
@@ -364,6 +387,9 @@ void initializeParticles( InitUniform, const ExecutionSpace& exec_space,
 
     // Filter empties.
     filterEmpties( exec_space, local_num_create, particle_created, particles );
+
+    // Compute the cell index.
+    initializeCellIndex( particle_list );
 }
 
 //---------------------------------------------------------------------------//
@@ -14,10 +14,12 @@
 
 #include <Picasso_BatchedLinearAlgebra.hpp>
 #include <Picasso_FieldTypes.hpp>
+#include <Picasso_Types.hpp>
 
 #include <Cajita.hpp>
 
 #include <type_traits>
+#include <utility>
 
 namespace Picasso
 {
@@ -180,6 +182,92 @@ gradient( const SplineDataType& sd, const ViewType& view, ResultMatrix& result )
             result( i, j ) = r[i][j];
 }
 
+//---------------------------------------------------------------------------//
+// G2P scalar value and gradient in a single traversal of the stencil such
+// that each grid value is read once. Requires SplineValue and SplineGradient
+// when constructing the spline data.
+template <class ViewType, class SplineDataType, class Scalar,
+          class ResultVector,
+          typename std::enable_if_t<
+              LinearAlgebra::is_vector<ResultVector>::value, int> = 0>
+KOKKOS_INLINE_FUNCTION void valueAndGradient( const SplineDataType& sd,
+                                              const ViewType& view,
+                                              Scalar& value,
+                                              ResultVector& gradient )
+{
+    static_assert( SplineDataType::has_weight_values,
+                   "G2P::valueAndGradient requires spline weight values" );
+    static_assert( SplineDataType::has_weight_physical_gradients,
+                   "G2P::valueAndGradient requires spline weight gradients" );
+
+    value = 0.0;
+    gradient = 0.0;
+    for ( int i = 0; i < SplineDataType::num_knot; ++i )
+        for ( int j = 0; j < SplineDataType::num_knot; ++j )
+            for ( int k = 0; k < SplineDataType::num_knot; ++k )
+            {
+                auto v = view( sd.s[Dim::I][i], sd.s[Dim::J][j],
+                               sd.s[Dim::K][k], 0 );
+                value += sd.w[Dim::I][i] * sd.w[Dim::J][j] *
+                         sd.w[Dim::K][k] * v;
+                gradient( Dim::I ) += sd.g[Dim::I][i] * sd.w[Dim::J][j] *
+                                      sd.w[Dim::K][k] * v;
+                gradient( Dim::J ) += sd.w[Dim::I][i] * sd.g[Dim::J][j] *
+                                      sd.w[Dim::K][k] * v;
+                gradient( Dim::K ) += sd.w[Dim::I][i] * sd.w[Dim::J][j] *
+                                      sd.g[Dim::K][k] * v;
+            }
+}
+
+//---------------------------------------------------------------------------//
+// G2P vector value and gradient in a single traversal of the stencil such
+// that each grid value is read once. The gradient is ordered as in
+// G2P::gradient. Requires SplineValue and SplineGradient when constructing
+// the spline data.
+template <class ViewType, class SplineDataType, class ResultVector,
+          class ResultMatrix,
+          typename std::enable_if_t<
+              LinearAlgebra::is_matrix<ResultMatrix>::value, int> = 0>
+KOKKOS_INLINE_FUNCTION void valueAndGradient( const SplineDataType& sd,
+                                              const ViewType& view,
+                                              ResultVector& value,
+                                              ResultMatrix& gradient )
+{
+    static_assert( SplineDataType::has_weight_values,
+                   "G2P::valueAndGradient requires spline weight values" );
+    static_assert( SplineDataType::has_weight_physical_gradients,
+                   "G2P::valueAndGradient requires spline weight gradients" );
+
+    using value_type = typename ResultMatrix::value_type;
+
+    value = 0.0;
+    gradient = 0.0;
+    value_type v[3];
+    value_type w;
+    value_type g[3];
+    for ( int i = 0; i < SplineDataType::num_knot; ++i )
+        for ( int j = 0; j < SplineDataType::num_knot; ++j )
+            for ( int k = 0; k < SplineDataType::num_knot; ++k )
+            {
+                for ( int d = 0; d < 3; ++d )
+                    v[d] = view( sd.s[Dim::I][i], sd.s[Dim::J][j],
+                                 sd.s[Dim::K][k], d );
+                w = sd.w[Dim::I][i] * sd.w[Dim::J][j] * sd.w[Dim::K][k];
+                g[Dim::I] = sd.g[Dim::I][i] * sd.w[Dim::J][j] * sd.w[Dim::K][k];
+                g[Dim::J] = sd.w[Dim::I][i] * sd.g[Dim::J][j] * sd.w[Dim::K][k];
+                g[Dim::K] = sd.w[Dim::I][i] * sd.w[Dim::J][j] * sd.g[Dim::K][k];
+                for ( int d0 = 0; d0 < 3; ++d0 )
+                {
+                    value( d0 ) += w * v[d0];
+#if defined( KOKKOS_ENABLE_PRAGMA_UNROLL )
+#pragma unroll
+#endif
+                    for ( int d1 = 0; d1 < 3; ++d1 )
+                        gradient( d0, d1 ) += g[d0] * v[d1];
+                }
+            }
+}
+
 //---------------------------------------------------------------------------//
 // G2P vector divergence. Requires SplineValue and SplineGradient when
 // constructing the spline data.
@@ -199,11 +287,71 @@ KOKKOS_INLINE_FUNCTION void divergence( const SplineDataType& sd,
 //---------------------------------------------------------------------------//
 namespace P2G
 {
+//---------------------------------------------------------------------------//
+// Targeted accumulators receive the contributions of a single grid entity
+// and discard all others (see ParticleGather). They define the
+// targeted_accumulator type and give the local index of their target entity
+// as i, j, and k. P2G operations on a targeted accumulator only evaluate the
+// stencil weight of the target.
+template <class T>
+struct TargetedAccumulatorVoid
+{
+    using type = void;
+};
+
+template <class T, class = void>
+struct is_targeted_accumulator : public std::false_type
+{
+};
+
+template <class T>
+struct is_targeted_accumulator<
+    T, typename TargetedAccumulatorVoid<typename T::targeted_accumulator>::type>
+    : public std::true_type
+{
+};
+
+//---------------------------------------------------------------------------//
+// Get the stencil knot of the target entity of a targeted accumulator.
+// Stencil indices are consecutive so the knot is found by offset. Returns
+// false if the target is not in the stencil.
+template <class SplineDataType, class AccumulatorType>
+KOKKOS_INLINE_FUNCTION bool targetKnot( const SplineDataType& sd,
+                                        const AccumulatorType& view,
+                                        int knot[3] )
+{
+    const int target[3] = { view.i, view.j, view.k };
+    for ( int d = 0; d < 3; ++d )
+    {
+        knot[d] = target[d] - sd.s[d][0];
+        if ( knot[d] < 0 || knot[d] >= SplineDataType::num_knot )
+            return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+// Get the physical gradient of the stencil weight of a knot.
+template <class SplineDataType>
+KOKKOS_INLINE_FUNCTION void
+knotGradient( const SplineDataType& sd, const int knot[3],
+              typename SplineDataType::scalar_type grad[3] )
+{
+    grad[Dim::I] = sd.g[Dim::I][knot[Dim::I]] * sd.w[Dim::J][knot[Dim::J]] *
+                   sd.w[Dim::K][knot[Dim::K]];
+    grad[Dim::J] = sd.w[Dim::I][knot[Dim::I]] * sd.g[Dim::J][knot[Dim::J]] *
+                   sd.w[Dim::K][knot[Dim::K]];
+    grad[Dim::K] = sd.w[Dim::I][knot[Dim::I]] * sd.w[Dim::J][knot[Dim::J]] *
+                   sd.g[Dim::K][knot[Dim::K]];
+}
+
 //---------------------------------------------------------------------------//
 // P2G scalar value. Requires SplineValue when constructing the spline data.
 template <class Scalar, class ScatterViewType, class SplineDataType,
-          typename std::enable_if_t<!LinearAlgebra::is_vector<Scalar>::value,
-                                    int> = 0>
+          typename std::enable_if_t<
+              !LinearAlgebra::is_vector<Scalar>::value &&
+                  !is_targeted_accumulator<ScatterViewType>::value,
+              int> = 0>
 KOKKOS_INLINE_FUNCTION void value( const SplineDataType& sd,
                                    const Scalar& value,
                                    const ScatterViewType& view )
@@ -215,7 +363,9 @@ KOKKOS_INLINE_FUNCTION void value( const SplineDataType& sd,
 // P2G vector value. Requires SplineValue when constructing the spline data.
 template <class ValueVector, class ScatterViewType, class SplineDataType,
           typename std::enable_if_t<
-              LinearAlgebra::is_vector<ValueVector>::value, int> = 0>
+              LinearAlgebra::is_vector<ValueVector>::value &&
+                  !is_targeted_accumulator<ScatterViewType>::value,
+              int> = 0>
 KOKKOS_INLINE_FUNCTION void value( const SplineDataType& sd,
                                    const ValueVector& value,
                                    const ScatterViewType& view )
@@ -227,10 +377,167 @@ KOKKOS_INLINE_FUNCTION void value( const SplineDataType& sd,
     Cajita::P2G::value( v, sd, view );
 }
 
+//---------------------------------------------------------------------------//
+// P2G scalar value contribution to a single stencil entity.
+template <class Weight, class Scalar, class ScatterAccessType,
+          typename std::enable_if_t<!LinearAlgebra::is_vector<Scalar>::value,
+                                    int> = 0>
+KOKKOS_FORCEINLINE_FUNCTION void
+knotValue( const int i, const int j, const int k, const Weight w,
+           const Scalar& value, const ScatterAccessType& view_access )
+{
+    view_access( i, j, k, 0 ) += value * w;
+}
+
+//---------------------------------------------------------------------------//
+// P2G vector value contribution to a single stencil entity.
+template <class Weight, class ValueVector, class ScatterAccessType,
+          typename std::enable_if_t<
+              LinearAlgebra::is_vector<ValueVector>::value, int> = 0>
+KOKKOS_FORCEINLINE_FUNCTION void
+knotValue( const int i, const int j, const int k, const Weight w,
+           const ValueVector& value, const ScatterAccessType& view_access )
+{
+#if defined( KOKKOS_ENABLE_PRAGMA_UNROLL )
+#pragma unroll
+#endif
+    for ( int d = 0; d < 3; ++d )
+        view_access( i, j, k, d ) += value( d ) * w;
+}
+
+//---------------------------------------------------------------------------//
+// P2G scalar value to a targeted accumulator.
+template <class Scalar, class ScatterViewType, class SplineDataType,
+          typename std::enable_if_t<
+              !LinearAlgebra::is_vector<Scalar>::value &&
+                  is_targeted_accumulator<ScatterViewType>::value,
+              int> = 0>
+KOKKOS_INLINE_FUNCTION void value( const SplineDataType& sd,
+                                   const Scalar& value,
+                                   const ScatterViewType& view )
+{
+    int knot[3];
+    if ( targetKnot( sd, view, knot ) )
+        knotValue( view.i, view.j, view.k,
+                   sd.w[Dim::I][knot[Dim::I]] * sd.w[Dim::J][knot[Dim::J]] *
+                       sd.w[Dim::K][knot[Dim::K]],
+                   value, view.access() );
+}
+
+//---------------------------------------------------------------------------//
+// P2G vector value to a targeted accumulator.
+template <class ValueVector, class ScatterViewType, class SplineDataType,
+          typename std::enable_if_t<
+              LinearAlgebra::is_vector<ValueVector>::value &&
+                  is_targeted_accumulator<ScatterViewType>::value,
+              int> = 0>
+KOKKOS_INLINE_FUNCTION void value( const SplineDataType& sd,
+                                   const ValueVector& value,
+                                   const ScatterViewType& view )
+{
+    int knot[3];
+    if ( targetKnot( sd, view, knot ) )
+        knotValue( view.i, view.j, view.k,
+                   sd.w[Dim::I][knot[Dim::I]] * sd.w[Dim::J][knot[Dim::J]] *
+                       sd.w[Dim::K][knot[Dim::K]],
+                   value, view.access() );
+}
+
+//---------------------------------------------------------------------------//
+// P2G multiple values implementation.
+template <class SplineDataType, class ValuePack, class ViewPack,
+          std::size_t... Indices>
+KOKKOS_INLINE_FUNCTION void valuesImpl( const SplineDataType& sd,
+                                        const ValuePack& values,
+                                        const ViewPack& views,
+                                        std::index_sequence<Indices...>,
+                                        std::false_type )
+{
+    // Get the scatter view accessors.
+    auto view_access =
+        Cajita::makeParameterPack( Cajita::get<Indices>( views ).access()... );
+
+    // Compute each knot weight once and apply it to all values. The dummy
+    // array expands the contributions in device code.
+    for ( int i = 0; i < SplineDataType::num_knot; ++i )
+        for ( int j = 0; j < SplineDataType::num_knot; ++j )
+            for ( int k = 0; k < SplineDataType::num_knot; ++k )
+            {
+                typename SplineDataType::scalar_type w =
+                    sd.w[Dim::I][i] * sd.w[Dim::J][j] * sd.w[Dim::K][k];
+                int knots[] = { 0, ( knotValue( sd.s[Dim::I][i],
+                                                sd.s[Dim::J][j],
+                                                sd.s[Dim::K][k], w,
+                                                Cajita::get<Indices>( values ),
+                                                Cajita::get<Indices>(
+                                                    view_access ) ),
+                                     0 )... };
+                (void)knots;
+            }
+}
+
+//---------------------------------------------------------------------------//
+// P2G multiple values to targeted accumulators. Only the target weight of
+// each value is evaluated so the values are applied individually.
+template <class SplineDataType, class ValuePack, class ViewPack,
+          std::size_t... Indices>
+KOKKOS_INLINE_FUNCTION void valuesImpl( const SplineDataType& sd,
+                                        const ValuePack& values,
+                                        const ViewPack& views,
+                                        std::index_sequence<Indices...>,
+                                        std::true_type )
+{
+    int targets[] = { 0, ( value( sd, Cajita::get<Indices>( values ),
+                                  Cajita::get<Indices>( views ) ),
+                           0 )... };
+    (void)targets;
+}
+
+//---------------------------------------------------------------------------//
+// Check if all types of a parameter pack are targeted accumulators.
+template <class... Ts>
+struct are_targeted_accumulators;
+
+template <>
+struct are_targeted_accumulators<> : public std::true_type
+{
+};
+
+template <class T, class... Ts>
+struct are_targeted_accumulators<T, Ts...>
+    : public std::integral_constant<
+          bool, is_targeted_accumulator<T>::value &&
+                    are_targeted_accumulators<Ts...>::value>
+{
+};
+
+//---------------------------------------------------------------------------//
+// P2G multiple values in a single traversal of the spline stencil. Requires
+// SplineValue when constructing the spline data. Values and scatter views
+// are given as Cajita parameter packs of equal size and each value is
+// interpolated to the view with the same index. Scalar and vector values may
+// be mixed.
+template <class SplineDataType, class... Values, class... ScatterViewTypes>
+KOKKOS_INLINE_FUNCTION void
+values( const SplineDataType& sd,
+        const Cajita::ParameterPack<Values...>& values,
+        const Cajita::ParameterPack<ScatterViewTypes...>& views )
+{
+    static_assert( sizeof...( Values ) == sizeof...( ScatterViewTypes ),
+                   "P2G::values requires one scatter view per value" );
+    static_assert( SplineDataType::has_weight_values,
+                   "P2G::values requires spline weight values" );
+    valuesImpl(
+        sd, values, views, std::index_sequence_for<Values...>(),
+        typename are_targeted_accumulators<ScatterViewTypes...>::type() );
+}
+
 //---------------------------------------------------------------------------//
 // P2G scalar gradient. Requires SplineValue and SplineGradient when
 // constructing the spline data.
-template <class Scalar, class ScatterViewType, class SplineDataType>
+template <class Scalar, class ScatterViewType, class SplineDataType,
+          typename std::enable_if_t<
+              !is_targeted_accumulator<ScatterViewType>::value, int> = 0>
 KOKKOS_INLINE_FUNCTION void gradient( const SplineDataType& sd,
                                       const Scalar& value,
                                       const ScatterViewType& view )
@@ -243,7 +550,9 @@ KOKKOS_INLINE_FUNCTION void gradient( const SplineDataType& sd,
 // constructing the spline data.
 template <class ValueVector, class ScatterViewType, class SplineDataType,
           typename std::enable_if_t<
-              LinearAlgebra::is_vector<ValueVector>::value, int> = 0>
+              LinearAlgebra::is_vector<ValueVector>::value &&
+                  !is_targeted_accumulator<ScatterViewType>::value,
+              int> = 0>
 KOKKOS_INLINE_FUNCTION void divergence( const SplineDataType& sd,
                                         const ValueVector& value,
                                         const ScatterViewType& view )
@@ -260,7 +569,9 @@ KOKKOS_INLINE_FUNCTION void divergence( const SplineDataType& sd,
 // constructing the spline data.
 template <class ValueMatrix, class ScatterViewType, class SplineDataType,
           typename std::enable_if_t<
-              LinearAlgebra::is_matrix<ValueMatrix>::value, int> = 0>
+              LinearAlgebra::is_matrix<ValueMatrix>::value &&
+                  !is_targeted_accumulator<ScatterViewType>::value,
+              int> = 0>
 KOKKOS_INLINE_FUNCTION void divergence( const SplineDataType& sd,
                                         const ValueMatrix& value,
                                         const ScatterViewType& view )
@@ -274,6 +585,79 @@ KOKKOS_INLINE_FUNCTION void divergence( const SplineDataType& sd,
     Cajita::P2G::divergence( v, sd, view );
 }
 
+//---------------------------------------------------------------------------//
+// P2G scalar gradient to a targeted accumulator.
+template <class Scalar, class ScatterViewType, class SplineDataType,
+          typename std::enable_if_t<
+              is_targeted_accumulator<ScatterViewType>::value, int> = 0>
+KOKKOS_INLINE_FUNCTION void gradient( const SplineDataType& sd,
+                                      const Scalar& value,
+                                      const ScatterViewType& view )
+{
+    static_assert( SplineDataType::has_weight_physical_gradients,
+                   "P2G::gradient requires spline weight gradients" );
+    int knot[3];
+    if ( targetKnot( sd, view, knot ) )
+    {
+        typename SplineDataType::scalar_type grad[3];
+        knotGradient( sd, knot, grad );
+        auto view_access = view.access();
+        for ( int d = 0; d < 3; ++d )
+            view_access( view.i, view.j, view.k, d ) += value * grad[d];
+    }
+}
+
+//---------------------------------------------------------------------------//
+// P2G vector divergence to a targeted accumulator.
+template <class ValueVector, class ScatterViewType, class SplineDataType,
+          typename std::enable_if_t<
+              LinearAlgebra::is_vector<ValueVector>::value &&
+                  is_targeted_accumulator<ScatterViewType>::value,
+              int> = 0>
+KOKKOS_INLINE_FUNCTION void divergence( const SplineDataType& sd,
+                                        const ValueVector& value,
+                                        const ScatterViewType& view )
+{
+    static_assert( SplineDataType::has_weight_physical_gradients,
+                   "P2G::divergence requires spline weight gradients" );
+    int knot[3];
+    if ( targetKnot( sd, view, knot ) )
+    {
+        typename SplineDataType::scalar_type grad[3];
+        knotGradient( sd, knot, grad );
+        view.access()( view.i, view.j, view.k, 0 ) +=
+            value( Dim::I ) * grad[Dim::I] + value( Dim::J ) * grad[Dim::J] +
+            value( Dim::K ) * grad[Dim::K];
+    }
+}
+
+//---------------------------------------------------------------------------//
+// P2G tensor divergence to a targeted accumulator.
+template <class ValueMatrix, class ScatterViewType, class SplineDataType,
+          typename std::enable_if_t<
+              LinearAlgebra::is_matrix<ValueMatrix>::value &&
+                  is_targeted_accumulator<ScatterViewType>::value,
+              int> = 0>
+KOKKOS_INLINE_FUNCTION void divergence( const SplineDataType& sd,
+                                        const ValueMatrix& value,
+                                        const ScatterViewType& view )
+{
+    static_assert( SplineDataType::has_weight_physical_gradients,
+                   "P2G::divergence requires spline weight gradients" );
+    int knot[3];
+    if ( targetKnot( sd, view, knot ) )
+    {
+        typename SplineDataType::scalar_type grad[3];
+        knotGradient( sd, knot, grad );
+        auto view_access = view.access();
+        for ( int d1 = 0; d1 < 3; ++d1 )
+            view_access( view.i, view.j, view.k, d1 ) +=
+                grad[Dim::I] * value( Dim::I, d1 ) +
+                grad[Dim::J] * value( Dim::J, d1 ) +
+                grad[Dim::K] * value( Dim::K, d1 );
+    }
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace P2G
@@ -14,6 +14,7 @@
 
 #include <Picasso_FieldManager.hpp>
 #include <Picasso_LevelSet.hpp>
+#include <Picasso_ParticleBins.hpp>
 #include <Picasso_Types.hpp>
 
 #include <Cajita.hpp>
@@ -24,6 +25,9 @@
 
 #include <cfloat>
 #include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 //---------------------------------------------------------------------------//
 // ArborX Data
@@ -68,11 +72,14 @@ struct ParticleLevelSetPredicateData
     size_type size;
     size_type i_size;
     size_type ij_size;
+    Kokkos::Array<float, 3> shift;
 
     template <class LocalGrid>
     ParticleLevelSetPredicateData( const LocalMesh& lm,
-                                   const LocalGrid& local_grid )
+                                   const LocalGrid& local_grid,
+                                   const Kokkos::Array<float, 3>& s )
         : local_mesh( lm )
+        , shift( s )
     {
         auto ghost_entities = local_grid.indexSpace(
             Cajita::Ghost(), entity_type(), Cajita::Local() );
@@ -122,6 +129,60 @@ struct ParticleLevelSetCallback
     }
 };
 
+//---------------------------------------------------------------------------//
+// Multi-color search predicates. We search the tree with the mesh entities
+// for all particles within a cutoff distance.
+template <class LocalMesh, class EntityType>
+struct MultiColorParticleLevelSetPredicateData
+    : public ParticleLevelSetPredicateData<LocalMesh, EntityType>
+{
+    using base_type = ParticleLevelSetPredicateData<LocalMesh, EntityType>;
+    float cutoff;
+
+    template <class LocalGrid>
+    MultiColorParticleLevelSetPredicateData(
+        const LocalMesh& lm, const LocalGrid& local_grid,
+        const Kokkos::Array<float, 3>& s, const float c )
+        : base_type( lm, local_grid, s )
+        , cutoff( c )
+    {
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Multi-color query callback. When a particle within the cutoff is found we
+// min-reduce its squared distance into the estimate of its color. Each
+// predicate is traversed by a single thread so no atomics are needed.
+template <class CoordinateSlice, class DistanceView>
+struct MultiColorParticleLevelSetCallback
+{
+    ParticleLevelSetPrimitiveData<CoordinateSlice> primitive_data;
+    Kokkos::View<int*, typename CoordinateSlice::memory_space> slot;
+    DistanceView distance_sqr;
+
+    template <typename Predicate>
+    KOKKOS_FUNCTION void operator()( Predicate const& predicate,
+                                     int primitive_index ) const
+    {
+        // Get the actual index of the particle.
+        auto p = primitive_data.c( primitive_index );
+
+        // Get the predicate storage.
+        auto storage = getData( predicate );
+
+        // Compute the squared distance from the grid entity to the particle
+        // and reduce it into the estimate of the particle color.
+        float dx = static_cast<float>( primitive_data.x( p, 0 ) ) - storage.x;
+        float dy = static_cast<float>( primitive_data.x( p, 1 ) ) - storage.y;
+        float dz = static_cast<float>( primitive_data.x( p, 2 ) ) - storage.z;
+        float dist_sqr = dx * dx + dy * dy + dz * dz;
+        auto& result = distance_sqr( storage.i, storage.j, storage.k,
+                                     slot( primitive_index ) );
+        if ( dist_sqr < result )
+            result = dist_sqr;
+    }
+};
+
 } // end namespace Picasso
 
 //---------------------------------------------------------------------------//
@@ -182,9 +243,54 @@ struct AccessTraits<
         storage.y = x[1];
         storage.z = x[2];
 
-        // Find the nearest particle to the entity. Attach the entity index to
-        // use in the callback.
-        return attach( nearest( Point{ storage.x, storage.y, storage.z }, 1 ),
+        // Find the nearest particle to the entity. The tree is searched at
+        // the entity location less the common translation of the particles
+        // since the tree was built. Attach the entity index to use in the
+        // callback.
+        return attach( nearest( Point{ storage.x - data.shift[0],
+                                       storage.y - data.shift[1],
+                                       storage.z - data.shift[2] },
+                                1 ),
+                       storage );
+    }
+};
+
+
+// Create the multi-color predicates we search the tree with. These are the
+// mesh entities on which we build the level sets.
+template <class LocalMesh, class EntityType>
+struct AccessTraits<
+    Picasso::MultiColorParticleLevelSetPredicateData<LocalMesh, EntityType>,
+    PredicatesTag>
+{
+    using predicate_data =
+        Picasso::MultiColorParticleLevelSetPredicateData<LocalMesh,
+                                                         EntityType>;
+    using entity_type = typename predicate_data::entity_type;
+    using memory_space = typename predicate_data::memory_space;
+    using size_type = typename predicate_data::size_type;
+    static size_type size( const predicate_data& data ) { return data.size; }
+    static KOKKOS_FUNCTION auto get( const predicate_data& data, size_type i )
+    {
+        // Get the entity index.
+        Picasso::ParticleLevelSetPredicateStorage<size_type> storage;
+        data.convertIndexTo3d( i, storage );
+        int index[3] = { storage.i, storage.j, storage.k };
+
+        // Get the coordinates of the entity.
+        double x[3];
+        data.local_mesh.coordinates( entity_type(), index, x );
+        storage.x = x[0];
+        storage.y = x[1];
+        storage.z = x[2];
+
+        // Find all particles within the cutoff of the entity less the common
+        // translation of the particles since the tree was built. Attach the
+        // entity index to use in the callback.
+        return attach( intersects( Sphere{ Point{ storage.x - data.shift[0],
+                                                  storage.y - data.shift[1],
+                                                  storage.z - data.shift[2] },
+                                           data.cutoff } ),
                        storage );
     }
 };
@@ -194,6 +300,344 @@ struct AccessTraits<
 //---------------------------------------------------------------------------//
 namespace Picasso
 {
+//---------------------------------------------------------------------------//
+// Particle distance estimate methods.
+enum class DistanceEstimateMethod
+{
+    // Nearest particle query of a BVH over the particles for every entity.
+    Tree,
+
+    // Search of the particle bins within the narrow band width of each
+    // entity. Entities with no particles in range get the far value.
+    Bins
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class ParticleLevelSetTree
+  \brief BVH over a set of particles used to estimate the signed distance
+  to them with a nearest particle query of each entity, or to the particles
+  of each of a set of colors with a query for the particles within a cutoff
+  of each entity.
+
+  The tree is reused between estimates until it is invalidated or the
+  measured error bound of an estimate with it exceeds the rebuild tolerance.
+*/
+template <class MemorySpace>
+class ParticleLevelSetTree
+{
+  public:
+    using memory_space = MemorySpace;
+
+    // Compute the bounding box of the particle displacements since the tree
+    // was built.
+    template <class ParticlePositions>
+    struct DisplacementBoxReduce
+    {
+        typedef double value_type[];
+        typedef Kokkos::View<int*, MemorySpace> index_view_type;
+        typedef Kokkos::View<double* [3], MemorySpace> position_view_type;
+        typedef typename index_view_type::size_type size_type;
+        size_type value_count;
+
+        ParticlePositions x_p;
+        index_view_type color_indices;
+        position_view_type x_tree;
+
+        DisplacementBoxReduce( const ParticlePositions& x,
+                               const index_view_type& c,
+                               const position_view_type& x_t )
+            : value_count( 6 )
+            , x_p( x )
+            , color_indices( c )
+            , x_tree( x_t )
+        {
+        }
+
+        KOKKOS_FUNCTION
+        void operator()( const size_type n, value_type result ) const
+        {
+            int p = color_indices( n );
+            for ( int d = 0; d < 3; ++d )
+            {
+                double u = x_p( p, d ) - x_tree( n, d );
+                result[d] = fmin( result[d], u );
+                result[d + 3] = fmax( result[d + 3], u );
+            }
+        }
+
+        KOKKOS_FUNCTION
+        void join( volatile value_type dst,
+                   const volatile value_type src ) const
+        {
+            for ( int d = 0; d < 3; ++d )
+            {
+                dst[d] = fmin( dst[d], src[d] );
+                dst[d + 3] = fmax( dst[d + 3], src[d + 3] );
+            }
+        }
+
+        KOKKOS_FUNCTION
+        void init( value_type v ) const
+        {
+            for ( int d = 0; d < 3; ++d )
+            {
+                v[d] = DBL_MAX;
+                v[d + 3] = -DBL_MAX;
+            }
+        }
+    };
+
+    /*!
+      \brief Constructor.
+      \param rebuild_tol The error bound of an estimate above which the tree
+      is rebuilt.
+    */
+    ParticleLevelSetTree( const double rebuild_tol = 0.0 )
+        : _rebuild_tol( rebuild_tol )
+        , _shift( { 0.0, 0.0, 0.0 } )
+        , _displacement( 0.0 )
+        , _valid( false )
+        , _build_count( 0 )
+    {
+    }
+
+    // Invalidate the tree. This is needed any time the set of particles
+    // changes.
+    void invalidate() { _valid = false; }
+
+    /*!
+      \brief Update the tree. The tree is rebuilt if it has been invalidated
+      since it was last built or if the error bound of an estimate with the
+      existing tree exceeds the rebuild tolerance. Otherwise the existing
+      tree is reused.
+
+      The tree bounds the particle positions at the time it was built. A
+      common translation of the particles since then is measured as the
+      center of the bounding box of their displacements and the tree is
+      searched at each entity less that translation. The distance is
+      computed with the current positions so if no particle deviates from
+      the translation by more than d the distance to the nearest particle is
+      overestimated by at most 2d: the particle found is the nearest at the
+      translated build positions and no particle has moved closer than its
+      translated build position by more than d. This bound is available from
+      errorBound() and is zero for a rigid translation.
+
+      \param exec_space The execution space to use for parallel kernels.
+      \param x_p A view or slice of particle positions.
+      \param color_indices The indices of the particles in the tree.
+      \param color_count The number of particles in the tree.
+    */
+    template <class ExecutionSpace, class ParticlePositions>
+    void update( const ExecutionSpace& exec_space,
+                 const ParticlePositions& x_p,
+                 const Kokkos::View<int*, memory_space>& color_indices,
+                 const int color_count )
+    {
+        // Measure the deviation of the particles from their common
+        // translation since the tree was built.
+        if ( _valid )
+        {
+            DisplacementBoxReduce<ParticlePositions> reducer(
+                x_p, color_indices, _x_tree );
+            double box[6];
+            Kokkos::parallel_reduce(
+                "tree_displacement_box",
+                Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                                     color_count ),
+                reducer, box );
+            Kokkos::Array<double, 3> shift;
+            for ( int d = 0; d < 3; ++d )
+                shift[d] = 0.5 * ( box[d] + box[d + 3] );
+
+            auto x_tree = _x_tree;
+            double max_dist_sqr = 0.0;
+            Kokkos::parallel_reduce(
+                "tree_displacement",
+                Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                                     color_count ),
+                KOKKOS_LAMBDA( const int n, double& result ) {
+                    int p = color_indices( n );
+                    double dist_sqr = 0.0;
+                    for ( int d = 0; d < 3; ++d )
+                    {
+                        double dx = x_p( p, d ) - x_tree( n, d ) - shift[d];
+                        dist_sqr += dx * dx;
+                    }
+                    result = ( dist_sqr > result ) ? dist_sqr : result;
+                },
+                Kokkos::Max<double>( max_dist_sqr ) );
+            if ( 2.0 * sqrt( max_dist_sqr ) <= _rebuild_tol )
+            {
+                _shift = shift;
+                _displacement = sqrt( max_dist_sqr );
+                return;
+            }
+        }
+
+        // Build the tree.
+        ParticleLevelSetPrimitiveData<ParticlePositions> primitive_data;
+        primitive_data.x = x_p;
+        primitive_data.c = color_indices;
+        primitive_data.num_color = color_count;
+        _bvh = ArborX::BVH<memory_space>( exec_space, primitive_data );
+
+        // Store the positions the tree was built with.
+        _x_tree = Kokkos::View<double* [3], memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "x_tree" ), color_count );
+        auto x_tree = _x_tree;
+        Kokkos::parallel_for(
+            "store_tree_positions",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, color_count ),
+            KOKKOS_LAMBDA( const int n ) {
+                int p = color_indices( n );
+                for ( int d = 0; d < 3; ++d )
+                    x_tree( n, d ) = x_p( p, d );
+            } );
+
+        _shift = { 0.0, 0.0, 0.0 };
+        _displacement = 0.0;
+        _valid = true;
+        ++_build_count;
+    }
+
+    /*!
+      \brief Update the tree and estimate the signed distance to the
+      particles at each ghosted entity of a local grid from the nearest
+      particle.
+      \param exec_space The execution space to use for parallel kernels.
+      \param x_p A view or slice of particle positions.
+      \param color_indices The indices of the particles in the tree.
+      \param color_count The number of particles in the tree. Must be
+      nonzero.
+      \param local_grid The local grid of the estimate.
+      \param entity The entity type of the estimate.
+      \param radius The particle radius.
+      \param estimate_view The distance estimate view.
+    */
+    template <class ExecutionSpace, class ParticlePositions,
+              class LocalGridType, class EntityType, class EstimateView>
+    void estimate( const ExecutionSpace& exec_space,
+                   const ParticlePositions& x_p,
+                   const Kokkos::View<int*, memory_space>& color_indices,
+                   const int color_count, const LocalGridType& local_grid,
+                   EntityType, const double radius,
+                   const EstimateView& estimate_view )
+    {
+        // Update the tree.
+        update( exec_space, x_p, color_indices, color_count );
+
+        // Particle data.
+        ParticleLevelSetPrimitiveData<ParticlePositions> primitive_data;
+        primitive_data.x = x_p;
+        primitive_data.c = color_indices;
+        primitive_data.num_color = color_count;
+
+        // Make the search predicates.
+        auto local_mesh = Cajita::createLocalMesh<memory_space>( local_grid );
+        ParticleLevelSetPredicateData<decltype( local_mesh ), EntityType>
+            predicate_data( local_mesh, local_grid, shift() );
+
+        // Make the distance callback.
+        ParticleLevelSetCallback<ParticlePositions, EstimateView>
+            distance_callback;
+        distance_callback.primitive_data = primitive_data;
+        distance_callback.distance_estimate = estimate_view;
+        distance_callback.radius = static_cast<float>( radius );
+
+        // Query the particle tree with the mesh entities to find the
+        // closest particle and compute the initial signed distance
+        // estimate.
+        _bvh.query( exec_space, predicate_data, distance_callback );
+    }
+
+    /*!
+      \brief Update the tree and find the squared distance to the nearest
+      particle of each of a set of colors within a cutoff of each ghosted
+      entity of a local grid with one query of the tree.
+
+      The search radius is widened by the deviation of the particles from
+      their common translation since the tree was built so every particle
+      currently within the cutoff is found and the result is exact.
+
+      \param exec_space The execution space to use for parallel kernels.
+      \param x_p A view or slice of particle positions.
+      \param color_indices The indices of the particles in the tree.
+      \param color_slots The index of the color of each particle in the
+      tree.
+      \param color_count The number of particles in the tree. Must be
+      nonzero.
+      \param local_grid The local grid of the estimate.
+      \param entity The entity type of the estimate.
+      \param cutoff The distance beyond which particles are ignored.
+      \param distance_sqr_view The squared distance of each entity and color
+      which must be initialized to the squared cutoff.
+    */
+    template <class ExecutionSpace, class ParticlePositions,
+              class LocalGridType, class EntityType, class DistanceView>
+    void nearestColors( const ExecutionSpace& exec_space,
+                        const ParticlePositions& x_p,
+                        const Kokkos::View<int*, memory_space>& color_indices,
+                        const Kokkos::View<int*, memory_space>& color_slots,
+                        const int color_count, const LocalGridType& local_grid,
+                        EntityType, const double cutoff,
+                        const DistanceView& distance_sqr_view )
+    {
+        // Update the tree.
+        update( exec_space, x_p, color_indices, color_count );
+
+        // Particle data.
+        ParticleLevelSetPrimitiveData<ParticlePositions> primitive_data;
+        primitive_data.x = x_p;
+        primitive_data.c = color_indices;
+        primitive_data.num_color = color_count;
+
+        // Make the search predicates.
+        auto local_mesh = Cajita::createLocalMesh<memory_space>( local_grid );
+        MultiColorParticleLevelSetPredicateData<decltype( local_mesh ),
+                                                EntityType>
+            predicate_data( local_mesh, local_grid, shift(),
+                            static_cast<float>( cutoff + _displacement ) );
+
+        // Make the distance callback.
+        MultiColorParticleLevelSetCallback<ParticlePositions, DistanceView>
+            distance_callback;
+        distance_callback.primitive_data = primitive_data;
+        distance_callback.slot = color_slots;
+        distance_callback.distance_sqr = distance_sqr_view;
+
+        // Query the particle tree once for all colors.
+        _bvh.query( exec_space, predicate_data, distance_callback );
+    }
+
+    // Get the number of times the tree has been built.
+    int buildCount() const { return _build_count; }
+
+    // Get the bound on the distance overestimate of the last estimate due to
+    // particles having moved other than by their common translation since
+    // the tree was built. This is zero if the tree was built for the
+    // estimate.
+    double errorBound() const { return 2.0 * _displacement; }
+
+    // Get the common translation of the particles since the tree was built
+    // in single precision for the tree search.
+    Kokkos::Array<float, 3> shift() const
+    {
+        return { static_cast<float>( _shift[0] ),
+                 static_cast<float>( _shift[1] ),
+                 static_cast<float>( _shift[2] ) };
+    }
+
+  private:
+    ArborX::BVH<memory_space> _bvh;
+    Kokkos::View<double* [3], memory_space> _x_tree;
+    double _rebuild_tol;
+    Kokkos::Array<double, 3> _shift;
+    double _displacement;
+    bool _valid;
+    int _build_count;
+};
+
 //---------------------------------------------------------------------------//
 // Particle level set. Composes a signed distance function for particles of a
 // given color.
@@ -220,15 +664,40 @@ class ParticleLevelSet
     ParticleLevelSet( const boost::property_tree::ptree& ptree,
                       const std::shared_ptr<MeshType>& mesh, const int color )
         : _color( color )
+        , _color_count( 0 )
         , _ls( createLevelSet<SignedDistanceLocation>( ptree, mesh ) )
+        , _particle_mesh( _ls->mesh() == mesh )
     {
         // Extract parameters.
         const auto& params = ptree.get_child( "particle_level_set" );
 
         // Particles have an analytic spherical level set. Get the radius as a
-        // fraction of the cell size.
-        _dx = mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
-        _radius = _dx * params.get<double>( "particle_radius", 0.5 );
+        // fraction of the cell size of the input mesh.
+        double dx = mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
+        _radius = dx * params.get<double>( "particle_radius", 0.5 );
+
+        // Cell size of the level set mesh which may differ from the input
+        // mesh.
+        _dx = _ls->mesh()->localGrid()->globalGrid().globalMesh().cellSize( 0 );
+
+        // The particle tree is reused between estimates until the bound on
+        // the distance overestimate of reusing it exceeds this fraction of
+        // the level set cell size. The default is the interface tolerance of
+        // the Hopf-Lax redistance. A tolerance of zero rebuilds the tree
+        // whenever the particles move other than by a common translation.
+        _tree = ParticleLevelSetTree<memory_space>(
+            _dx * params.get<double>( "tree_rebuild_tolerance",
+                                      _ls->redistanceSecantTol() ) );
+
+        // Get the distance estimate method.
+        auto method = params.get<std::string>( "estimate_method", "tree" );
+        if ( method.compare( "tree" ) == 0 )
+            _estimate_method = DistanceEstimateMethod::Tree;
+        else if ( method.compare( "bins" ) == 0 )
+            _estimate_method = DistanceEstimateMethod::Bins;
+        else
+            throw std::runtime_error( "Unknown distance estimate method: " +
+                                      method );
     }
 
     /*!
@@ -246,6 +715,9 @@ class ParticleLevelSet
     void updateParticleColors( const ExecutionSpace& exec_space,
                                const ParticleColors& c_p )
     {
+        // The particle set changed so the tree must be rebuilt.
+        _tree.invalidate();
+
         // Initialize color indices.
         _color_indices = Kokkos::View<int*, memory_space>(
             Kokkos::ViewAllocateWithoutInitializing( "color_indices" ),
@@ -302,6 +774,28 @@ class ParticleLevelSet
     template <class ExecutionSpace, class ParticlePositions>
     void estimateSignedDistance( const ExecutionSpace& exec_space,
                                  const ParticlePositions& x_p )
+    {
+        estimateSignedDistance( exec_space, x_p,
+                                Kokkos::View<int* [3], memory_space>() );
+    }
+
+    /*!
+      \brief Compute the signed distance function estimate from the current
+      particle locations and cell indices. The bin estimate reuses the cell
+      indices to bin the particles if the level set is built on the particle
+      mesh.
+      \param exec_space The execution space to use for parallel kernels.
+      \param x_p A view or slice of particle positions as above.
+      \param ci_p A view or slice of the local cell index of each particle
+      (e.g. Field::LogicalCellIndex) which must be current with the particle
+      positions. An empty view may be given if the particles have no cell
+      index.
+    */
+    template <class ExecutionSpace, class ParticlePositions,
+              class ParticleCells>
+    void estimateSignedDistance( const ExecutionSpace& exec_space,
+                                 const ParticlePositions& x_p,
+                                 const ParticleCells& ci_p )
     {
         // Distance estimate.
         auto distance_estimate = _ls->getDistanceEstimate();
@@ -309,9 +803,8 @@ class ParticleLevelSet
         // View of the distance estimate.
         auto estimate_view = distance_estimate->view();
 
-        // Local mesh.
+        // Local grid.
         auto local_grid = distance_estimate->layout()->localGrid();
-        auto local_mesh = Cajita::createLocalMesh<memory_space>( *local_grid );
 
         // If we have no particles of the given color on this rank then we are
         // in a region of positive distance. Estimate the signed distance
@@ -325,34 +818,20 @@ class ParticleLevelSet
                                      Cajita::Ghost() );
         }
 
-        // Otherwise we have particles so build a tree from the particles of
-        // the given color and estimate the distance.
+        // Otherwise if we are using bins search the particles near each
+        // entity.
+        else if ( DistanceEstimateMethod::Bins == _estimate_method )
+        {
+            estimateWithBins( exec_space, x_p, ci_p );
+        }
+
+        // Otherwise we have particles so update the tree of particles of the
+        // given color and estimate the distance.
         else
         {
-            // Build the tree
-            ParticleLevelSetPrimitiveData<ParticlePositions> primitive_data;
-            primitive_data.x = x_p;
-            primitive_data.c = _color_indices;
-            primitive_data.num_color = _color_count;
-            ArborX::BVH<memory_space> bvh( exec_space, primitive_data );
-
-            // Make the search predicates.
-            ParticleLevelSetPredicateData<decltype( local_mesh ), entity_type>
-                predicate_data( local_mesh, *local_grid );
-
-            // Make the distance callback.
-            ParticleLevelSetCallback<ParticlePositions,
-                                     decltype( estimate_view )>
-                distance_callback;
-            distance_callback.primitive_data = primitive_data;
-            distance_callback.distance_estimate = estimate_view;
-            distance_callback.radius = static_cast<float>( _radius );
-
-            // Query the particle tree with the mesh entities to find the
-            // closest particle and compute the initial signed distance
-            // estimate. Dummy arguments are needed even though we don't care
-            // about the output.
-            bvh.query( exec_space, predicate_data, distance_callback );
+            _tree.estimate( exec_space, x_p, _color_indices, _color_count,
+                            *local_grid, entity_type(), _radius,
+                            estimate_view );
         }
 
         // Do a reduction to get the minimum distance within the minimum halo
@@ -361,6 +840,180 @@ class ParticleLevelSet
                                  *distance_estimate );
     }
 
+    /*!
+      \brief Update the tree of particles of the given color. See
+      ParticleLevelSetTree::update().
+      \param exec_space The execution space to use for parallel kernels.
+      \param x_p A view or slice of particle positions consistent with the
+      colors provided to the last call to updateParticleColors().
+    */
+    template <class ExecutionSpace, class ParticlePositions>
+    void updateTree( const ExecutionSpace& exec_space,
+                     const ParticlePositions& x_p )
+    {
+        _tree.update( exec_space, x_p, _color_indices, _color_count );
+    }
+
+    /*!
+      \brief Estimate the signed distance by searching the particle bins.
+      Particles of the given color are binned by cell and each entity only
+      searches the bins within the narrow band width of it. Entities with no
+      particle within the narrow band width get the narrow band width as
+      their estimate which is the same value the min-reduce operation would
+      otherwise leave for them.
+      \param exec_space The execution space to use for parallel kernels.
+      \param x_p A view or slice of particle positions consistent with the
+      colors provided to the last call to updateParticleColors().
+      \param ci_p A view or slice of particle cell indices or an empty view.
+    */
+    template <class ExecutionSpace, class ParticlePositions,
+              class ParticleCells>
+    void estimateWithBins( const ExecutionSpace& exec_space,
+                           const ParticlePositions& x_p,
+                           const ParticleCells& ci_p )
+    {
+        // Distance estimate.
+        auto distance_estimate = _ls->getDistanceEstimate();
+        auto estimate_view = distance_estimate->view();
+
+        // Local mesh.
+        auto local_grid = distance_estimate->layout()->localGrid();
+        auto local_mesh = Cajita::createLocalMesh<memory_space>( *local_grid );
+
+        // Gather the positions of the particles of the given color.
+        auto color_indices = _color_indices;
+        Kokkos::View<double* [3], memory_space> x_color(
+            Kokkos::ViewAllocateWithoutInitializing( "x_color" ),
+            _color_count );
+        Kokkos::parallel_for(
+            "gather_color_positions",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, _color_count ),
+            KOKKOS_LAMBDA( const int n ) {
+                int p = color_indices( n );
+                for ( int d = 0; d < 3; ++d )
+                    x_color( n, d ) = x_p( p, d );
+            } );
+
+        // Bin the particles. The particle cell indices index the cells of
+        // the level set mesh only if it is the particle mesh.
+        if ( _particle_mesh && ci_p.size() > 0 )
+        {
+            Kokkos::View<int* [3], memory_space> ci_color(
+                Kokkos::ViewAllocateWithoutInitializing( "ci_color" ),
+                _color_count );
+            Kokkos::parallel_for(
+                "gather_color_cells",
+                Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                                     _color_count ),
+                KOKKOS_LAMBDA( const int n ) {
+                    int p = color_indices( n );
+                    for ( int d = 0; d < 3; ++d )
+                        ci_color( n, d ) = ci_p( p, d );
+                } );
+            _bins.buildFromCellIndex( exec_space, *local_grid, ci_color );
+        }
+        else
+        {
+            _bins.build( exec_space, *local_grid, x_color );
+        }
+
+        // Search the bins within the cutoff of each entity. The cutoff is the
+        // distance at which the estimate reaches the narrow band width.
+        auto bins = _bins;
+        double radius = _radius;
+        double dx = _dx;
+        double cutoff = _dx * local_grid->haloCellWidth() + _radius;
+        int width = static_cast<int>( ceil( cutoff / _dx ) );
+        auto ghost_entities = local_grid->indexSpace(
+            Cajita::Ghost(), entity_type(), Cajita::Local() );
+        Kokkos::parallel_for(
+            "bin_distance_estimate",
+            Cajita::createExecutionPolicy( ghost_entities, exec_space ),
+            KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+                // Get the entity location.
+                int entity_index[3] = { i, j, k };
+                double x[3];
+                local_mesh.coordinates( entity_type(), entity_index, x );
+
+                // Get the bin of the entity.
+                int c[3];
+                bins.locator().cellIndex( x, c );
+
+                // Find the closest particle within the cutoff. Search the
+                // bins in shells of increasing distance from the entity bin.
+                // Particles in shell s are at least s-1 cells away from the
+                // entity so the search stops once that exceeds the closest
+                // distance found.
+                double min_dist_sqr = cutoff * cutoff;
+                for ( int s = 0; s <= width; ++s )
+                {
+                    double shell_dist = ( s - 1 ) * dx;
+                    if ( s > 0 && shell_dist * shell_dist >= min_dist_sqr )
+                        break;
+
+                    // Get the range of bins in the shell.
+                    int c_min[3];
+                    int c_max[3];
+                    for ( int d = 0; d < 3; ++d )
+                    {
+                        c_min[d] = ( c[d] - s > 0 ) ? c[d] - s : 0;
+                        c_max[d] = ( c[d] + s < bins.numBin( d ) - 1 )
+                                       ? c[d] + s
+                                       : bins.numBin( d ) - 1;
+                    }
+
+                    // Search the bins on the shell. Bins inside of the shell
+                    // in I and J only have the K faces of the shell.
+                    for ( int bi = c_min[Dim::I]; bi <= c_max[Dim::I]; ++bi )
+                        for ( int bj = c_min[Dim::J]; bj <= c_max[Dim::J];
+                              ++bj )
+                        {
+                            bool inner = ( bi > c[Dim::I] - s &&
+                                           bi < c[Dim::I] + s &&
+                                           bj > c[Dim::J] - s &&
+                                           bj < c[Dim::J] + s );
+                            int bk_step = ( inner && s > 0 ) ? 2 * s : 1;
+                            for ( int bk = c[Dim::K] - s;
+                                  bk <= c[Dim::K] + s; bk += bk_step )
+                            {
+                                if ( bk < c_min[Dim::K] ||
+                                     bk > c_max[Dim::K] )
+                                    continue;
+                                int offset = bins.binOffset( bi, bj, bk );
+                                int size = bins.binSize( bi, bj, bk );
+                                for ( int n = offset; n < offset + size; ++n )
+                                {
+                                    int p = bins.permutation( n );
+                                    double dist_sqr = 0.0;
+                                    for ( int d = 0; d < 3; ++d )
+                                    {
+                                        double dxp = x_color( p, d ) - x[d];
+                                        dist_sqr += dxp * dxp;
+                                    }
+                                    min_dist_sqr = ( dist_sqr < min_dist_sqr )
+                                                       ? dist_sqr
+                                                       : min_dist_sqr;
+                                }
+                            }
+                        }
+                }
+
+                estimate_view( i, j, k, 0 ) = sqrt( min_dist_sqr ) - radius;
+            } );
+    }
+
+    // Get the distance estimate method.
+    DistanceEstimateMethod estimateMethod() const { return _estimate_method; }
+
+    // Get the number of times the particle tree has been built.
+    int treeBuildCount() const { return _tree.buildCount(); }
+
+    // Get the bound on the distance overestimate of the last tree estimate
+    // due to particles having moved other than by their common translation
+    // since the tree was built. This is zero if the tree was built for the
+    // estimate.
+    double treeErrorBound() const { return _tree.errorBound(); }
+
     // Get the particle radius.
     double particleRadius() const { return _radius; }
 
@@ -373,7 +1026,11 @@ class ParticleLevelSet
     double _dx;
     Kokkos::View<int*, memory_space> _color_indices;
     int _color_count;
+    ParticleLevelSetTree<memory_space> _tree;
+    DistanceEstimateMethod _estimate_method;
+    ParticleBins<memory_space> _bins;
     std::shared_ptr<level_set> _ls;
+    bool _particle_mesh;
 };
 
 //---------------------------------------------------------------------------//
@@ -394,6 +1051,272 @@ createParticleLevelSet( const boost::property_tree::ptree& ptree,
         ptree, mesh, color );
 }
 
+//---------------------------------------------------------------------------//
+// Multi-color particle level set. Composes a signed distance function for
+// each of a set of particle colors from a single tree over the particles of
+// all of the colors.
+template <class MeshType, class SignedDistanceLocation>
+class MultiColorParticleLevelSet
+{
+  public:
+    using mesh_type = MeshType;
+    using memory_space = typename mesh_type::memory_space;
+    using location_type = SignedDistanceLocation;
+    using entity_type = typename location_type::entity_type;
+    using level_set = LevelSet<MeshType, SignedDistanceLocation>;
+
+    /*!
+      \brief Construct the level sets for particles of the given colors.
+      \param ptree Level set settings.
+      \param mesh The mesh over which to build the signed distance functions.
+      \param colors The particle colors over which to build the level sets.
+    */
+    MultiColorParticleLevelSet( const boost::property_tree::ptree& ptree,
+                                const std::shared_ptr<MeshType>& mesh,
+                                const std::vector<int>& colors )
+        : _colors( colors )
+        , _color_count( colors.size(), 0 )
+        , _num_tree_particle( 0 )
+    {
+        // Create a level set for each color. All of the level sets share the
+        // mesh of the first so a mesh with a different level set resolution
+        // is only created once.
+        auto ls_ptree = ptree;
+        for ( std::size_t n = 0; n < _colors.size(); ++n )
+        {
+            _ls.push_back( createLevelSet<SignedDistanceLocation>(
+                ls_ptree, ( 0 == n ) ? mesh : _mesh ) );
+            if ( 0 == n )
+            {
+                _mesh = _ls[0]->mesh();
+                ls_ptree.put( "level_set.cell_size_ratio", 1.0 );
+            }
+        }
+
+        // Extract parameters.
+        const auto& params = ptree.get_child( "particle_level_set" );
+
+        // Particles have an analytic spherical level set. Get the radius as a
+        // fraction of the cell size of the input mesh.
+        double dx = mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
+        _radius = dx * params.get<double>( "particle_radius", 0.5 );
+
+        // Cell size of the level set mesh.
+        _dx = _mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
+
+        // The particle tree over all colors is reused as in the single color
+        // level set. Reusing it widens the search radius by half the error
+        // bound but the estimate stays exact.
+        _tree = ParticleLevelSetTree<memory_space>(
+            _dx * params.get<double>( "tree_rebuild_tolerance",
+                                      _ls[0]->redistanceSecantTol() ) );
+
+        // Copy the colors to the device.
+        _device_colors = Kokkos::View<int*, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "colors" ),
+            _colors.size() );
+        auto colors_host = Kokkos::create_mirror_view( _device_colors );
+        for ( std::size_t n = 0; n < _colors.size(); ++n )
+            colors_host( n ) = _colors[n];
+        Kokkos::deep_copy( _device_colors, colors_host );
+
+        // Squared distance to the nearest particle of each color at each
+        // ghosted entity.
+        auto ghost_entities = _mesh->localGrid()->indexSpace(
+            Cajita::Ghost(), entity_type(), Cajita::Local() );
+        _distance_sqr = Kokkos::View<float****, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "distance_sqr" ),
+            ghost_entities.extent( Dim::I ), ghost_entities.extent( Dim::J ),
+            ghost_entities.extent( Dim::K ), _colors.size() );
+    }
+
+    /*!
+      \brief Update the set of particle indices for the colors we are
+      building the sets for. This operation is needed any time the particle
+      population is updated (e.g. after a redistribution).
+      \param exec_space The execution space to use for parallel kernels.
+      \param c_p A view or slice containing the particle colors. The number
+      and order of particles with respect to these colors must remain
+      consistent in between calls to this function (e.g. in subsequent calls
+      to estimateSignedDistance()).
+    */
+    template <class ExecutionSpace, class ParticleColors>
+    void updateParticleColors( const ExecutionSpace& exec_space,
+                               const ParticleColors& c_p )
+    {
+        // The particle set changed so the tree must be rebuilt.
+        _tree.invalidate();
+
+        // Tag each particle with the index of its color and histogram the
+        // colors.
+        int num_color = _colors.size();
+        auto colors = _device_colors;
+        Kokkos::View<int*, memory_space> particle_slots(
+            Kokkos::ViewAllocateWithoutInitializing( "particle_slots" ),
+            c_p.size() );
+        Kokkos::View<int*, memory_space> histogram( "color_histogram",
+                                                    num_color );
+        Kokkos::parallel_for(
+            "multi_color_histogram",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, c_p.size() ),
+            KOKKOS_LAMBDA( const int p ) {
+                int slot = -1;
+                for ( int n = 0; n < num_color; ++n )
+                    if ( colors( n ) == c_p( p ) )
+                        slot = n;
+                particle_slots( p ) = slot;
+                if ( slot >= 0 )
+                    Kokkos::atomic_increment( &histogram( slot ) );
+            } );
+        auto histogram_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(), histogram );
+        _num_tree_particle = 0;
+        for ( int n = 0; n < num_color; ++n )
+        {
+            _color_count[n] = histogram_host( n );
+            _num_tree_particle += _color_count[n];
+        }
+
+        // Get the index of each particle with one of our colors along with
+        // the index of its color. The compaction preserves the particle
+        // order.
+        _color_indices = Kokkos::View<int*, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "color_indices" ),
+            _num_tree_particle );
+        _color_slots = Kokkos::View<int*, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "color_slots" ),
+            _num_tree_particle );
+        auto color_indices = _color_indices;
+        auto color_slots = _color_slots;
+        Kokkos::parallel_scan(
+            "multi_color_indices",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, c_p.size() ),
+            KOKKOS_LAMBDA( const int p, int& offset, const bool final_pass ) {
+                int slot = particle_slots( p );
+                if ( slot >= 0 )
+                {
+                    if ( final_pass )
+                    {
+                        color_indices( offset ) = p;
+                        color_slots( offset ) = slot;
+                    }
+                    ++offset;
+                }
+            } );
+    }
+
+    /*!
+      \brief Compute the signed distance function estimate of each color
+      from the current particle locations with a single query of the tree
+      over the particles of all colors. Entities with no particle of a color
+      within the minimum halo width of the particle surface get that width
+      as their estimate for the color, which is the value a rank without
+      particles of the color assigns. All the positive values will be
+      correct but the negative values will only have the correct sign until
+      redistanced.
+      \param exec_space The execution space to use for parallel kernels.
+      \param x_p A view or slice of particle positions. If the grid is
+      adaptive these positions must be in the logical frame. The number and
+      order of particles with respect to these positions must be consistent
+      with the colors provided to the last call to updateParticleColors().
+    */
+    template <class ExecutionSpace, class ParticlePositions>
+    void estimateSignedDistance( const ExecutionSpace& exec_space,
+                                 const ParticlePositions& x_p )
+    {
+        auto local_grid = _mesh->localGrid();
+
+        // Find the nearest particle of each color within the cutoff. The
+        // cutoff is the distance at which the estimate reaches the minimum
+        // halo width.
+        double cutoff = _dx * local_grid->haloCellWidth() + _radius;
+        auto distance_sqr = _distance_sqr;
+        Kokkos::deep_copy( exec_space, distance_sqr,
+                           static_cast<float>( cutoff * cutoff ) );
+        if ( _num_tree_particle > 0 )
+            _tree.nearestColors( exec_space, x_p, _color_indices,
+                                 _color_slots, _num_tree_particle,
+                                 *local_grid, entity_type(), cutoff,
+                                 distance_sqr );
+
+        // Assign the estimate of each color and reduce to get the minimum
+        // distance within the minimum halo width.
+        auto ghost_entities = local_grid->indexSpace(
+            Cajita::Ghost(), entity_type(), Cajita::Local() );
+        double radius = _radius;
+        for ( std::size_t n = 0; n < _colors.size(); ++n )
+        {
+            auto distance_estimate = _ls[n]->getDistanceEstimate();
+            auto estimate_view = distance_estimate->view();
+            int slot = n;
+            Kokkos::parallel_for(
+                "multi_color_assign",
+                Cajita::createExecutionPolicy( ghost_entities, exec_space ),
+                KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+                    estimate_view( i, j, k, 0 ) =
+                        sqrt( distance_sqr( i, j, k, slot ) ) - radius;
+                } );
+            _ls[n]->getHalo()->scatter( exec_space,
+                                        Cajita::ScatterReduce::Min(),
+                                        *distance_estimate );
+        }
+    }
+
+    // Get the number of times the particle tree has been built.
+    int treeBuildCount() const { return _tree.buildCount(); }
+
+    // Get the number of local particles of a color.
+    int colorCount( const int n ) const { return _color_count[n]; }
+
+    // Get the particle radius.
+    double particleRadius() const { return _radius; }
+
+    // Get the number of colors.
+    int numColor() const { return _colors.size(); }
+
+    // Get the color of a level set.
+    int color( const int n ) const { return _colors[n]; }
+
+    // Get the level set of a color.
+    std::shared_ptr<level_set> levelSet( const int n ) const
+    {
+        return _ls[n];
+    }
+
+  private:
+    std::shared_ptr<MeshType> _mesh;
+    std::vector<int> _colors;
+    Kokkos::View<int*, memory_space> _device_colors;
+    double _radius;
+    double _dx;
+    Kokkos::View<int*, memory_space> _color_indices;
+    Kokkos::View<int*, memory_space> _color_slots;
+    std::vector<int> _color_count;
+    int _num_tree_particle;
+    ParticleLevelSetTree<memory_space> _tree;
+    Kokkos::View<float****, memory_space> _distance_sqr;
+    std::vector<std::shared_ptr<level_set>> _ls;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Create a multi-color particle level set over particles of the given
+  colors.
+  \param ptree Level set settings.
+  \param mesh The mesh over which to build the signed distance functions.
+  \param colors The particle colors over which to build the level sets.
+*/
+template <class SignedDistanceLocation, class MeshType>
+std::shared_ptr<MultiColorParticleLevelSet<MeshType, SignedDistanceLocation>>
+createMultiColorParticleLevelSet( const boost::property_tree::ptree& ptree,
+                                  const std::shared_ptr<MeshType>& mesh,
+                                  const std::vector<int>& colors )
+{
+    return std::make_shared<
+        MultiColorParticleLevelSet<MeshType, SignedDistanceLocation>>(
+        ptree, mesh, colors );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Picasso
@@ -14,6 +14,7 @@
 
 #include <Picasso_AdaptiveMesh.hpp>
 #include <Picasso_FieldTypes.hpp>
+#include <Picasso_ParticleBins.hpp>
 #include <Picasso_ParticleCommunication.hpp>
 #include <Picasso_UniformMesh.hpp>
 
@@ -34,6 +35,25 @@ struct ParticleTraits
     using member_types = Cabana::MemberTypes<typename FieldTags::data_type...>;
 };
 
+//---------------------------------------------------------------------------//
+// Particle field query. Determines if a field tag is in a list of particle
+// field tags.
+template <class FieldTag, class... FieldTags>
+struct HasField;
+
+template <class FieldTag>
+struct HasField<FieldTag> : public std::false_type
+{
+};
+
+template <class FieldTag, class Type, class... FieldTags>
+struct HasField<FieldTag, Type, FieldTags...>
+    : public std::conditional<std::is_same<FieldTag, Type>::value,
+                              std::true_type,
+                              HasField<FieldTag, FieldTags...>>::type
+{
+};
+
 //---------------------------------------------------------------------------//
 // Particle copy. Wraps a tuple copy of a particle.
 //---------------------------------------------------------------------------//
@@ -216,6 +236,25 @@ get( const ParticleType& particle, FieldTag tag )
         ParticleType::vector_length );
 }
 
+//---------------------------------------------------------------------------//
+// Particle cell index update. Update the cached cell index of a particle
+// after its position has changed. (Works for both Particle and ParticleView)
+template <class ParticleType>
+KOKKOS_INLINE_FUNCTION void updateCellIndex( const CellLocator& locator,
+                                             ParticleType& particle )
+{
+    double x[3];
+    int ijk[3];
+    for ( int d = 0; d < 3; ++d )
+    {
+        x[d] = get( particle, Field::LogicalPosition(), d );
+        ijk[d] = get( particle, Field::LogicalCellIndex(), d );
+    }
+    locator.updateCellIndex( x, ijk );
+    for ( int d = 0; d < 3; ++d )
+        get( particle, Field::LogicalCellIndex(), d ) = ijk[d];
+}
+
 //---------------------------------------------------------------------------//
 // Particle List
 //---------------------------------------------------------------------------//
@@ -242,6 +281,9 @@ class ParticleList
     using particle_view_type =
         ParticleView<aosoa_type::vector_length, FieldTags...>;
 
+    template <class FieldTag>
+    using has_field = HasField<FieldTag, FieldTags...>;
+
     // Default constructor.
     ParticleList( const std::string& label, const std::shared_ptr<Mesh>& mesh )
         : _aosoa( label )
@@ -268,9 +310,89 @@ class ParticleList
             _aosoa, FieldTag::label() );
     }
 
+    // Get a locator for the cells of the local grid. Kernels which update
+    // particle positions use the locator to update the particle cell index.
+    CellLocator cellLocator() const
+    {
+        return CellLocator( *( _mesh->localGrid() ) );
+    }
+
+    // Compute the cell index of all particles from their positions. Only
+    // available if the particles have a LogicalCellIndex field.
+    template <class FieldTag = Field::LogicalCellIndex>
+    std::enable_if_t<has_field<FieldTag>::value> updateCellIndex()
+    {
+        using execution_space = typename memory_space::execution_space;
+        auto locator = cellLocator();
+        auto x_p = this->slice( Field::LogicalPosition() );
+        auto c_p = this->slice( FieldTag() );
+        Kokkos::parallel_for(
+            "update_cell_index",
+            Kokkos::RangePolicy<execution_space>( 0, x_p.size() ),
+            KOKKOS_LAMBDA( const int p ) {
+                double x[3] = { x_p( p, Dim::I ), x_p( p, Dim::J ),
+                                x_p( p, Dim::K ) };
+                int ijk[3];
+                locator.cellIndex( x, ijk );
+                for ( int d = 0; d < 3; ++d )
+                    c_p( p, d ) = ijk[d];
+            } );
+    }
+
+    // Compute the cell index of the particles whose index was invalidated
+    // by a redistribution. Only available if the particles have a
+    // LogicalCellIndex field.
+    template <class FieldTag = Field::LogicalCellIndex>
+    std::enable_if_t<has_field<FieldTag>::value> locateMigratedParticles()
+    {
+        using execution_space = typename memory_space::execution_space;
+        auto locator = cellLocator();
+        auto x_p = this->slice( Field::LogicalPosition() );
+        auto c_p = this->slice( FieldTag() );
+        Kokkos::parallel_for(
+            "locate_migrated_particles",
+            Kokkos::RangePolicy<execution_space>( 0, x_p.size() ),
+            KOKKOS_LAMBDA( const int p ) {
+                if ( c_p( p, Dim::I ) < 0 )
+                {
+                    double x[3] = { x_p( p, Dim::I ), x_p( p, Dim::J ),
+                                    x_p( p, Dim::K ) };
+                    int ijk[3];
+                    locator.cellIndex( x, ijk );
+                    for ( int d = 0; d < 3; ++d )
+                        c_p( p, d ) = ijk[d];
+                }
+            } );
+    }
+
     // Redistribute particles to new owning grids. Return true if the
-    // particles were actually redistributed.
+    // particles were actually redistributed. The particle cell index, if
+    // present, must be kept current with the positions, typically with
+    // updateCellIndex(locator, particle) wherever positions change, and is
+    // used as-is to locate the particles. Only the cell index of particles
+    // which left the owned cells is recomputed after a redistribution.
     bool redistribute( const bool force_redistribute = false )
+    {
+        return redistributeImpl( force_redistribute,
+                                 has_field<Field::LogicalCellIndex>() );
+    }
+
+  private:
+    // Redistribute particles located by their cell index.
+    bool redistributeImpl( const bool force_redistribute, std::true_type )
+    {
+        bool redistributed = ParticleCommunication::redistribute(
+            *( _mesh->localGrid() ), _mesh->minimumHaloWidth(),
+            this->slice( Field::LogicalPosition() ),
+            this->slice( Field::LogicalCellIndex() ), _aosoa,
+            force_redistribute );
+        if ( redistributed )
+            locateMigratedParticles();
+        return redistributed;
+    }
+
+    // Redistribute particles located by their position.
+    bool redistributeImpl( const bool force_redistribute, std::false_type )
     {
         return ParticleCommunication::redistribute(
             *( _mesh->localGrid() ), _mesh->minimumHaloWidth(),
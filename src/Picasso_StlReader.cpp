@@ -0,0 +1,693 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Picasso_BroadcastFile.hpp>
+#include <Picasso_StlReader.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Picasso
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+// Read-only memory map of a file.
+class MappedFile
+{
+  public:
+    explicit MappedFile( const std::string& filename )
+        : _fd( -1 )
+        , _data( nullptr )
+        , _size( 0 )
+    {
+        _fd = open( filename.c_str(), O_RDONLY );
+        if ( _fd < 0 )
+            throw std::runtime_error( "Unable to open STL file " + filename );
+
+        struct stat file_stat;
+        if ( fstat( _fd, &file_stat ) != 0 )
+        {
+            close( _fd );
+            throw std::runtime_error( "Unable to stat STL file " + filename );
+        }
+        _size = file_stat.st_size;
+
+        // Empty files can not be mapped.
+        if ( _size > 0 )
+        {
+            void* data = mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0 );
+            if ( MAP_FAILED == data )
+            {
+                close( _fd );
+                throw std::runtime_error( "Unable to map STL file " +
+                                          filename );
+            }
+            _data = static_cast<const char*>( data );
+        }
+    }
+
+    ~MappedFile()
+    {
+        if ( _data )
+            munmap( const_cast<char*>( _data ), _size );
+        close( _fd );
+    }
+
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+    const char* data() const { return _data; }
+
+    std::size_t size() const { return _size; }
+
+  private:
+    int _fd;
+    const char* _data;
+    std::size_t _size;
+};
+
+//---------------------------------------------------------------------------//
+// Solid kinds. Continue indicates a segment of a chunk that continues the
+// solid of the previous chunk.
+enum SolidKind
+{
+    Continue = -1,
+    Volume = 0,
+    Surface = 1,
+    NoSolid = 2
+};
+
+//---------------------------------------------------------------------------//
+// Part of a chunk of an ASCII file within a single solid.
+struct StlSegment
+{
+    int kind;
+    int id;
+    int num_facet;
+    int num_vertex;
+    std::size_t offset;
+};
+
+//---------------------------------------------------------------------------//
+// Character classes.
+inline bool isSpace( const char c )
+{
+    return ' ' == c || '\t' == c || '\r' == c || '\n' == c || '\0' == c;
+}
+
+inline bool isDigit( const char c ) { return c >= '0' && c <= '9'; }
+
+//---------------------------------------------------------------------------//
+// Skip whitespace within a line.
+inline const char* skipSpace( const char* p, const char* end )
+{
+    while ( p < end && isSpace( *p ) )
+        ++p;
+    return p;
+}
+
+//---------------------------------------------------------------------------//
+// Get the end of the token starting at p.
+inline const char* tokenEnd( const char* p, const char* end )
+{
+    while ( p < end && !isSpace( *p ) )
+        ++p;
+    return p;
+}
+
+//---------------------------------------------------------------------------//
+// Get the end of the line starting at p. This is the position of the newline
+// or the end of the buffer.
+inline const char* lineEnd( const char* p, const char* end )
+{
+    auto n = static_cast<const char*>( std::memchr( p, '\n', end - p ) );
+    return n ? n : end;
+}
+
+//---------------------------------------------------------------------------//
+// Check if the token [p,q) is the given keyword.
+inline bool isToken( const char* p, const char* q, const char* keyword )
+{
+    std::size_t length = std::strlen( keyword );
+    return static_cast<std::size_t>( q - p ) == length &&
+           0 == std::strncmp( p, keyword, length );
+}
+
+//---------------------------------------------------------------------------//
+// Count the tokens in [p,end).
+inline int countTokens( const char* p, const char* end )
+{
+    int count = 0;
+    p = skipSpace( p, end );
+    while ( p < end )
+    {
+        ++count;
+        p = skipSpace( tokenEnd( p, end ), end );
+    }
+    return count;
+}
+
+//---------------------------------------------------------------------------//
+// Parse an integer token without allocation. Returns false if the token is
+// not an integer.
+inline bool parseInt( const char*& p, const char* end, int& value )
+{
+    p = skipSpace( p, end );
+    bool negative = false;
+    if ( p < end && ( '-' == *p || '+' == *p ) )
+    {
+        negative = ( '-' == *p );
+        ++p;
+    }
+    if ( p == end || !isDigit( *p ) )
+        return false;
+    value = 0;
+    while ( p < end && isDigit( *p ) )
+    {
+        value = 10 * value + ( *p - '0' );
+        ++p;
+    }
+    if ( negative )
+        value = -value;
+    return ( p == end || isSpace( *p ) );
+}
+
+//---------------------------------------------------------------------------//
+// Parse a floating point token without allocation. Returns false if the
+// token is not a number. Powers of ten up to 22 are exact in double
+// precision so for typical STL values the result is correctly rounded.
+inline bool parseFloat( const char*& p, const char* end, float& value )
+{
+    static const double pow10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                    1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                    1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    p = skipSpace( p, end );
+
+    // Sign.
+    bool negative = false;
+    if ( p < end && ( '-' == *p || '+' == *p ) )
+    {
+        negative = ( '-' == *p );
+        ++p;
+    }
+
+    // Mantissa. Digits beyond what fits in the integer only scale it.
+    std::uint64_t mantissa = 0;
+    int exponent = 0;
+    int num_digit = 0;
+    bool has_digit = false;
+    while ( p < end && isDigit( *p ) )
+    {
+        has_digit = true;
+        if ( num_digit < 19 )
+        {
+            mantissa = 10 * mantissa + ( *p - '0' );
+            num_digit += ( mantissa > 0 );
+        }
+        else
+        {
+            ++exponent;
+        }
+        ++p;
+    }
+    if ( p < end && '.' == *p )
+    {
+        ++p;
+        while ( p < end && isDigit( *p ) )
+        {
+            has_digit = true;
+            if ( num_digit < 19 )
+            {
+                mantissa = 10 * mantissa + ( *p - '0' );
+                num_digit += ( mantissa > 0 );
+                --exponent;
+            }
+            ++p;
+        }
+    }
+    if ( !has_digit )
+        return false;
+
+    // Exponent.
+    if ( p < end && ( 'e' == *p || 'E' == *p ) )
+    {
+        const char* q = p + 1;
+        int e = 0;
+        if ( parseInt( q, end, e ) )
+        {
+            exponent += e;
+            p = q;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // Scale.
+    double v = static_cast<double>( mantissa );
+    if ( exponent < 0 )
+        v /= ( exponent >= -22 ) ? pow10[-exponent]
+                                 : std::pow( 10.0, -exponent );
+    else if ( exponent > 0 )
+        v *= ( exponent <= 22 ) ? pow10[exponent] : std::pow( 10.0, exponent );
+    value = static_cast<float>( negative ? -v : v );
+
+    return ( p == end || isSpace( *p ) );
+}
+
+//---------------------------------------------------------------------------//
+// Parse the name and id of a solid from the tokens in [p,end) following the
+// solid keyword. Returns false if the tokens do not name a solid.
+inline bool parseSolidName( const char* p, const char* end, int& kind,
+                            int& id )
+{
+    p = skipSpace( p, end );
+    const char* q = tokenEnd( p, end );
+    if ( isToken( p, q, "Volume" ) || isToken( p, q, "Body" ) )
+        kind = Volume;
+    else if ( isToken( p, q, "Surface" ) )
+        kind = Surface;
+    else
+        return false;
+    return parseInt( q, end, id );
+}
+
+//---------------------------------------------------------------------------//
+// Check if the line starting at p begins a facet or a solid. Chunks of an
+// ASCII file are only split at these lines.
+inline bool isChunkBoundary( const char* p, const char* end )
+{
+    p = skipSpace( p, lineEnd( p, end ) );
+    const char* q = tokenEnd( p, end );
+    return isToken( p, q, "facet" ) || isToken( p, q, "solid" ) ||
+           isToken( p, q, "endsolid" );
+}
+
+//---------------------------------------------------------------------------//
+// Find the first chunk boundary at or after the given position.
+std::size_t findChunkBoundary( const char* buffer, const std::size_t size,
+                               const std::size_t position )
+{
+    const char* end = buffer + size;
+    const char* p = buffer + position;
+
+    // Move to the start of a line.
+    if ( p > buffer && '\n' != *( p - 1 ) )
+    {
+        p = lineEnd( p, end );
+        p = ( p < end ) ? p + 1 : end;
+    }
+
+    // Find the next line which starts a facet or a solid.
+    while ( p < end && !isChunkBoundary( p, end ) )
+    {
+        p = lineEnd( p, end );
+        p = ( p < end ) ? p + 1 : end;
+    }
+    return p - buffer;
+}
+
+//---------------------------------------------------------------------------//
+// Count the facets and vertices of the solids in a chunk.
+void countChunk( const char* begin, const char* end,
+                 std::vector<StlSegment>& segments, std::string& error )
+{
+    segments.push_back( { Continue, 0, 0, 0, 0 } );
+    for ( const char* line = begin; line < end; )
+    {
+        const char* line_end = lineEnd( line, end );
+        const char* p = skipSpace( line, line_end );
+        const char* q = tokenEnd( p, line_end );
+
+        // New solid.
+        if ( isToken( p, q, "solid" ) )
+        {
+            if ( countTokens( line, line_end ) != 3 )
+            {
+                error = "STL READER: Expected 3 solid line entries";
+                return;
+            }
+            int kind;
+            int id;
+            if ( !parseSolidName( q, line_end, kind, id ) )
+            {
+                error = "STL READER: Solids execpted to be Volume/Body or "
+                        "Surface";
+                return;
+            }
+            segments.push_back( { kind, id, 0, 0, 0 } );
+        }
+
+        // Finish reading a solid.
+        else if ( isToken( p, q, "endsolid" ) )
+        {
+            segments.push_back( { NoSolid, 0, 0, 0, 0 } );
+        }
+
+        // Read facet.
+        else if ( isToken( p, q, "facet" ) )
+        {
+            if ( countTokens( line, line_end ) != 5 )
+            {
+                error = "STL READER: Expected 5 facet line entries";
+                return;
+            }
+            ++segments.back().num_facet;
+        }
+
+        // Read vertex.
+        else if ( isToken( p, q, "vertex" ) )
+        {
+            if ( countTokens( line, line_end ) != 4 )
+            {
+                error = "STL READER: Expected 4 vertex line entries";
+                return;
+            }
+            ++segments.back().num_vertex;
+        }
+
+        line = ( line_end < end ) ? line_end + 1 : end;
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Write the vertices of the solids in a chunk into their final location.
+void fillChunk( const char* begin, const char* end,
+                const std::vector<StlSegment>& segments, StlData& data,
+                std::string& error )
+{
+    std::size_t s = 0;
+    float* cursor = nullptr;
+    auto start_segment = [&]() {
+        const auto& segment = segments[s];
+        if ( Volume == segment.kind )
+            cursor = data.volume_facets.data() + segment.offset;
+        else if ( Surface == segment.kind )
+            cursor = data.surface_facets.data() + segment.offset;
+        else
+            cursor = nullptr;
+    };
+    start_segment();
+
+    for ( const char* line = begin; line < end; )
+    {
+        const char* line_end = lineEnd( line, end );
+        const char* p = skipSpace( line, line_end );
+        const char* q = tokenEnd( p, line_end );
+
+        // Each solid line starts a new segment.
+        if ( isToken( p, q, "solid" ) || isToken( p, q, "endsolid" ) )
+        {
+            ++s;
+            start_segment();
+        }
+
+        // Read the vertex coordinates.
+        else if ( cursor && isToken( p, q, "vertex" ) )
+        {
+            for ( int d = 0; d < 3; ++d )
+            {
+                if ( !parseFloat( q, line_end, cursor[d] ) )
+                {
+                    error = "STL READER: Invalid vertex coordinate";
+                    return;
+                }
+            }
+            cursor += 3;
+        }
+
+        line = ( line_end < end ) ? line_end + 1 : end;
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end anonymous namespace
+
+//---------------------------------------------------------------------------//
+// Get the STL format from its input name.
+StlFormat stlFormat( const std::string& name )
+{
+    if ( 0 == name.compare( "auto" ) )
+        return StlFormat::Auto;
+    else if ( 0 == name.compare( "ascii" ) )
+        return StlFormat::Ascii;
+    else if ( 0 == name.compare( "binary" ) )
+        return StlFormat::Binary;
+    else
+        throw std::runtime_error( "Unknown STL format: " + name );
+}
+
+//---------------------------------------------------------------------------//
+// Read an STL file.
+void readStl( const std::string& filename, const StlFormat format,
+              StlData& data )
+{
+    MappedFile file( filename );
+    bool binary = ( StlFormat::Binary == format ) ||
+                  ( StlFormat::Auto == format &&
+                    isBinaryStl( file.data(), file.size() ) );
+    if ( binary )
+        readBinaryStl( file.data(), file.size(), data );
+    else
+        readAsciiStl( file.data(), file.size(), data );
+}
+
+//---------------------------------------------------------------------------//
+// Read an STL file on the first rank and parse it on all ranks.
+void readStl( const std::string& filename, const StlFormat format,
+              StlData& data, MPI_Comm comm )
+{
+    std::vector<char> contents;
+    if ( !broadcastFile( filename, comm, contents ) )
+        throw std::runtime_error( "Unable to read STL file " + filename );
+    bool binary = ( StlFormat::Binary == format ) ||
+                  ( StlFormat::Auto == format &&
+                    isBinaryStl( contents.data(), contents.size() ) );
+    if ( binary )
+        readBinaryStl( contents.data(), contents.size(), data );
+    else
+        readAsciiStl( contents.data(), contents.size(), data );
+}
+
+//---------------------------------------------------------------------------//
+// Hash the contents of an STL file.
+std::uint64_t stlFileHash( const std::string& filename )
+{
+    MappedFile file( filename );
+    return stlHash( file.data(), file.size() );
+}
+
+//---------------------------------------------------------------------------//
+// Hash a buffer of STL data with 64-bit FNV-1a.
+std::uint64_t stlHash( const char* buffer, const std::size_t size )
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        hash ^= static_cast<unsigned char>( buffer[i] );
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+//---------------------------------------------------------------------------//
+// Determine if a buffer holds binary STL data.
+bool isBinaryStl( const char* buffer, const std::size_t size )
+{
+    std::size_t position = 0;
+    while ( position + 84 <= size )
+    {
+        std::uint32_t num_facet;
+        std::memcpy( &num_facet, buffer + position + 80, 4 );
+        position += 84 + 50 * static_cast<std::size_t>( num_facet );
+    }
+    return ( size > 0 && position == size );
+}
+
+//---------------------------------------------------------------------------//
+// Parse ASCII STL data.
+void readAsciiStl( const char* buffer, const std::size_t size,
+                   StlData& data )
+{
+    using host_exec = Kokkos::DefaultHostExecutionSpace;
+
+    // Split the buffer into chunks at facet and solid boundaries. Use a few
+    // chunks per thread for load balance but keep them large enough that
+    // finding the boundaries is negligible.
+    std::size_t min_chunk_size = 1 << 16;
+    int num_chunk = std::max(
+        1, static_cast<int>( std::min<std::size_t>(
+               4 * host_exec().concurrency(), size / min_chunk_size ) ) );
+    std::vector<std::size_t> bounds( num_chunk + 1 );
+    bounds[0] = 0;
+    bounds[num_chunk] = size;
+    Kokkos::parallel_for(
+        "stl_chunk_bounds", Kokkos::RangePolicy<host_exec>( 1, num_chunk ),
+        [&]( const int c ) {
+            bounds[c] =
+                findChunkBoundary( buffer, size, c * ( size / num_chunk ) );
+        } );
+    for ( int c = 1; c <= num_chunk; ++c )
+        bounds[c] = std::max( bounds[c], bounds[c - 1] );
+
+    // Count the facets in each chunk.
+    std::vector<std::vector<StlSegment>> segments( num_chunk );
+    std::vector<std::string> errors( num_chunk );
+    Kokkos::parallel_for(
+        "stl_count", Kokkos::RangePolicy<host_exec>( 0, num_chunk ),
+        [&]( const int c ) {
+            countChunk( buffer + bounds[c], buffer + bounds[c + 1],
+                        segments[c], errors[c] );
+        } );
+    for ( const auto& error : errors )
+        if ( !error.empty() )
+            throw std::runtime_error( error );
+
+    // Assign each segment to a solid and compute the offset of its vertices
+    // in the output. Facets outside of a solid are ignored.
+    int kind = NoSolid;
+    std::size_t volume_size = data.volume_facets.size();
+    std::size_t surface_size = data.surface_facets.size();
+    for ( auto& chunk_segments : segments )
+    {
+        for ( auto& segment : chunk_segments )
+        {
+            if ( Continue == segment.kind )
+            {
+                segment.kind = kind;
+            }
+            else
+            {
+                kind = segment.kind;
+                if ( Volume == kind )
+                {
+                    data.volume_ids.push_back( segment.id );
+                    data.volume_facet_count.push_back( 0 );
+                }
+                else if ( Surface == kind )
+                {
+                    data.surface_ids.push_back( segment.id );
+                    data.surface_facet_count.push_back( 0 );
+                }
+            }
+
+            if ( NoSolid != kind &&
+                 segment.num_vertex != 3 * segment.num_facet )
+                throw std::runtime_error(
+                    "STL READER: Expected 3 vertices per facet" );
+
+            if ( Volume == kind )
+            {
+                segment.offset = volume_size;
+                volume_size += 3 * segment.num_vertex;
+                data.volume_facet_count.back() += segment.num_facet;
+            }
+            else if ( Surface == kind )
+            {
+                segment.offset = surface_size;
+                surface_size += 3 * segment.num_vertex;
+                data.surface_facet_count.back() += segment.num_facet;
+            }
+        }
+    }
+
+    // Allocate and fill the vertices.
+    data.volume_facets.resize( volume_size );
+    data.surface_facets.resize( surface_size );
+    Kokkos::parallel_for(
+        "stl_fill", Kokkos::RangePolicy<host_exec>( 0, num_chunk ),
+        [&]( const int c ) {
+            fillChunk( buffer + bounds[c], buffer + bounds[c + 1],
+                       segments[c], data, errors[c] );
+        } );
+    for ( const auto& error : errors )
+        if ( !error.empty() )
+            throw std::runtime_error( error );
+}
+
+//---------------------------------------------------------------------------//
+// Parse binary STL data.
+void readBinaryStl( const char* buffer, const std::size_t size,
+                    StlData& data )
+{
+    using host_exec = Kokkos::DefaultHostExecutionSpace;
+
+    if ( !isBinaryStl( buffer, size ) )
+        throw std::runtime_error( "STL READER: Invalid binary STL data" );
+
+    std::size_t position = 0;
+    for ( int block = 0; position < size; ++block )
+    {
+        // Get the solid from the header. The header is padded with nulls.
+        const char* header = buffer + position;
+        const char* header_end = header;
+        while ( header_end < header + 80 && '\0' != *header_end )
+            ++header_end;
+        const char* p = skipSpace( header, header_end );
+        const char* q = tokenEnd( p, header_end );
+        if ( isToken( p, q, "solid" ) )
+            p = q;
+        int kind;
+        int id;
+        if ( !parseSolidName( p, header_end, kind, id ) )
+        {
+            kind = Volume;
+            id = block + 1;
+        }
+
+        // Get the facets.
+        std::uint32_t num_facet;
+        std::memcpy( &num_facet, header + 80, 4 );
+        const char* facets = header + 84;
+        auto& ids = ( Volume == kind ) ? data.volume_ids : data.surface_ids;
+        auto& counts = ( Volume == kind ) ? data.volume_facet_count
+                                          : data.surface_facet_count;
+        auto& vertices =
+            ( Volume == kind ) ? data.volume_facets : data.surface_facets;
+        ids.push_back( id );
+        counts.push_back( num_facet );
+
+        // Copy the vertices. Each facet record is the normal, the three
+        // vertices, and a 2 byte attribute.
+        std::size_t offset = vertices.size();
+        vertices.resize( offset + 9 * static_cast<std::size_t>( num_facet ) );
+        float* output = vertices.data() + offset;
+        Kokkos::parallel_for(
+            "stl_binary_fill",
+            Kokkos::RangePolicy<host_exec>( 0, num_facet ),
+            [=]( const int f ) {
+                std::size_t n = f;
+                std::memcpy( output + 9 * n, facets + 50 * n + 12,
+                             9 * sizeof( float ) );
+            } );
+
+        position += 84 + 50 * static_cast<std::size_t>( num_facet );
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
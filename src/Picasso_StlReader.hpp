@@ -0,0 +1,146 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef PICASSO_STLREADER_HPP
+#define PICASSO_STLREADER_HPP
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Picasso
+{
+//---------------------------------------------------------------------------//
+// STL file formats.
+enum class StlFormat
+{
+    // Detect the format from the file contents.
+    Auto,
+
+    // ASCII STL.
+    Ascii,
+
+    // Binary STL.
+    Binary
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Facet data read from an STL file.
+
+  The file is composed of solids named "Volume <id>", "Body <id>", or
+  "Surface <id>". The vertices of each facet are stored as 9 floats in the
+  order the facets appear in the file and the facets of each solid are
+  contiguous.
+*/
+struct StlData
+{
+    // Global ids of the volumes.
+    std::vector<int> volume_ids;
+
+    // Number of facets in each volume.
+    std::vector<int> volume_facet_count;
+
+    // Volume facet vertices.
+    std::vector<float> volume_facets;
+
+    // Global ids of the surfaces.
+    std::vector<int> surface_ids;
+
+    // Number of facets in each surface.
+    std::vector<int> surface_facet_count;
+
+    // Surface facet vertices.
+    std::vector<float> surface_facets;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Get the STL format from its input name: "auto", "ascii", or
+  "binary".
+*/
+StlFormat stlFormat( const std::string& name );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read an STL file. The file is memory-mapped and parsed in parallel
+  with the default host execution space.
+  \param filename The STL file name.
+  \param format The file format.
+  \param data The facet data read from the file.
+*/
+void readStl( const std::string& filename, const StlFormat format,
+              StlData& data );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read an STL file on the first rank of a communicator and broadcast
+  its contents. Every rank parses the contents in parallel with the default
+  host execution space.
+  \param filename The STL file name.
+  \param format The file format.
+  \param data The facet data read from the file.
+  \param comm The communicator.
+*/
+void readStl( const std::string& filename, const StlFormat format,
+              StlData& data, MPI_Comm comm );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Hash the contents of an STL file. Used to detect when data derived
+  from the file is out of date.
+*/
+std::uint64_t stlFileHash( const std::string& filename );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Hash a buffer of STL data. This is the hash of a file with the same
+  contents as the buffer.
+*/
+std::uint64_t stlHash( const char* buffer, const std::size_t size );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Determine if a buffer holds binary STL data. Binary STL is one or
+  more concatenated blocks of an 80 byte header, a 4 byte facet count, and
+  50 bytes per facet. The buffer is binary if its blocks exactly span it.
+*/
+bool isBinaryStl( const char* buffer, const std::size_t size );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Parse ASCII STL data. The buffer is split into chunks at facet and
+  solid boundaries which are parsed in parallel. Each chunk is parsed once
+  to count its facets and once more to write its vertices directly into
+  their final location in the output.
+*/
+void readAsciiStl( const char* buffer, const std::size_t size,
+                   StlData& data );
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Parse binary STL data. Each block is a solid named by its header in
+  the same way as an ASCII solid line (e.g. "solid Volume 3" or
+  "Surface 2"). A block with a header that does not name a solid is read as
+  a volume with an id of one more than the index of the block. Data is
+  assumed to be little-endian.
+*/
+void readBinaryStl( const char* buffer, const std::size_t size,
+                    StlData& data );
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
+
+#endif // end PICASSO_STLREADER_HPP
@@ -175,6 +175,86 @@ class UniformMesh
         _local_grid = Cajita::createLocalGrid( global_grid, halo_cell_width );
     }
 
+    // Construct a mesh over the same domain as another mesh with the cell
+    // size scaled by the given ratio. Ratios greater than one coarsen the
+    // mesh and ratios less than one refine it. Either the ratio or its
+    // inverse must be an integer. The new mesh has the same domain
+    // decomposition as the other mesh such that each rank owns the same
+    // region of space in both meshes.
+    UniformMesh( const UniformMesh& mesh, const double cell_size_ratio,
+                 const int minimum_halo_cell_width )
+        : _minimum_halo_width( minimum_halo_cell_width )
+    {
+        const auto& global_grid = mesh.localGrid()->globalGrid();
+        const auto& global_mesh = global_grid.globalMesh();
+
+        // Get the integer refinement or coarsening factor.
+        bool coarsen = ( cell_size_ratio >= 1.0 );
+        double factor = coarsen ? cell_size_ratio : 1.0 / cell_size_ratio;
+        if ( std::abs( factor - std::rint( factor ) ) >
+             std::numeric_limits<float>::epsilon() )
+            throw std::logic_error(
+                "Cell size ratio or its inverse must be an integer" );
+        int n = std::rint( factor );
+
+        // Scale the number of cells over the same global bounds. The bounds
+        // already include any padding of non-periodic dimensions.
+        std::array<int, 3> global_num_cell;
+        std::array<double, 3> global_low_corner;
+        std::array<double, 3> global_high_corner;
+        std::array<bool, 3> periodic;
+        std::array<int, 3> ranks_per_dim;
+        for ( int d = 0; d < 3; ++d )
+        {
+            int num_cell = global_grid.globalNumEntity( Cajita::Cell(), d );
+            if ( coarsen && num_cell % n != 0 )
+                throw std::logic_error(
+                    "Number of cells not evenly divisible by cell size ratio" );
+            global_num_cell[d] = coarsen ? num_cell / n : num_cell * n;
+            global_low_corner[d] = global_mesh.lowCorner( d );
+            global_high_corner[d] = global_mesh.highCorner( d );
+            periodic[d] = global_grid.isPeriodic( d );
+            ranks_per_dim[d] = global_grid.dimNumBlock( d );
+        }
+
+        // Create the global mesh.
+        auto scaled_global_mesh = Cajita::createUniformGlobalMesh(
+            global_low_corner, global_high_corner, global_num_cell );
+
+        // Build the global grid with the same rank layout.
+        Cajita::ManualPartitioner partitioner( ranks_per_dim );
+        auto scaled_global_grid =
+            Cajita::createGlobalGrid( global_grid.comm(), scaled_global_mesh,
+                                      periodic, partitioner );
+
+        // Check that each rank owns the same region of space in both meshes.
+        // The partitioner only guarantees this when the number of cells owned
+        // by each rank is divisible by the factor.
+        int aligned = 1;
+        for ( int d = 0; d < 3; ++d )
+        {
+            int offset = global_grid.globalOffset( d );
+            int owned = global_grid.ownedNumCell( d );
+            int scaled_offset = scaled_global_grid->globalOffset( d );
+            int scaled_owned = scaled_global_grid->ownedNumCell( d );
+            if ( coarsen )
+                aligned = aligned && ( offset == n * scaled_offset ) &&
+                          ( owned == n * scaled_owned );
+            else
+                aligned = aligned && ( n * offset == scaled_offset ) &&
+                          ( n * owned == scaled_owned );
+        }
+        MPI_Allreduce( MPI_IN_PLACE, &aligned, 1, MPI_INT, MPI_MIN,
+                       global_grid.comm() );
+        if ( !aligned )
+            throw std::logic_error(
+                "Scaled mesh decomposition not aligned with mesh" );
+
+        // Build the local grid.
+        _local_grid =
+            Cajita::createLocalGrid( scaled_global_grid, _minimum_halo_width );
+    }
+
     // Get the minimum required number of cells in the halo.
     int minimumHaloWidth() const { return _minimum_halo_width; }
 
@@ -221,6 +301,17 @@ auto createUniformMesh( MemorySpace, const boost::property_tree::ptree& ptree,
         ptree, global_bounding_box, minimum_halo_cell_width, comm );
 }
 
+//---------------------------------------------------------------------------//
+// Creation function for a mesh with a scaled cell size.
+template <class MemorySpace>
+auto createUniformMesh( const UniformMesh<MemorySpace>& mesh,
+                        const double cell_size_ratio,
+                        const int minimum_halo_cell_width )
+{
+    return std::make_shared<UniformMesh<MemorySpace>>(
+        mesh, cell_size_ratio, minimum_halo_cell_width );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Picasso
@@ -0,0 +1,243 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef PICASSO_VOLUMEIDFIELD_HPP
+#define PICASSO_VOLUMEIDFIELD_HPP
+
+#include <Picasso_FacetGeometry.hpp>
+#include <Picasso_FieldManager.hpp>
+#include <Picasso_FieldTypes.hpp>
+#include <Picasso_Types.hpp>
+#include <Picasso_UniformMesh.hpp>
+
+#include <Cajita.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+#include <type_traits>
+
+namespace Picasso
+{
+//---------------------------------------------------------------------------//
+/*
+  Voxelized volume ids. Each local cell of a mesh is classified against the
+  volumes of a facet geometry and the result is stored in the cell volume id
+  field of a field manager. A cell that no volume facet passes through is
+  entirely in one volume, the implicit complement, or outside the domain and
+  stores the id given by FacetGeometryOps::locatePoint for its center. A cell
+  that a volume facet passes through is cut and points in it must be located
+  with the facets.
+*/
+//---------------------------------------------------------------------------//
+// Volume id of cells cut by a volume facet.
+enum VolumeIdCellValue
+{
+    CutCell = -3
+};
+
+//---------------------------------------------------------------------------//
+// Mark the local cells overlapped by the padded bounding box of each facet as
+// cut.
+template <class ExecutionSpace, class FacetView, class VolumeIdView>
+void markCutCells( const ExecutionSpace& exec_space, const FacetView& facets,
+                   const VolumeIdView& volume_id,
+                   const Kokkos::Array<double, 3>& low,
+                   const Kokkos::Array<int, 3>& num_cell, const double inv_dx,
+                   const double pad )
+{
+    Kokkos::parallel_for(
+        "volume_id_cut_cells",
+        Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0,
+                                             facets.extent( 0 ) ),
+        KOKKOS_LAMBDA( const int f ) {
+            int begin[3];
+            int end[3];
+            for ( int d = 0; d < 3; ++d )
+            {
+                double f_min = fmin( facets( f, 0, d ),
+                                     fmin( facets( f, 1, d ),
+                                           facets( f, 2, d ) ) );
+                double f_max = fmax( facets( f, 0, d ),
+                                     fmax( facets( f, 1, d ),
+                                           facets( f, 2, d ) ) );
+                begin[d] = floor( ( f_min - pad - low[d] ) * inv_dx );
+                end[d] = floor( ( f_max + pad - low[d] ) * inv_dx ) + 1;
+                begin[d] = ( begin[d] < 0 ) ? 0 : begin[d];
+                end[d] = ( end[d] < num_cell[d] ) ? end[d] : num_cell[d];
+            }
+            for ( int i = begin[Dim::I]; i < end[Dim::I]; ++i )
+                for ( int j = begin[Dim::J]; j < end[Dim::J]; ++j )
+                    for ( int k = begin[Dim::K]; k < end[Dim::K]; ++k )
+                        volume_id( i, j, k, 0 ) = CutCell;
+        } );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Classify the local cells of a uniform mesh against the volumes of a
+  facet geometry and store the result in the cell volume id field. The field
+  is added to the field manager if it does not exist. Ghost cells are
+  classified directly so no halo exchange is needed.
+  \param exec_space The execution space to use for parallel kernels.
+  \param geometry The facet geometry to classify against.
+  \param fm The field manager of the mesh.
+*/
+template <class ExecutionSpace, class MemorySpace, class Mesh>
+void classifyVolumeId( const ExecutionSpace& exec_space,
+                       const FacetGeometry<MemorySpace>& geometry,
+                       FieldManager<Mesh>& fm )
+{
+    static_assert( is_uniform_mesh<Mesh>::value,
+                   "Volume ids may only be classified on a uniform mesh" );
+
+    // Get the cell volume id field.
+    fm.add( FieldLocation::Cell(), Field::VolumeId() );
+    auto volume_id_array = fm.array( FieldLocation::Cell(), Field::VolumeId() );
+    auto volume_id = volume_id_array->view();
+    auto local_grid = volume_id_array->layout()->localGrid();
+    auto local_mesh =
+        Cajita::createLocalMesh<typename Mesh::memory_space>( *local_grid );
+    auto ghost_cells = local_grid->indexSpace( Cajita::Ghost(), Cajita::Cell(),
+                                               Cajita::Local() );
+
+    // Cell geometry. Facet bounding boxes are padded by a small fraction of
+    // a cell so facets lying on a cell face cut the cells on both sides.
+    double dx = local_grid->globalGrid().globalMesh().cellSize( 0 );
+    double inv_dx = 1.0 / dx;
+    double pad = 1.0e-3 * dx;
+    Kokkos::Array<double, 3> low;
+    Kokkos::Array<int, 3> num_cell;
+    for ( int d = 0; d < 3; ++d )
+    {
+        low[d] = local_mesh.lowCorner( Cajita::Ghost(), d );
+        num_cell[d] = ghost_cells.extent( d );
+    }
+
+    // Mark the cells overlapped by the bounding box of each volume facet as
+    // cut. Instances have no facets of their own so the facets of their part
+    // are mapped to world space for each instance.
+    Kokkos::deep_copy( volume_id, 0 );
+    const auto& geom = geometry.data();
+    markCutCells( exec_space, geom.volume_facets, volume_id, low, num_cell,
+                  inv_dx, pad );
+    for ( int v = 0; v < geom.numVolume(); ++v )
+        if ( geometry.volumePartId( v ) != v )
+            markCutCells( exec_space,
+                          geometry.worldVolumeFacets( exec_space, v ),
+                          volume_id, low, num_cell, inv_dx, pad );
+
+    // Locate the center of each uncut cell.
+    Kokkos::parallel_for(
+        "volume_id_uncut_cells",
+        Cajita::createExecutionPolicy( ghost_cells, exec_space ),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            if ( CutCell != volume_id( i, j, k, 0 ) )
+            {
+                int cell_index[3] = { i, j, k };
+                double xc[3];
+                local_mesh.coordinates( Cajita::Cell(), cell_index, xc );
+                float x[3] = { float( xc[0] ), float( xc[1] ),
+                               float( xc[2] ) };
+                volume_id( i, j, k, 0 ) =
+                    FacetGeometryOps::locatePoint( x, geom );
+            }
+        } );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \class VolumeIdLocator
+  \brief Locates points in the volumes of a facet geometry using the
+  classified cell volume ids of a uniform mesh.
+
+  Points in uncut cells are located with a single lookup of the cell volume
+  id. Points in cut cells or outside of the local ghosted domain are located
+  with the geometry facets. The locator is device-accessible and may be
+  captured by value in parallel kernels.
+*/
+template <class Mesh>
+class VolumeIdLocator
+{
+  public:
+    using memory_space = typename Mesh::memory_space;
+
+    using view_type =
+        typename Cajita::Array<int, Cajita::Cell, typename Mesh::cajita_mesh,
+                               memory_space>::view_type;
+
+    /*!
+      \brief Constructor.
+      \param fm The field manager holding the classified cell volume ids.
+      \param geometry The facet geometry the cells were classified against.
+    */
+    VolumeIdLocator( const FieldManager<Mesh>& fm,
+                     const FacetGeometry<memory_space>& geometry )
+        : _geom( geometry.data() )
+    {
+        auto volume_id_array =
+            fm.array( FieldLocation::Cell(), Field::VolumeId() );
+        _volume_id = volume_id_array->view();
+        auto local_grid = volume_id_array->layout()->localGrid();
+        auto local_mesh =
+            Cajita::createLocalMesh<Kokkos::HostSpace>( *local_grid );
+        auto ghost_cells = local_grid->indexSpace(
+            Cajita::Ghost(), Cajita::Cell(), Cajita::Local() );
+        _inv_dx = 1.0 / local_grid->globalGrid().globalMesh().cellSize( 0 );
+        for ( int d = 0; d < 3; ++d )
+        {
+            _low[d] = local_mesh.lowCorner( Cajita::Ghost(), d );
+            _num_cell[d] = ghost_cells.extent( d );
+        }
+    }
+
+    // Given a point determine the volume in which it is located with the
+    // same result as FacetGeometryOps::locatePoint.
+    KOKKOS_INLINE_FUNCTION
+    int locatePoint( const float x[3] ) const
+    {
+        int ijk[3];
+        for ( int d = 0; d < 3; ++d )
+        {
+            ijk[d] =
+                static_cast<int>( floor( ( x[d] - _low[d] ) * _inv_dx ) );
+            if ( ijk[d] < 0 || ijk[d] >= _num_cell[d] )
+                return FacetGeometryOps::locatePoint( x, _geom );
+        }
+        int volume_id = _volume_id( ijk[Dim::I], ijk[Dim::J], ijk[Dim::K], 0 );
+        return ( CutCell == volume_id )
+                   ? FacetGeometryOps::locatePoint( x, _geom )
+                   : volume_id;
+    }
+
+  private:
+    FacetGeometryData<memory_space> _geom;
+    view_type _volume_id;
+    Kokkos::Array<double, 3> _low;
+    double _inv_dx;
+    Kokkos::Array<int, 3> _num_cell;
+};
+
+//---------------------------------------------------------------------------//
+// Creation function.
+template <class Mesh, class MemorySpace>
+VolumeIdLocator<Mesh>
+createVolumeIdLocator( const FieldManager<Mesh>& fm,
+                       const FacetGeometry<MemorySpace>& geometry )
+{
+    return VolumeIdLocator<Mesh>( fm, geometry );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Picasso
+
+#endif // end PICASSO_VOLUMEIDFIELD_HPP
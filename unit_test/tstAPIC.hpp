@@ -635,6 +635,64 @@ void collocatedTest()
     checkParticleVelocity( std::integral_constant<int, Order>(), pu_host,
                            pb_host, near_eps, 2 );
 
+    // Do the fused G2P and compare to the separate G2P operations.
+    Kokkos::View<double[3], TEST_MEMSPACE> pu_fused( "pu_fused" );
+    Kokkos::View<double[3][3], TEST_MEMSPACE> pb_fused( "pb_fused" );
+    Kokkos::View<double[2][3][3], TEST_MEMSPACE> pg( "pg" );
+    Kokkos::View<double[2], TEST_MEMSPACE> pdiv( "pdiv" );
+    Kokkos::parallel_for(
+        "g2p_fused", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, 1 ),
+        KOKKOS_LAMBDA( const int ) {
+            Vec3<double> x = { px, py, pz };
+            auto sd = createSpline( Location(), InterpolationOrder<Order>(),
+                                    local_mesh, x, SplineValue(),
+                                    SplineGradient(), SplineDistance() );
+
+            LinearAlgebra::Vector<double, 3> vel;
+            LinearAlgebra::Matrix<double, 3, 3> aff;
+            LinearAlgebra::Matrix<double, 3, 3> grad;
+            double div;
+            APIC::g2p( gv_wrapper, vel, aff, grad, div, sd );
+
+            LinearAlgebra::Matrix<double, 3, 3> grad_ref;
+            double div_ref;
+            G2P::gradient( sd, gv_wrapper, grad_ref );
+            G2P::divergence( sd, gv_wrapper, div_ref );
+
+            for ( int i = 0; i < 3; ++i )
+            {
+                pu_fused( i ) = vel( i );
+                for ( int j = 0; j < 3; ++j )
+                {
+                    pb_fused( i, j ) = aff( i, j );
+                    pg( 0, i, j ) = grad( i, j );
+                    pg( 1, i, j ) = grad_ref( i, j );
+                }
+            }
+            pdiv( 0 ) = div;
+            pdiv( 1 ) = div_ref;
+        } );
+    auto pu_fused_host =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), pu_fused );
+    auto pb_fused_host =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), pb_fused );
+    auto pg_host =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), pg );
+    auto pdiv_host =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), pdiv );
+    for ( int i = 0; i < 3; ++i )
+    {
+        EXPECT_NEAR( pu_fused_host( i ), pu_host( i ), near_eps );
+        for ( int j = 0; j < 3; ++j )
+        {
+            EXPECT_NEAR( pb_fused_host( i, j ), pb_host( i, j ), near_eps );
+            EXPECT_NEAR( pg_host( 0, i, j ), pg_host( 1, i, j ),
+                         near_eps * ( 1.0 + fabs( pg_host( 1, i, j ) ) ) );
+        }
+    }
+    EXPECT_NEAR( pdiv_host( 0 ), pdiv_host( 1 ),
+                 near_eps * ( 1.0 + fabs( pdiv_host( 1 ) ) ) );
+
     // Reset the grid view.
     Kokkos::deep_copy( gv_view, 0.0 );
 
@@ -10,8 +10,10 @@
  ****************************************************************************/
 
 #include <Picasso_FacetGeometry.hpp>
+#include <Picasso_FacetGeometryCache.hpp>
 #include <Picasso_InputParser.hpp>
 #include <Picasso_ParticleList.hpp>
+#include <Picasso_StlReader.hpp>
 #include <Picasso_Types.hpp>
 
 #include <Picasso_ParticleInit.hpp>
@@ -23,6 +25,12 @@
 #include <Kokkos_Core.hpp>
 
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -273,6 +281,132 @@ void rayFireTestXZ()
     EXPECT_TRUE( FacetGeometryOps::rayFacetIntersect( p, r, facet, 0 ) );
 }
 
+//---------------------------------------------------------------------------//
+void pointFacetDistanceTest()
+{
+    // Create a right triangle in the XY plane with legs of length 2.
+    Kokkos::View<float* [4][3], Kokkos::HostSpace> facet( "facet", 1 );
+
+    facet( 0, 0, 0 ) = 0.0;
+    facet( 0, 0, 1 ) = 0.0;
+    facet( 0, 0, 2 ) = 0.0;
+
+    facet( 0, 1, 0 ) = 2.0;
+    facet( 0, 1, 1 ) = 0.0;
+    facet( 0, 1, 2 ) = 0.0;
+
+    facet( 0, 2, 0 ) = 0.0;
+    facet( 0, 2, 1 ) = 2.0;
+    facet( 0, 2, 2 ) = 0.0;
+
+    facet( 0, 3, 0 ) = 0.0;
+    facet( 0, 3, 1 ) = 0.0;
+    facet( 0, 3, 2 ) = 1.0;
+
+    // Points in each region of the facet and their squared distance to it.
+    float points[8][3] = {
+        // On the facet.
+        { 0.5, 0.5, 0.0 },
+        // Above the interior.
+        { 0.5, 0.5, 1.5 },
+        // Closest to each vertex.
+        { -1.0, -1.0, 1.0 },
+        { 3.0, -1.0, 0.5 },
+        { -1.0, 3.0, 0.0 },
+        // Closest to each edge.
+        { 1.0, -1.0, 2.0 },
+        { -1.0, 1.0, 0.0 },
+        { 2.0, 2.0, 1.0 } };
+    float expected[8] = { 0.0, 2.25, 3.0, 2.25, 2.0, 5.0, 1.0, 3.0 };
+    for ( int n = 0; n < 8; ++n )
+        EXPECT_FLOAT_EQ(
+            FacetGeometryOps::pointFacetDistanceSquared( points[n], facet, 0 ),
+            expected[n] );
+}
+
+//---------------------------------------------------------------------------//
+void mollerTrumboreTest()
+{
+    // Create a right triangle in the XY plane with legs of length 2 and its
+    // first vertex at (1,0,0).
+    Kokkos::View<float* [4][3], Kokkos::HostSpace> facet( "facet", 1 );
+    float vertices[3][3] = {
+        { 1.0, 0.0, 0.0 }, { 3.0, 0.0, 0.0 }, { 1.0, 2.0, 0.0 } };
+    for ( int v = 0; v < 3; ++v )
+        for ( int d = 0; d < 3; ++d )
+            facet( 0, v, d ) = vertices[v][d];
+    facet( 0, 3, 0 ) = 0.0;
+    facet( 0, 3, 1 ) = 0.0;
+    facet( 0, 3, 2 ) = 1.0;
+
+    // Rays will be perpendicular in z.
+    float r[3] = { 0.0, 0.0, 1.0 };
+
+    // A point below the interior hits the facet. A point above it or on it
+    // does not.
+    float p[3] = { 1.5, 0.5, -1.0 };
+    EXPECT_TRUE( FacetGeometryOps::mollerTrumboreIntersect( p, r, facet,
+                                                            0 ) );
+    p[2] = 1.0;
+    EXPECT_FALSE( FacetGeometryOps::mollerTrumboreIntersect( p, r, facet,
+                                                             0 ) );
+    p[2] = 0.0;
+    EXPECT_FALSE( FacetGeometryOps::mollerTrumboreIntersect( p, r, facet,
+                                                             0 ) );
+
+    // Points below the facet but outside of it miss.
+    float outside[3][3] = {
+        { 0.5, 0.5, -1.0 }, { 1.5, -0.5, -1.0 }, { 2.01, 1.0, -1.0 } };
+    for ( int n = 0; n < 3; ++n )
+        EXPECT_FALSE( FacetGeometryOps::mollerTrumboreIntersect(
+            outside[n], r, facet, 0 ) );
+
+    // Points below each edge and vertex hit.
+    float boundary[6][3] = { { 1.0, 0.5, -1.0 }, { 1.5, 0.0, -1.0 },
+                             { 2.0, 1.0, -1.0 }, { 1.0, 0.0, -1.0 },
+                             { 3.0, 0.0, -1.0 }, { 1.0, 2.0, -1.0 } };
+    for ( int n = 0; n < 6; ++n )
+        EXPECT_TRUE( FacetGeometryOps::mollerTrumboreIntersect(
+            boundary[n], r, facet, 0 ) );
+
+    // Rays parallel to the facet miss, whether or not they are in its
+    // plane.
+    float r_parallel[3] = { 1.0, 0.0, 0.0 };
+    float in_plane[3] = { 0.0, 0.5, 0.0 };
+    EXPECT_FALSE( FacetGeometryOps::mollerTrumboreIntersect(
+        in_plane, r_parallel, facet, 0 ) );
+    float off_plane[3] = { 0.0, 0.5, -1.0 };
+    EXPECT_FALSE( FacetGeometryOps::mollerTrumboreIntersect(
+        off_plane, r_parallel, facet, 0 ) );
+
+    // Only intersections before the end of the ray are counted. The ray
+    // parameter is in units of the ray length.
+    p[2] = -1.0;
+    EXPECT_TRUE( FacetGeometryOps::mollerTrumboreIntersect( p, r, facet,
+                                                            0, 2.0 ) );
+    EXPECT_FALSE( FacetGeometryOps::mollerTrumboreIntersect( p, r, facet,
+                                                             0, 0.5 ) );
+    float segment[3] = { 0.0, 0.0, 2.0 };
+    EXPECT_TRUE( FacetGeometryOps::mollerTrumboreIntersect(
+        p, segment, facet, 0, 1.0 ) );
+    EXPECT_FALSE( FacetGeometryOps::mollerTrumboreIntersect(
+        p, segment, facet, 0, 0.4 ) );
+
+    // Oblique rays agree with the intersection from the facet projection.
+    float r_oblique[3] = { 0.3, -0.2, 0.9 };
+    for ( int i = 0; i < 10; ++i )
+    {
+        for ( int j = 0; j < 10; ++j )
+        {
+            float x[3] = { 0.13f + 0.37f * i, -0.77f + 0.31f * j, -1.0f };
+            EXPECT_EQ( FacetGeometryOps::mollerTrumboreIntersect(
+                           x, r_oblique, facet, 0 ),
+                       FacetGeometryOps::rayFacetIntersect( x, r_oblique,
+                                                            facet, 0 ) );
+        }
+    }
+}
+
 //---------------------------------------------------------------------------//
 void constructionTest()
 {
@@ -476,8 +610,585 @@ TEST( TEST_CATEGORY, ray_fire_test )
 }
 
 //---------------------------------------------------------------------------//
+// Write the solids of one kind as binary STL blocks.
+void writeBinaryStl( std::ofstream& file, const std::string& name,
+                     const std::vector<int>& ids,
+                     const std::vector<int>& facet_counts,
+                     const std::vector<float>& facets )
+{
+    std::size_t offset = 0;
+    for ( std::size_t s = 0; s < ids.size(); ++s )
+    {
+        char header[80] = {};
+        std::snprintf( header, 80, "solid %s %d", name.c_str(), ids[s] );
+        file.write( header, 80 );
+        std::uint32_t num_facet = facet_counts[s];
+        file.write( reinterpret_cast<const char*>( &num_facet ), 4 );
+        for ( std::uint32_t f = 0; f < num_facet; ++f )
+        {
+            float normal[3] = { 0.0, 0.0, 0.0 };
+            file.write( reinterpret_cast<const char*>( normal ), 12 );
+            file.write( reinterpret_cast<const char*>( &facets[offset] ), 36 );
+            offset += 9;
+            std::uint16_t attribute = 0;
+            file.write( reinterpret_cast<const char*>( &attribute ), 2 );
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+void binaryConstructionTest()
+{
+    // Create inputs.
+    InputParser parser( "facet_geometry_test.json", "json" );
+    auto pt = parser.propertyTree();
+
+    // Create the geometry from the ASCII test file.
+    FacetGeometry<TEST_MEMSPACE> ascii_geometry( pt, TEST_EXECSPACE() );
+
+    // Write the same solids to a binary file. Each rank writes its own file.
+    StlData stl_data;
+    readStl( "stl_reader_test.stl", StlFormat::Ascii, stl_data );
+    int comm_rank;
+    MPI_Comm_rank( MPI_COMM_WORLD, &comm_rank );
+    std::string binary_filename =
+        "stl_reader_test_" + std::to_string( comm_rank ) + ".stlb";
+    {
+        std::ofstream file( binary_filename, std::ios::binary );
+        writeBinaryStl( file, "Volume", stl_data.volume_ids,
+                        stl_data.volume_facet_count, stl_data.volume_facets );
+        writeBinaryStl( file, "Surface", stl_data.surface_ids,
+                        stl_data.surface_facet_count,
+                        stl_data.surface_facets );
+    }
+
+    // Create the geometry from the binary file. The format is detected.
+    pt.put( "geometry.stl_file", binary_filename );
+    FacetGeometry<TEST_MEMSPACE> binary_geometry( pt, TEST_EXECSPACE() );
+    std::remove( binary_filename.c_str() );
+
+    // Check that the geometries are the same.
+    const auto& ascii_data = ascii_geometry.data();
+    const auto& binary_data = binary_geometry.data();
+    EXPECT_EQ( binary_data.numVolume(), ascii_data.numVolume() );
+    EXPECT_EQ( binary_data.numSurface(), ascii_data.numSurface() );
+    EXPECT_EQ( binary_data.global_bounding_volume_id,
+               ascii_data.global_bounding_volume_id );
+    for ( int v = 0; v < ascii_data.numVolume(); ++v )
+        EXPECT_EQ( binary_geometry.numVolumeFacet( v ),
+                   ascii_geometry.numVolumeFacet( v ) );
+    for ( int s = 0; s < ascii_data.numSurface(); ++s )
+        EXPECT_EQ( binary_geometry.numSurfaceFacet( s ),
+                   ascii_geometry.numSurfaceFacet( s ) );
+
+    auto ascii_facets = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), ascii_data.volume_facets );
+    auto binary_facets = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), binary_data.volume_facets );
+    ASSERT_EQ( binary_facets.extent( 0 ), ascii_facets.extent( 0 ) );
+    for ( std::size_t f = 0; f < ascii_facets.extent( 0 ); ++f )
+        for ( int v = 0; v < 4; ++v )
+            for ( int d = 0; d < 3; ++d )
+                EXPECT_EQ( binary_facets( f, v, d ), ascii_facets( f, v, d ) );
+}
+
+//---------------------------------------------------------------------------//
+void volumeBvhTest()
+{
+    // Create inputs.
+    InputParser parser( "facet_geometry_test.json", "json" );
+    auto pt = parser.propertyTree();
+
+    // Create the geometry.
+    FacetGeometry<TEST_MEMSPACE> geometry( pt, TEST_EXECSPACE() );
+    const auto& geom_data = geometry.data();
+    auto global_box = geometry.globalBoundingBox();
+
+    // Check that the leaves of the hierarchy of each volume cover each of
+    // its facets once.
+    auto nodes = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), geom_data.volume_bvh_nodes );
+    auto offsets = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), geom_data.volume_bvh_offsets );
+    ASSERT_EQ( offsets.extent( 0 ), 3u );
+    EXPECT_EQ( offsets( 2 ), static_cast<int>( nodes.extent( 0 ) ) );
+    for ( int v = 0; v < 3; ++v )
+    {
+        std::vector<int> covered( geometry.numVolumeFacet( v ), 0 );
+        int begin = ( 0 == v ) ? 0 : offsets( v - 1 );
+        for ( int n = begin; n < offsets( v ); ++n )
+            if ( nodes( n, 0 ) < 0 )
+                for ( int f = -1 - nodes( n, 0 ); f < nodes( n, 1 ); ++f )
+                    ++covered[f];
+        for ( auto c : covered )
+            EXPECT_EQ( c, 1 );
+    }
+
+    // Check that point inclusion with the hierarchy matches point inclusion
+    // with every facet of the volume for a lattice of points over the
+    // global bounding box.
+    int num_point = 20;
+    int num_mismatch = 0;
+    int num_inside = 0;
+    Kokkos::parallel_reduce(
+        "check_bvh_inclusion",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_point * num_point *
+                                                    num_point ),
+        KOKKOS_LAMBDA( const int n, int& mismatch, int& inside ) {
+            int ijk[3] = { n % num_point, ( n / num_point ) % num_point,
+                           n / ( num_point * num_point ) };
+            float x[3];
+            for ( int d = 0; d < 3; ++d )
+            {
+                double dx = ( global_box[d + 3] - global_box[d] ) / num_point;
+                x[d] = global_box[d] + ( ijk[d] + 0.5 ) * dx;
+            }
+            for ( int v = 0; v < geom_data.numVolume(); ++v )
+            {
+                bool bvh_in =
+                    FacetGeometryOps::pointInVolume( x, geom_data, v );
+                bool all_in = FacetGeometryOps::pointInVolume(
+                    x, geom_data.volumeFacets( v ) );
+                if ( bvh_in != all_in )
+                    ++mismatch;
+                if ( bvh_in )
+                    ++inside;
+            }
+        },
+        num_mismatch, num_inside );
+    EXPECT_EQ( num_mismatch, 0 );
+    EXPECT_TRUE( num_inside > 0 );
+
+    // Check that the leaves of the top-level hierarchy cover each volume
+    // except the global bounding volume once.
+    auto top_nodes = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), geom_data.top_bvh_nodes );
+    auto top_volume_ids = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), geom_data.top_bvh_volume_ids );
+    std::vector<int> volume_covered( 3, 0 );
+    for ( std::size_t n = 0; n < top_nodes.extent( 0 ); ++n )
+        if ( top_nodes( n, 0 ) < 0 )
+            for ( int i = -1 - top_nodes( n, 0 ); i < top_nodes( n, 1 ); ++i )
+                ++volume_covered[top_volume_ids( i )];
+    for ( int v = 0; v < 3; ++v )
+        EXPECT_EQ( volume_covered[v],
+                   ( v == geom_data.global_bounding_volume_id ) ? 0 : 1 );
+
+    // Check that point location with the top-level hierarchy matches a scan
+    // of the volumes in priority order.
+    num_mismatch = 0;
+    Kokkos::parallel_reduce(
+        "check_top_bvh_location",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_point * num_point *
+                                                    num_point ),
+        KOKKOS_LAMBDA( const int n, int& mismatch ) {
+            int ijk[3] = { n % num_point, ( n / num_point ) % num_point,
+                           n / ( num_point * num_point ) };
+            float x[3];
+            for ( int d = 0; d < 3; ++d )
+            {
+                double dx = ( global_box[d + 3] - global_box[d] ) / num_point;
+                x[d] = global_box[d] + ( ijk[d] + 0.5 ) * dx;
+            }
+            int scan_id = -1;
+            for ( int v = 0; v < geom_data.numVolume(); ++v )
+            {
+                if ( v != geom_data.global_bounding_volume_id &&
+                     FacetGeometryOps::pointInVolume( x, geom_data, v ) )
+                {
+                    scan_id = v;
+                    break;
+                }
+            }
+            if ( FacetGeometryOps::locatePoint( x, geom_data ) != scan_id )
+                ++mismatch;
+        },
+        num_mismatch );
+    EXPECT_EQ( num_mismatch, 0 );
+}
+
+//---------------------------------------------------------------------------//
+void cacheTest()
+{
+    // Create inputs with a cache file.
+    InputParser parser( "facet_geometry_test.json", "json" );
+    auto pt = parser.propertyTree();
+    std::string cache_filename = "facet_geometry_test.cache";
+    pt.put( "geometry.cache_file", cache_filename );
+    int comm_rank;
+    MPI_Comm_rank( MPI_COMM_WORLD, &comm_rank );
+    if ( 0 == comm_rank )
+        std::remove( cache_filename.c_str() );
+    MPI_Barrier( MPI_COMM_WORLD );
+
+    // Create the geometry. There is no cache so the STL file is read and
+    // the cache written by the first rank. Files are only read by the first
+    // rank so all ranks agree there was no cache.
+    FacetGeometry<TEST_MEMSPACE> stl_geometry( pt, TEST_EXECSPACE() );
+    EXPECT_FALSE( stl_geometry.fromCache() );
+    MPI_Barrier( MPI_COMM_WORLD );
+
+    // The cache is only valid for the STL file it was built from.
+    auto stl_hash = stlFileHash( "stl_reader_test.stl" );
+    FacetGeometryCacheData cache_data;
+    EXPECT_TRUE(
+        readFacetGeometryCache( cache_filename, stl_hash, cache_data ) );
+    EXPECT_FALSE(
+        readFacetGeometryCache( cache_filename, stl_hash + 1, cache_data ) );
+
+    // Create the geometry again. This time it is restored from the cache.
+    FacetGeometry<TEST_MEMSPACE> cache_geometry( pt, TEST_EXECSPACE() );
+    EXPECT_TRUE( cache_geometry.fromCache() );
+    MPI_Barrier( MPI_COMM_WORLD );
+    if ( 0 == comm_rank )
+        std::remove( cache_filename.c_str() );
+
+    // Check that the geometries are the same.
+    const auto& stl_geom = stl_geometry.data();
+    const auto& cache_geom = cache_geometry.data();
+    EXPECT_EQ( cache_geom.numVolume(), stl_geom.numVolume() );
+    EXPECT_EQ( cache_geom.numSurface(), stl_geom.numSurface() );
+    EXPECT_EQ( cache_geom.global_bounding_volume_id,
+               stl_geom.global_bounding_volume_id );
+    for ( int i = 0; i < 3; ++i )
+        EXPECT_EQ( cache_geometry.localVolumeId( i + 1 ),
+                   stl_geometry.localVolumeId( i + 1 ) );
+    for ( int i = 0; i < 13; ++i )
+        EXPECT_EQ( cache_geometry.localSurfaceId( i + 1 ),
+                   stl_geometry.localSurfaceId( i + 1 ) );
+    for ( int i = 0; i < 6; ++i )
+        EXPECT_EQ( cache_geometry.globalBoundingBox()[i],
+                   stl_geometry.globalBoundingBox()[i] );
+
+    auto stl_facets = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), stl_geom.volume_facets );
+    auto cache_facets = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), cache_geom.volume_facets );
+    ASSERT_EQ( cache_facets.extent( 0 ), stl_facets.extent( 0 ) );
+    for ( std::size_t f = 0; f < stl_facets.extent( 0 ); ++f )
+        for ( int v = 0; v < 4; ++v )
+            for ( int d = 0; d < 3; ++d )
+                EXPECT_EQ( cache_facets( f, v, d ), stl_facets( f, v, d ) );
+
+    // Check that points are located the same with the restored hierarchy.
+    Kokkos::Array<float, 3> p1 = { 0.0, 0.0, 0.0 };
+    Kokkos::Array<float, 3> p2 = { 14.0, 14.0, 14.0 };
+    int volume_sum = 0;
+    Kokkos::parallel_reduce(
+        "check_point_location", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, 1 ),
+        KOKKOS_LAMBDA( const int, int& result ) {
+            result = 10 * FacetGeometryOps::locatePoint( p1.data(),
+                                                         cache_geom ) +
+                     FacetGeometryOps::locatePoint( p2.data(),
+                                                    cache_geom );
+        },
+        volume_sum );
+    EXPECT_EQ( volume_sum, 10 );
+}
+
+//---------------------------------------------------------------------------//
+void distributedTest()
+{
+    // Get inputs.
+    InputParser parser( "facet_init_example.json", "json" );
+    auto pt = parser.propertyTree();
+
+    // Create the distributed geometry and a mesh over it.
+    FacetGeometry<TEST_MEMSPACE> geometry( pt, MPI_COMM_WORLD );
+    int minimum_halo_size = 1;
+    auto mesh = std::make_shared<UniformMesh<TEST_MEMSPACE>>(
+        pt, geometry.globalBoundingBox(), minimum_halo_size, MPI_COMM_WORLD );
+
+    // Distribute the facets over the ghosted local domains.
+    auto local_grid = mesh->localGrid();
+    auto host_mesh = Cajita::createLocalMesh<Kokkos::HostSpace>( *local_grid );
+    Kokkos::Array<double, 6> local_box;
+    for ( int d = 0; d < 3; ++d )
+    {
+        local_box[d] = host_mesh.lowCorner( Cajita::Ghost(), d );
+        local_box[d + 3] = host_mesh.highCorner( Cajita::Ghost(), d );
+    }
+    geometry.distribute( local_box );
+
+    // Create the full geometry on every rank.
+    FacetGeometry<TEST_MEMSPACE> full_geometry( pt, TEST_EXECSPACE() );
+
+    // Check that the ids and bounding boxes are those of the full geometry
+    // and that only a subset of the facets is stored.
+    for ( int i = 0; i < 3; ++i )
+    {
+        int local_id = full_geometry.localVolumeId( i + 1 );
+        EXPECT_EQ( geometry.localVolumeId( i + 1 ), local_id );
+        EXPECT_LE( geometry.numVolumeFacet( local_id ),
+                   full_geometry.numVolumeFacet( local_id ) );
+    }
+    for ( int i = 0; i < 13; ++i )
+        EXPECT_EQ( geometry.localSurfaceId( i + 1 ),
+                   full_geometry.localSurfaceId( i + 1 ) );
+    for ( int i = 0; i < 6; ++i )
+        EXPECT_EQ( geometry.globalBoundingBox()[i],
+                   full_geometry.globalBoundingBox()[i] );
+
+    // Check that the cell centers of the ghosted local domain are located
+    // in the same volume as with the full geometry.
+    const auto& geom = geometry.data();
+    const auto& full_geom = full_geometry.data();
+    auto local_mesh = Cajita::createLocalMesh<TEST_MEMSPACE>( *local_grid );
+    auto ghost_cells = local_grid->indexSpace( Cajita::Ghost(), Cajita::Cell(),
+                                               Cajita::Local() );
+    int num_mismatch = 0;
+    Kokkos::parallel_reduce(
+        "check_distributed_location",
+        Cajita::createExecutionPolicy( ghost_cells, TEST_EXECSPACE() ),
+        KOKKOS_LAMBDA( const int i, const int j, const int k, int& mismatch ) {
+            int index[3] = { i, j, k };
+            double x[3];
+            local_mesh.coordinates( Cajita::Cell(), index, x );
+            float xf[3] = { float( x[0] ), float( x[1] ), float( x[2] ) };
+            if ( FacetGeometryOps::locatePoint( xf, geom ) !=
+                 FacetGeometryOps::locatePoint( xf, full_geom ) )
+                ++mismatch;
+        },
+        num_mismatch );
+    EXPECT_EQ( num_mismatch, 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Add an instance of a part volume to the geometry parameters.
+void addInstance( boost::property_tree::ptree& pt, const int volume_id,
+                  const int part_volume_id,
+                  const std::vector<double>& translation,
+                  const std::vector<double>& rotation, const double scale )
+{
+    boost::property_tree::ptree instance;
+    instance.put( "volume_id", volume_id );
+    instance.put( "part_volume_id", part_volume_id );
+    instance.put( "scale", scale );
+    boost::property_tree::ptree translation_tree;
+    for ( auto t : translation )
+    {
+        boost::property_tree::ptree value;
+        value.put( "", t );
+        translation_tree.push_back( std::make_pair( "", value ) );
+    }
+    instance.add_child( "translation", translation_tree );
+    boost::property_tree::ptree rotation_tree;
+    for ( auto r : rotation )
+    {
+        boost::property_tree::ptree value;
+        value.put( "", r );
+        rotation_tree.push_back( std::make_pair( "", value ) );
+    }
+    instance.add_child( "rotation", rotation_tree );
+    if ( !pt.get_child_optional( "geometry.instances" ) )
+        pt.add_child( "geometry.instances", boost::property_tree::ptree() );
+    pt.get_child( "geometry.instances" )
+        .push_back( std::make_pair( "", instance ) );
+}
+
+//---------------------------------------------------------------------------//
+void instanceTest()
+{
+    // Create inputs with two instances of the cube with global volume id 1.
+    // The first is translated to be centered at (15,15,-5). The second is
+    // rotated 90 degrees about the z axis and scaled by half to be centered
+    // at (-7.5,7.5,7.5).
+    InputParser parser( "facet_geometry_test.json", "json" );
+    auto pt = parser.propertyTree();
+    std::vector<double> identity = { 1.0, 0.0, 0.0, 0.0, 1.0,
+                                     0.0, 0.0, 0.0, 1.0 };
+    addInstance( pt, 4, 1, { 0.0, 0.0, -20.0 }, identity, 1.0 );
+    addInstance( pt, 5, 1, { 0.0, 0.0, 0.0 },
+                 { 0.0, -1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0 }, 0.5 );
+
+    // Create the geometry.
+    FacetGeometry<TEST_MEMSPACE> geometry( pt, TEST_EXECSPACE() );
+    const auto& geom_data = geometry.data();
+
+    // Check that the instances are volumes which share the cube facets.
+    EXPECT_EQ( geom_data.numVolume(), 5 );
+    int cube_id = geometry.localVolumeId( 1 );
+    int instance_1 = geometry.localVolumeId( 4 );
+    int instance_2 = geometry.localVolumeId( 5 );
+    EXPECT_EQ( geometry.volumePartId( cube_id ), cube_id );
+    EXPECT_EQ( geometry.volumePartId( instance_1 ), cube_id );
+    EXPECT_EQ( geometry.volumePartId( instance_2 ), cube_id );
+    EXPECT_EQ( geometry.numVolumeFacet( instance_1 ), 0 );
+    EXPECT_EQ( geometry.numVolumeFacet( instance_2 ), 0 );
+    EXPECT_EQ( static_cast<int>( geom_data.volume_facets.extent( 0 ) ),
+               geometry.numVolumeFacet( 0 ) + geometry.numVolumeFacet( 1 ) +
+                   geometry.numVolumeFacet( 2 ) );
+
+    // Check the instance bounding boxes.
+    auto boxes = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), geom_data.volume_bounding_boxes );
+    float box_1[6] = { 13.0, 13.0, -7.0, 17.0, 17.0, -3.0 };
+    float box_2[6] = { -8.5, 6.5, 6.5, -6.5, 8.5, 8.5 };
+    for ( int i = 0; i < 6; ++i )
+    {
+        EXPECT_FLOAT_EQ( boxes( instance_1, i ), box_1[i] );
+        EXPECT_FLOAT_EQ( boxes( instance_2, i ), box_2[i] );
+    }
+
+    // Check the world space facets of an instance are in its box.
+    auto world_facets = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(),
+        geometry.worldVolumeFacets( TEST_EXECSPACE(), instance_2 ) );
+    ASSERT_EQ( static_cast<int>( world_facets.extent( 0 ) ),
+               geometry.numVolumeFacet( cube_id ) );
+    for ( std::size_t f = 0; f < world_facets.extent( 0 ); ++f )
+    {
+        for ( int v = 0; v < 3; ++v )
+        {
+            for ( int d = 0; d < 3; ++d )
+            {
+                EXPECT_GE( world_facets( f, v, d ), box_2[d] - 1.0e-5 );
+                EXPECT_LE( world_facets( f, v, d ), box_2[d + 3] + 1.0e-5 );
+            }
+        }
+        float nmag = 0.0;
+        for ( int d = 0; d < 3; ++d )
+            nmag += world_facets( f, 3, d ) * world_facets( f, 3, d );
+        EXPECT_FLOAT_EQ( nmag, 1.0 );
+    }
+
+    // Check point location in the instances.
+    Kokkos::View<float* [3], TEST_MEMSPACE> points( "points", 6 );
+    auto host_points =
+        Kokkos::create_mirror_view( Kokkos::HostSpace(), points );
+    float point_values[6][3] = { { 15.0, 15.0, 15.0 }, { 15.0, 15.0, -5.0 },
+                                 { 14.0, 16.5, -3.5 }, { -7.5, 7.5, 7.5 },
+                                 { -7.0, 8.2, 6.8 },   { -7.5, 7.5, 9.0 } };
+    for ( int p = 0; p < 6; ++p )
+        for ( int d = 0; d < 3; ++d )
+            host_points( p, d ) = point_values[p][d];
+    Kokkos::deep_copy( points, host_points );
+    Kokkos::View<int*, TEST_MEMSPACE> volume_ids( "volume_ids", 6 );
+    Kokkos::parallel_for(
+        "locate_instance_points", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, 6 ),
+        KOKKOS_LAMBDA( const int p ) {
+            float x[3] = { points( p, 0 ), points( p, 1 ), points( p, 2 ) };
+            volume_ids( p ) = FacetGeometryOps::locatePoint( x, geom_data );
+        } );
+    auto host_volume_ids =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), volume_ids );
+    EXPECT_EQ( host_volume_ids( 0 ), cube_id );
+    EXPECT_EQ( host_volume_ids( 1 ), instance_1 );
+    EXPECT_EQ( host_volume_ids( 2 ), instance_1 );
+    EXPECT_EQ( host_volume_ids( 3 ), instance_2 );
+    EXPECT_EQ( host_volume_ids( 4 ), instance_2 );
+    EXPECT_EQ( host_volume_ids( 5 ), -1 );
+
+    // Instances must have a new id and a part from the STL file.
+    auto bad_id_pt = parser.propertyTree();
+    addInstance( bad_id_pt, 2, 1, { 0.0, 0.0, 0.0 }, identity, 1.0 );
+    EXPECT_THROW( FacetGeometry<TEST_MEMSPACE>( bad_id_pt, TEST_EXECSPACE() ),
+                  std::runtime_error );
+    auto bad_part_pt = parser.propertyTree();
+    addInstance( bad_part_pt, 4, 7, { 0.0, 0.0, 0.0 }, identity, 1.0 );
+    EXPECT_THROW(
+        FacetGeometry<TEST_MEMSPACE>( bad_part_pt, TEST_EXECSPACE() ),
+        std::runtime_error );
+}
+
+//---------------------------------------------------------------------------//
+void overlappingVolumeBvhTest()
+{
+    // Create inputs with six instances of the cube with global volume id 1,
+    // each shifted a little further from the cube centered at (15,15,15),
+    // so more volumes overlap than fit in a leaf of the top-level
+    // hierarchy.
+    InputParser parser( "facet_geometry_test.json", "json" );
+    auto pt = parser.propertyTree();
+    std::vector<double> identity = { 1.0, 0.0, 0.0, 0.0, 1.0,
+                                     0.0, 0.0, 0.0, 1.0 };
+    int num_instance = 6;
+    for ( int i = 1; i <= num_instance; ++i )
+        addInstance( pt, 10 + i, 1, { 0.25 * i, -0.15 * i, 0.2 * i },
+                     identity, 1.0 );
+
+    // Create the geometry.
+    FacetGeometry<TEST_MEMSPACE> geometry( pt, TEST_EXECSPACE() );
+    const auto& geom_data = geometry.data();
+    EXPECT_EQ( geom_data.numVolume(), 3 + num_instance );
+
+    // Check that point location with the top-level hierarchy gives the
+    // lowest id of the volumes containing each point of a lattice over the
+    // overlapping volumes.
+    int num_point = 17;
+    float low = 12.0;
+    float high = 19.0;
+    int num_mismatch = 0;
+    int num_overlap = 0;
+    Kokkos::parallel_reduce(
+        "check_overlapping_location",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_point * num_point *
+                                                    num_point ),
+        KOKKOS_LAMBDA( const int n, int& mismatch, int& overlap ) {
+            int ijk[3] = { n % num_point, ( n / num_point ) % num_point,
+                           n / ( num_point * num_point ) };
+            float x[3];
+            for ( int d = 0; d < 3; ++d )
+                x[d] = low + ( ijk[d] + 0.5 ) * ( high - low ) / num_point;
+            int scan_id = -1;
+            int num_inside = 0;
+            for ( int v = geom_data.numVolume() - 1; v >= 0; --v )
+            {
+                if ( v != geom_data.global_bounding_volume_id &&
+                     FacetGeometryOps::pointInVolume( x, geom_data, v ) )
+                {
+                    scan_id = v;
+                    ++num_inside;
+                }
+            }
+            if ( FacetGeometryOps::locatePoint( x, geom_data ) != scan_id )
+                ++mismatch;
+            if ( num_inside > 4 )
+                ++overlap;
+        },
+        num_mismatch, num_overlap );
+    EXPECT_EQ( num_mismatch, 0 );
+    EXPECT_GT( num_overlap, 0 );
+
+    // The center of the cube is in every instance and the cube has the
+    // lowest id.
+    Kokkos::View<int*, TEST_MEMSPACE> center_id( "center_id", 1 );
+    Kokkos::parallel_for(
+        "locate_center", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, 1 ),
+        KOKKOS_LAMBDA( const int ) {
+            float x[3] = { 15.1, 14.9, 15.2 };
+            center_id( 0 ) = FacetGeometryOps::locatePoint( x, geom_data );
+        } );
+    auto host_center_id =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), center_id );
+    EXPECT_EQ( host_center_id( 0 ), geometry.localVolumeId( 1 ) );
+}
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, point_facet_distance_test )
+{
+    pointFacetDistanceTest();
+}
+
+TEST( TEST_CATEGORY, moller_trumbore_test ) { mollerTrumboreTest(); }
+
 TEST( TEST_CATEGORY, construction_test ) { constructionTest(); }
 
+TEST( TEST_CATEGORY, volume_bvh_test ) { volumeBvhTest(); }
+
+TEST( TEST_CATEGORY, cache_test ) { cacheTest(); }
+
+TEST( TEST_CATEGORY, distributed_test ) { distributedTest(); }
+
+TEST( TEST_CATEGORY, instance_test ) { instanceTest(); }
+
+TEST( TEST_CATEGORY, overlapping_volume_bvh_test )
+{
+    overlappingVolumeBvhTest();
+}
+
+TEST( TEST_CATEGORY, binary_construction_test ) { binaryConstructionTest(); }
+
 //---------------------------------------------------------------------------//
 template <class MemorySpace>
 struct LocateFunctor
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Picasso_FacetGeometry.hpp>
+#include <Picasso_FacetLevelSet.hpp>
+#include <Picasso_FieldTypes.hpp>
+#include <Picasso_InputParser.hpp>
+#include <Picasso_Types.hpp>
+#include <Picasso_UniformMesh.hpp>
+
+#include <Cajita.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+using namespace Picasso;
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+void sphereTest()
+{
+    // Get inputs.
+    InputParser parser( "facet_level_set_test.json", "json" );
+    auto pt = parser.propertyTree();
+
+    // Create the geometry. It contains a sphere of radius 10 centered at the
+    // origin with global volume id 2.
+    FacetGeometry<TEST_MEMSPACE> geometry( pt, TEST_EXECSPACE() );
+
+    // Make a mesh over the geometry.
+    int minimum_halo_size = 2;
+    auto mesh = std::make_shared<UniformMesh<TEST_MEMSPACE>>(
+        pt, geometry.globalBoundingBox(), minimum_halo_size, MPI_COMM_WORLD );
+
+    // Compute the signed distance function of the sphere.
+    auto level_set = createFacetLevelSet<FieldLocation::Node>(
+        pt, mesh, geometry, 2, TEST_EXECSPACE() );
+    level_set->computeSignedDistance( TEST_EXECSPACE() );
+
+    // The facets are a triangulation of the sphere with vertices on its
+    // surface. The distance to the facets differs from the distance to the
+    // sphere by at most the largest distance of a facet plane inside of the
+    // sphere.
+    const auto& geom_data = geometry.data();
+    int volume_id = level_set->localVolumeId();
+    auto facets = geom_data.volumeFacets( volume_id );
+    double radius = 10.0;
+    float origin[3] = { 0.0, 0.0, 0.0 };
+    double tolerance = 0.0;
+    Kokkos::parallel_reduce(
+        "faceting_tolerance",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, facets.extent( 0 ) ),
+        KOKKOS_LAMBDA( const int f, double& result ) {
+            double error =
+                radius - fabs( FacetGeometryOps::distanceToFacetPlane(
+                             origin, facets, f ) );
+            result = ( error > result ) ? error : result;
+        },
+        Kokkos::Max<double>( tolerance ) );
+    EXPECT_LT( tolerance, 0.1 );
+    tolerance += 1.0e-4;
+
+    // Compare to the analytic distance to the sphere within the faceting
+    // tolerance and check the sign away from the sphere surface.
+    auto ls = level_set->levelSet();
+    auto distance_view = ls->getSignedDistance()->view();
+    auto local_mesh =
+        Cajita::createLocalMesh<TEST_MEMSPACE>( *( ls->mesh()->localGrid() ) );
+    auto ghost_nodes = ls->mesh()->localGrid()->indexSpace(
+        Cajita::Ghost(), Cajita::Node(), Cajita::Local() );
+    double band_width = ls->bandWidth();
+    int num_error = 0;
+    Kokkos::parallel_reduce(
+        "check_facet_distance",
+        Cajita::createExecutionPolicy( ghost_nodes, TEST_EXECSPACE() ),
+        KOKKOS_LAMBDA( const int i, const int j, const int k, int& error ) {
+            int entity_index[3] = { i, j, k };
+            double x[3];
+            local_mesh.coordinates( Cajita::Node(), entity_index, x );
+            double r = sqrt( x[0] * x[0] + x[1] * x[1] + x[2] * x[2] );
+            double phi = distance_view( i, j, k, 0 );
+
+            // Distance within the band.
+            if ( fabs( r - radius ) < band_width - tolerance &&
+                 fabs( phi - ( r - radius ) ) > tolerance )
+                ++error;
+
+            // Sign.
+            if ( r < 9.0 && phi >= 0.0 )
+                ++error;
+            if ( r > 11.0 && phi <= 0.0 )
+                ++error;
+        },
+        num_error );
+    EXPECT_EQ( num_error, 0 );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, sphere_test ) { sphereTest(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
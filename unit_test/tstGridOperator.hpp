@@ -9,6 +9,7 @@
  * SPDX-License-Identifier: BSD-3-Clause                                    *
  ****************************************************************************/
 
+#include <Picasso_APIC.hpp>
 #include <Picasso_FieldManager.hpp>
 #include <Picasso_FieldTypes.hpp>
 #include <Picasso_GridOperator.hpp>
@@ -24,6 +25,8 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <cmath>
+
 #include <gtest/gtest.h>
 
 using namespace Picasso;
@@ -107,6 +110,74 @@ struct ParticleFunc
     }
 };
 
+//---------------------------------------------------------------------------//
+// Particle-to-grid operation. Only reads particle data so it may be applied
+// in either scatter or gather mode.
+struct ParticleP2GFunc
+{
+    template <class LocalMeshType, class GatherDependencies,
+              class ScatterDependencies, class LocalDependencies,
+              class ParticleViewType>
+    KOKKOS_INLINE_FUNCTION void
+    operator()( const LocalMeshType& local_mesh, const GatherDependencies&,
+                const ScatterDependencies& scatter_deps,
+                const LocalDependencies&, ParticleViewType& particle ) const
+    {
+        // Get output dependencies.
+        auto foo_out = scatter_deps.get( FieldLocation::Node(), FooOut() );
+        auto bar_out = scatter_deps.get( FieldLocation::Node(), BarOut() );
+
+        // Get particle data.
+        auto foop = get( particle, FooP() );
+        auto barp = get( particle, BarP() );
+
+        // Linear node interpolant.
+        auto spline = createSpline(
+            FieldLocation::Node(), InterpolationOrder<1>(), local_mesh,
+            get( particle, Field::LogicalPosition() ), SplineValue() );
+
+        // Interpolate to the grid.
+        P2G::value( spline, foop, foo_out );
+        P2G::value( spline, barp, bar_out );
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Grid-to-particle operation with a cubic APIC interpolant. The stencil of a
+// particle extends across tile boundaries.
+struct ParticleAPICFunc
+{
+    template <class LocalMeshType, class GatherDependencies,
+              class ScatterDependencies, class LocalDependencies,
+              class ParticleViewType>
+    KOKKOS_INLINE_FUNCTION void
+    operator()( const LocalMeshType& local_mesh,
+                const GatherDependencies& gather_deps,
+                const ScatterDependencies&, const LocalDependencies&,
+                ParticleViewType& particle ) const
+    {
+        // Get input dependencies.
+        auto foo_in = gather_deps.get( FieldLocation::Node(), FooIn() );
+
+        // Cubic node interpolant.
+        auto spline = createSpline(
+            FieldLocation::Node(), InterpolationOrder<3>(), local_mesh,
+            get( particle, Field::LogicalPosition() ), SplineValue(),
+            SplineDistance() );
+
+        // Interpolate to the particles.
+        LinearAlgebra::Vector<double, 3> vel;
+        LinearAlgebra::Matrix<double, 3, 3> aff;
+        APIC::g2p( foo_in, vel, aff, spline );
+        for ( int i = 0; i < 3; ++i )
+        {
+            get( particle, FooP(), i ) = vel( i );
+            for ( int j = 0; j < 3; ++j )
+                get( particle, Baz(), i, j ) = aff( i, j );
+        }
+    }
+};
+
 //---------------------------------------------------------------------------//
 // Grid operation.
 struct GridFunc
@@ -257,6 +328,36 @@ void gatherScatterTest()
             EXPECT_EQ( bar_out_host( i, j, k, 0 ), ppc * 3.0 );
         } );
 
+    // Apply the particle operator again with gather dependencies read from
+    // tiles. Use tiles which do not evenly divide the local grid.
+    Kokkos::deep_copy( fm->view( FieldLocation::Cell(), FooOut() ), -1.1 );
+    Kokkos::deep_copy( fm->view( FieldLocation::Cell(), BarOut() ), -2.2 );
+    ParticleTile tile;
+    tile.tile_size = 3;
+    grid_op->apply( FieldLocation::Particle(), tile, TEST_EXECSPACE(), *fm,
+                    particles, particle_func );
+
+    // Check the tiled results.
+    Cabana::deep_copy( host_aosoa, particles.aosoa() );
+    for ( std::size_t p = 0; p < particles.size(); ++p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( foo_p_host( p, d ), 2.0 );
+        EXPECT_EQ( bar_p_host( p ), 3.0 );
+    }
+    Kokkos::deep_copy( foo_out_host,
+                       fm->view( FieldLocation::Cell(), FooOut() ) );
+    Kokkos::deep_copy( bar_out_host,
+                       fm->view( FieldLocation::Cell(), BarOut() ) );
+    Cajita::grid_parallel_for(
+        "check_grid_out", Kokkos::Serial(), *( mesh->localGrid() ),
+        Cajita::Own(), Cajita::Cell(),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            for ( int d = 0; d < 3; ++d )
+                EXPECT_EQ( foo_out_host( i, j, k, d ), ppc * 2.0 );
+            EXPECT_EQ( bar_out_host( i, j, k, 0 ), ppc * 3.0 );
+        } );
+
     // Apply the grid operator. Use a tag.
     GridFunc grid_func;
     grid_op->apply( FieldLocation::Cell(), TEST_EXECSPACE(), *fm,
@@ -277,11 +378,272 @@ void gatherScatterTest()
         } );
 }
 
+//---------------------------------------------------------------------------//
+void particleGatherTest()
+{
+    // Global bounding box.
+    double cell_size = 0.23;
+    std::array<int, 3> global_num_cell = { 43, 32, 39 };
+    std::array<double, 3> global_low_corner = { 1.2, 3.3, -2.8 };
+    std::array<double, 3> global_high_corner = {
+        global_low_corner[0] + cell_size * global_num_cell[0],
+        global_low_corner[1] + cell_size * global_num_cell[1],
+        global_low_corner[2] + cell_size * global_num_cell[2] };
+
+    // Get inputs for mesh.
+    InputParser parser( "particle_init_test.json", "json" );
+    Kokkos::Array<double, 6> global_box = {
+        global_low_corner[0],  global_low_corner[1],  global_low_corner[2],
+        global_high_corner[0], global_high_corner[1], global_high_corner[2] };
+    int minimum_halo_size = 0;
+
+    // Make mesh.
+    auto mesh =
+        createUniformMesh( TEST_MEMSPACE(), parser.propertyTree(), global_box,
+                           minimum_halo_size, MPI_COMM_WORLD );
+
+    // Make a particle list.
+    using list_type = ParticleList<UniformMesh<TEST_MEMSPACE>,
+                                   Field::LogicalPosition, FooP, BarP>;
+    list_type particles( "test_particles", mesh );
+    using particle_type = typename list_type::particle_type;
+
+    // Particle initialization functor. Give the particles position-dependent
+    // data so the grid results depend on summation order.
+    auto particle_init_func =
+        KOKKOS_LAMBDA( const double x[3], const double, particle_type& p )
+    {
+        for ( int d = 0; d < 3; ++d )
+        {
+            get( p, Field::LogicalPosition(), d ) = x[d];
+            get( p, FooP(), d ) = x[d] * x[d];
+        }
+        get( p, BarP() ) = x[0] * x[1] - x[2];
+        return true;
+    };
+
+    // Initialize particles.
+    int ppc = 10;
+    initializeParticles( InitRandom(), TEST_EXECSPACE(), ppc,
+                         particle_init_func, particles );
+
+    // Make an operator.
+    using scatter_deps =
+        ScatterDependencies<FieldLayout<FieldLocation::Node, FooOut>,
+                            FieldLayout<FieldLocation::Node, BarOut>>;
+    auto grid_op = createGridOperator( mesh, scatter_deps() );
+
+    // Make a field manager.
+    auto fm = createFieldManager( mesh );
+
+    // Setup the field manager.
+    grid_op->setup( *fm );
+
+    // Apply the particle operator as a scatter.
+    ParticleP2GFunc particle_func;
+    grid_op->apply( FieldLocation::Particle(), TEST_EXECSPACE(), *fm, particles,
+                    particle_func );
+    auto foo_scatter = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), fm->view( FieldLocation::Node(), FooOut() ) );
+    auto bar_scatter = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), fm->view( FieldLocation::Node(), BarOut() ) );
+
+    // Initialize the scatter fields to wrong data to make sure they get
+    // overwritten in gather mode.
+    Kokkos::deep_copy( fm->view( FieldLocation::Node(), FooOut() ), -1.1 );
+    Kokkos::deep_copy( fm->view( FieldLocation::Node(), BarOut() ), -2.2 );
+
+    // Apply the particle operator as a gather.
+    grid_op->apply( FieldLocation::Particle(), ParticleGather(),
+                    TEST_EXECSPACE(), *fm, particles, particle_func );
+    auto foo_gather = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), fm->view( FieldLocation::Node(), FooOut() ) );
+    auto bar_gather = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), fm->view( FieldLocation::Node(), BarOut() ) );
+
+    // Apply the gather again. The results must be bitwise identical between
+    // runs.
+    Kokkos::deep_copy( fm->view( FieldLocation::Node(), FooOut() ), -1.1 );
+    Kokkos::deep_copy( fm->view( FieldLocation::Node(), BarOut() ), -2.2 );
+    grid_op->apply( FieldLocation::Particle(), ParticleGather(),
+                    TEST_EXECSPACE(), *fm, particles, particle_func );
+    auto foo_rerun = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), fm->view( FieldLocation::Node(), FooOut() ) );
+    auto bar_rerun = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), fm->view( FieldLocation::Node(), BarOut() ) );
+
+    // Apply the gather again with the support of the linear spline used by
+    // the kernel. The results must be bitwise identical.
+    ParticleGather linear_gather;
+    linear_gather.spline_order = 1;
+    grid_op->apply( FieldLocation::Particle(), linear_gather, TEST_EXECSPACE(),
+                    *fm, particles, particle_func );
+    auto foo_linear = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), fm->view( FieldLocation::Node(), FooOut() ) );
+    auto bar_linear = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), fm->view( FieldLocation::Node(), BarOut() ) );
+
+    // A spline order above cubic is not supported.
+    ParticleGather quartic_gather;
+    quartic_gather.spline_order = 4;
+    EXPECT_THROW( grid_op->apply( FieldLocation::Particle(), quartic_gather,
+                                  TEST_EXECSPACE(), *fm, particles,
+                                  particle_func ),
+                  std::runtime_error );
+
+    // Check the grid results. Scatter and gather modes only differ in
+    // summation order.
+    Cajita::grid_parallel_for(
+        "check_grid_out", Kokkos::Serial(), *( mesh->localGrid() ),
+        Cajita::Own(), Cajita::Node(),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            for ( int d = 0; d < 3; ++d )
+            {
+                EXPECT_NEAR( foo_gather( i, j, k, d ),
+                             foo_scatter( i, j, k, d ),
+                             1.0e-12 * fabs( foo_scatter( i, j, k, d ) ) +
+                                 1.0e-12 );
+                EXPECT_EQ( foo_rerun( i, j, k, d ), foo_gather( i, j, k, d ) );
+                EXPECT_EQ( foo_linear( i, j, k, d ),
+                           foo_gather( i, j, k, d ) );
+            }
+            EXPECT_NEAR( bar_gather( i, j, k, 0 ), bar_scatter( i, j, k, 0 ),
+                         1.0e-12 * fabs( bar_scatter( i, j, k, 0 ) ) +
+                             1.0e-12 );
+            EXPECT_EQ( bar_rerun( i, j, k, 0 ), bar_gather( i, j, k, 0 ) );
+            EXPECT_EQ( bar_linear( i, j, k, 0 ), bar_gather( i, j, k, 0 ) );
+        } );
+}
+
+//---------------------------------------------------------------------------//
+void particleTileTest()
+{
+    // Global bounding box.
+    double cell_size = 0.5;
+    std::array<int, 3> global_num_cell = { 17, 14, 15 };
+    std::array<double, 3> global_low_corner = { -1.5, 0.5, 2.0 };
+    std::array<double, 3> global_high_corner = {
+        global_low_corner[0] + cell_size * global_num_cell[0],
+        global_low_corner[1] + cell_size * global_num_cell[1],
+        global_low_corner[2] + cell_size * global_num_cell[2] };
+
+    // Get inputs for mesh. The mesh is not periodic so the linear field is
+    // continuous in the halo.
+    InputParser parser( "polypic_test.json", "json" );
+    Kokkos::Array<double, 6> global_box = {
+        global_low_corner[0],  global_low_corner[1],  global_low_corner[2],
+        global_high_corner[0], global_high_corner[1], global_high_corner[2] };
+    int minimum_halo_size = 2;
+
+    // Make mesh.
+    auto mesh =
+        createUniformMesh( TEST_MEMSPACE(), parser.propertyTree(), global_box,
+                           minimum_halo_size, MPI_COMM_WORLD );
+
+    // Make a particle list.
+    using list_type = ParticleList<UniformMesh<TEST_MEMSPACE>,
+                                   Field::LogicalPosition, FooP, Baz>;
+    list_type particles( "test_particles", mesh );
+    using particle_type = typename list_type::particle_type;
+
+    // Particle initialization functor. Make particles everywhere.
+    auto particle_init_func =
+        KOKKOS_LAMBDA( const double x[3], const double, particle_type& p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            get( p, Field::LogicalPosition(), d ) = x[d];
+        return true;
+    };
+
+    // Initialize particles.
+    int ppc = 8;
+    initializeParticles( InitRandom(), TEST_EXECSPACE(), ppc,
+                         particle_init_func, particles );
+
+    // Make an operator.
+    using gather_deps =
+        GatherDependencies<FieldLayout<FieldLocation::Node, FooIn>>;
+    auto grid_op = createGridOperator( mesh, gather_deps() );
+
+    // Make a field manager.
+    auto fm = createFieldManager( mesh );
+
+    // Setup the field manager.
+    grid_op->setup( *fm );
+
+    // Initialize a linear grid field including the halo.
+    auto local_mesh =
+        Cajita::createLocalMesh<TEST_EXECSPACE>( *( mesh->localGrid() ) );
+    auto foo_in = fm->view( FieldLocation::Node(), FooIn() );
+    Cajita::grid_parallel_for(
+        "init_linear_field", TEST_EXECSPACE(), *( mesh->localGrid() ),
+        Cajita::Ghost(), Cajita::Node(),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            int index[3] = { i, j, k };
+            double x[3];
+            local_mesh.coordinates( Cajita::Node(), index, x );
+            for ( int d = 0; d < 3; ++d )
+                foo_in( i, j, k, d ) =
+                    1.0 + ( d + 1.0 ) * x[0] - 0.5 * x[1] + 0.25 * d * x[2];
+        } );
+
+    // Apply the particle operator in the default particle loop.
+    ParticleAPICFunc particle_func;
+    grid_op->apply( FieldLocation::Particle(), TEST_EXECSPACE(), *fm, particles,
+                    particle_func );
+    auto host_aosoa = Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(),
+                                                           particles.aosoa() );
+    auto x_p_host = Cabana::slice<0>( host_aosoa );
+    auto foo_p_host = Cabana::slice<1>( host_aosoa );
+    auto baz_p_host = Cabana::slice<2>( host_aosoa );
+
+    // A cubic spline reproduces the linear field.
+    for ( std::size_t p = 0; p < particles.size(); ++p )
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_NEAR( foo_p_host( p, d ),
+                         1.0 + ( d + 1.0 ) * x_p_host( p, 0 ) -
+                             0.5 * x_p_host( p, 1 ) +
+                             0.25 * d * x_p_host( p, 2 ),
+                         1.0e-10 );
+
+    // Apply the particle operator again in tiles which do not evenly divide
+    // the local grid. Tiles read the same entities in the same order so the
+    // results must be bitwise identical.
+    auto tile_aosoa = Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(),
+                                                           particles.aosoa() );
+    auto foo_p_tile = Cabana::slice<1>( tile_aosoa );
+    auto baz_p_tile = Cabana::slice<2>( tile_aosoa );
+    ParticleTile tile;
+    tile.tile_size = 3;
+    grid_op->apply( FieldLocation::Particle(), tile, TEST_EXECSPACE(), *fm,
+                    particles, particle_func );
+    Cabana::deep_copy( tile_aosoa, particles.aosoa() );
+    for ( std::size_t p = 0; p < particles.size(); ++p )
+        for ( int i = 0; i < 3; ++i )
+        {
+            EXPECT_EQ( foo_p_tile( p, i ), foo_p_host( p, i ) );
+            for ( int j = 0; j < 3; ++j )
+                EXPECT_EQ( baz_p_tile( p, i, j ), baz_p_host( p, i, j ) );
+        }
+
+    // Tiles which do not fit in the requested scratch level are rejected.
+    ParticleTile large_tile;
+    large_tile.tile_size = 64;
+    EXPECT_THROW( grid_op->apply( FieldLocation::Particle(), large_tile,
+                                  TEST_EXECSPACE(), *fm, particles,
+                                  particle_func ),
+                  std::runtime_error );
+}
+
 //---------------------------------------------------------------------------//
 // RUN TESTS
 //---------------------------------------------------------------------------//
 TEST( TEST_CATEGORY, gather_scatter_test ) { gatherScatterTest(); }
 
+TEST( TEST_CATEGORY, particle_gather_test ) { particleGatherTest(); }
+
+TEST( TEST_CATEGORY, particle_tile_test ) { particleTileTest(); }
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
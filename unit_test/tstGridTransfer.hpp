@@ -0,0 +1,164 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Picasso_GridTransfer.hpp>
+#include <Picasso_InputParser.hpp>
+#include <Picasso_Types.hpp>
+#include <Picasso_UniformMesh.hpp>
+
+#include <Cajita.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+using namespace Picasso;
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+// Linear function reproduced exactly by both transfers.
+KOKKOS_INLINE_FUNCTION
+double linearFunction( const double x[3], const int n )
+{
+    return 1.0 + n + 2.0 * x[0] - x[1] + 3.0 * x[2];
+}
+
+//---------------------------------------------------------------------------//
+// Assign the linear function to all entities of an array including the
+// ghosts so no halo exchange is needed.
+template <class ArrayType>
+void assignLinear( ArrayType& array )
+{
+    using entity_type = typename ArrayType::entity_type;
+    auto local_grid = array.layout()->localGrid();
+    auto local_mesh = Cajita::createLocalMesh<TEST_MEMSPACE>( *local_grid );
+    auto view = array.view();
+    int num_dof = view.extent( 3 );
+    auto ghost_entities = local_grid->indexSpace(
+        Cajita::Ghost(), entity_type(), Cajita::Local() );
+    Kokkos::parallel_for(
+        "assign_linear",
+        Cajita::createExecutionPolicy( ghost_entities, TEST_EXECSPACE() ),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            int entity_index[3] = { i, j, k };
+            double x[3];
+            local_mesh.coordinates( entity_type(), entity_index, x );
+            for ( int n = 0; n < num_dof; ++n )
+                view( i, j, k, n ) = linearFunction( x, n );
+        } );
+}
+
+//---------------------------------------------------------------------------//
+// Check the owned entities of an array have the linear function.
+template <class ArrayType>
+void checkLinear( const ArrayType& array )
+{
+    using entity_type = typename ArrayType::entity_type;
+    auto local_grid = array.layout()->localGrid();
+    auto local_mesh =
+        Cajita::createLocalMesh<Kokkos::HostSpace>( *local_grid );
+    auto host_view = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(),
+                                                          array.view() );
+    int num_dof = host_view.extent( 3 );
+    auto own_entities = local_grid->indexSpace( Cajita::Own(), entity_type(),
+                                                Cajita::Local() );
+    for ( int i = own_entities.min( Dim::I ); i < own_entities.max( Dim::I );
+          ++i )
+        for ( int j = own_entities.min( Dim::J );
+              j < own_entities.max( Dim::J ); ++j )
+            for ( int k = own_entities.min( Dim::K );
+                  k < own_entities.max( Dim::K ); ++k )
+            {
+                int entity_index[3] = { i, j, k };
+                double x[3];
+                local_mesh.coordinates( entity_type(), entity_index, x );
+                for ( int n = 0; n < num_dof; ++n )
+                    EXPECT_NEAR( host_view( i, j, k, n ),
+                                 linearFunction( x, n ), 1.0e-10 );
+            }
+}
+
+//---------------------------------------------------------------------------//
+template <class EntityType>
+void transferTest( const EntityType entity_type )
+{
+    // Global parameters.
+    Kokkos::Array<double, 6> global_box = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
+    int minimum_halo_size = 2;
+
+    // Make a mesh and a 2x coarser mesh.
+    InputParser parser( "level_set_redistance_test.json", "json" );
+    auto pt = parser.propertyTree();
+    auto fine_mesh = createUniformMesh( TEST_MEMSPACE(), pt, global_box,
+                                        minimum_halo_size, MPI_COMM_WORLD );
+    auto coarse_mesh = createUniformMesh( *fine_mesh, 2.0, minimum_halo_size );
+
+    // Make arrays with multiple degrees of freedom.
+    auto fine_layout =
+        Cajita::createArrayLayout( fine_mesh->localGrid(), 3, entity_type );
+    auto fine = Cajita::createArray<double, TEST_MEMSPACE>( "fine",
+                                                            fine_layout );
+    auto coarse_layout =
+        Cajita::createArrayLayout( coarse_mesh->localGrid(), 3, entity_type );
+    auto coarse = Cajita::createArray<double, TEST_MEMSPACE>( "coarse",
+                                                              coarse_layout );
+
+    // Average from the fine mesh to the coarse mesh.
+    assignLinear( *fine );
+    GridTransfer::average( TEST_EXECSPACE(), *fine, *coarse );
+    checkLinear( *coarse );
+
+    // Interpolate from the coarse mesh to the fine mesh.
+    Cajita::ArrayOp::assign( *fine, 0.0, Cajita::Ghost() );
+    assignLinear( *coarse );
+    GridTransfer::interpolate( TEST_EXECSPACE(), *coarse, *fine );
+    checkLinear( *fine );
+
+    // Averaging preserves the integral of a field over the domain. Check
+    // with a field that is only nonzero in a single fine entity.
+    Cajita::ArrayOp::assign( *fine, 0.0, Cajita::Ghost() );
+    auto fine_view = fine->view();
+    auto own_fine = fine_mesh->localGrid()->indexSpace(
+        Cajita::Own(), entity_type, Cajita::Local() );
+    int fi = own_fine.min( Dim::I ) + 1;
+    int fj = own_fine.min( Dim::J ) + 1;
+    int fk = own_fine.min( Dim::K ) + 1;
+    Kokkos::parallel_for(
+        "assign_spike", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, 1 ),
+        KOKKOS_LAMBDA( const int ) { fine_view( fi, fj, fk, 0 ) = 1.0; } );
+    GridTransfer::average( TEST_EXECSPACE(), *fine, *coarse );
+    auto host_coarse = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), coarse->view() );
+    auto own_coarse = coarse_mesh->localGrid()->indexSpace(
+        Cajita::Own(), entity_type, Cajita::Local() );
+    double coarse_sum = 0.0;
+    for ( int i = own_coarse.min( Dim::I ); i < own_coarse.max( Dim::I ); ++i )
+        for ( int j = own_coarse.min( Dim::J ); j < own_coarse.max( Dim::J );
+              ++j )
+            for ( int k = own_coarse.min( Dim::K );
+                  k < own_coarse.max( Dim::K ); ++k )
+                coarse_sum += host_coarse( i, j, k, 0 );
+    EXPECT_DOUBLE_EQ( coarse_sum * 8.0, 1.0 );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, node_transfer_test ) { transferTest( Cajita::Node() ); }
+
+TEST( TEST_CATEGORY, cell_transfer_test ) { transferTest( Cajita::Cell() ); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
@@ -11,6 +11,10 @@
 
 #include <Picasso_InputParser.hpp>
 
+#include <mpi.h>
+
+#include <stdexcept>
+
 #include <gtest/gtest.h>
 
 namespace Test
@@ -86,6 +90,18 @@ TEST( input_parser, xml_file_test )
     testParser( parser );
 }
 
+//---------------------------------------------------------------------------//
+TEST( input_parser, comm_test )
+{
+    Picasso::InputParser parser( "input_parser_test.json", "json",
+                                 MPI_COMM_SELF );
+    testParser( parser );
+
+    // All ranks throw if the file can not be read.
+    EXPECT_THROW( Picasso::InputParser( "missing_input.json", "json" ),
+                  std::runtime_error );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
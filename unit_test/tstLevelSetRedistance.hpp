@@ -20,6 +20,8 @@
 #include <Kokkos_Core.hpp>
 
 #include <cmath>
+#include <stdexcept>
+#include <string>
 
 #include <gtest/gtest.h>
 
@@ -34,7 +36,11 @@ struct ErrorField : public Field::Scalar<double>
 
 //---------------------------------------------------------------------------//
 template <class Phi0, class PhiR>
-void runTest( const Phi0& phi_0, const PhiR& phi_r, const double test_eps )
+void runTest( const Phi0& phi_0, const PhiR& phi_r, const double test_eps,
+              const std::string& method = "hopf_lax",
+              const bool warm_start = false, const int num_level = 2,
+              const bool redundant_ghosts = false,
+              const double cell_size_ratio = 1.0 )
 {
     // Global parameters.
     Kokkos::Array<double, 6> global_box = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
@@ -42,16 +48,28 @@ void runTest( const Phi0& phi_0, const PhiR& phi_r, const double test_eps )
     // Get inputs for mesh.
     InputParser parser( "level_set_redistance_test.json", "json" );
     auto pt = parser.propertyTree();
-
-    // Make mesh.
-    int minimum_halo_size = 4;
-    auto mesh = createUniformMesh( TEST_MEMSPACE(), pt, global_box,
-                                   minimum_halo_size, MPI_COMM_WORLD );
+    pt.put( "level_set.redistance_method", method );
+    pt.put( "level_set.redistance_warm_start", warm_start );
+    pt.put( "level_set.redistance_num_level", num_level );
+    pt.put( "level_set.redistance_redundant_ghosts", redundant_ghosts );
+    pt.put( "level_set.cell_size_ratio", cell_size_ratio );
+
+    // Make mesh. Redundant ghost redistancing needs a wider halo to resolve
+    // the same narrow band.
+    int resolved_halo_size = 4;
+    int minimum_halo_size = resolved_halo_size;
+    if ( redundant_ghosts )
+        minimum_halo_size += 1 << ( num_level - 1 );
+    auto sim_mesh = createUniformMesh( TEST_MEMSPACE(), pt, global_box,
+                                       minimum_halo_size, MPI_COMM_WORLD );
+
+    // Create a level set. It may have a different resolution than the
+    // simulation mesh so use its own mesh for the rest of the test.
+    auto level_set = createLevelSet<FieldLocation::Node>( pt, sim_mesh );
+    auto mesh = level_set->mesh();
     auto dx = mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
-    auto halo_width = dx * minimum_halo_size;
-
-    // Create a level set.
-    auto level_set = createLevelSet<FieldLocation::Node>( pt, mesh );
+    EXPECT_DOUBLE_EQ( dx, cell_size_ratio * sim_mesh->cellSize() );
+    auto halo_width = dx * resolved_halo_size;
 
     // Signed distance fields.
     auto estimate = level_set->getDistanceEstimate();
@@ -65,26 +83,31 @@ void runTest( const Phi0& phi_0, const PhiR& phi_r, const double test_eps )
     auto local_mesh =
         Cajita::createLocalMesh<TEST_MEMSPACE>( *( mesh->localGrid() ) );
 
-    // Populate the initial estimate.
+    // Populate the initial estimate and redistance. When warm starting,
+    // redistance twice with the second warm started from the first.
     auto own_entities = mesh->localGrid()->indexSpace(
         Cajita::Own(), Cajita::Node(), Cajita::Local() );
-    Kokkos::parallel_for(
-        "estimate",
-        Cajita::createExecutionPolicy( own_entities, TEST_EXECSPACE() ),
-        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
-            // Get the entity index.
-            int entity_index[3] = { i, j, k };
+    int num_redistance = warm_start ? 2 : 1;
+    for ( int n = 0; n < num_redistance; ++n )
+    {
+        Kokkos::parallel_for(
+            "estimate",
+            Cajita::createExecutionPolicy( own_entities, TEST_EXECSPACE() ),
+            KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+                // Get the entity index.
+                int entity_index[3] = { i, j, k };
 
-            // Get the entity location.
-            double x[3];
-            local_mesh.coordinates( Cajita::Node(), entity_index, x );
+                // Get the entity location.
+                double x[3];
+                local_mesh.coordinates( Cajita::Node(), entity_index, x );
 
-            // Assign the estimate value.
-            estimate_view( i, j, k, 0 ) = phi_0( x[0], x[1], x[2] );
-        } );
+                // Assign the estimate value.
+                estimate_view( i, j, k, 0 ) = phi_0( x[0], x[1], x[2] );
+            } );
 
-    // Redistance.
-    level_set->redistance( TEST_EXECSPACE() );
+        // Redistance.
+        level_set->redistance( TEST_EXECSPACE() );
+    }
 
     // Test epsilon. Our grid is pretty coarse so this is pretty large with
     // respect to the analytic value. This still means we are resolving the
@@ -137,6 +160,65 @@ void runTest( const Phi0& phi_0, const PhiR& phi_r, const double test_eps )
                 }
             }
         } );
+
+    // If the level set has a different resolution than the simulation mesh
+    // transfer the distance to the simulation mesh and check it there within
+    // a level set cell of the narrow band edge.
+    if ( cell_size_ratio != 1.0 )
+    {
+        auto sim_distance = createArray( *sim_mesh, FieldLocation::Node(),
+                                         Field::SignedDistance() );
+        level_set->transferSignedDistance( TEST_EXECSPACE(), *sim_distance );
+        auto host_sim_distance = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(), sim_distance->view() );
+        auto host_sim_mesh = Cajita::createLocalMesh<Kokkos::HostSpace>(
+            *( sim_mesh->localGrid() ) );
+        auto sim_entities = sim_mesh->localGrid()->indexSpace(
+            Cajita::Own(), Cajita::Node(), Cajita::Local() );
+        Kokkos::parallel_for(
+            "test_transfer",
+            Cajita::createExecutionPolicy( sim_entities, Kokkos::Serial() ),
+            [=]( const int i, const int j, const int k ) {
+                int entity_index[3] = { i, j, k };
+                double x[3];
+                host_sim_mesh.coordinates( Cajita::Node(), entity_index, x );
+                auto expected = phi_r( x[0], x[1], x[2] );
+                if ( fabs( expected ) < halo_width - tolerance - dx )
+                {
+                    EXPECT_NEAR( expected, host_sim_distance( i, j, k, 0 ),
+                                 tolerance );
+                }
+            } );
+    }
+
+    // Check the narrow band. Every entity is either active or in the far
+    // field where it has the band width with the sign of the distance.
+    const auto& band = level_set->narrowBand();
+    EXPECT_EQ( band.width(), level_set->bandWidth() );
+    EXPECT_TRUE( band.size() > 0 );
+    auto host_band_entities = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), band.entities() );
+    Kokkos::View<int***, Kokkos::HostSpace> active(
+        "active", host_distance.extent( 0 ), host_distance.extent( 1 ),
+        host_distance.extent( 2 ) );
+    for ( int n = 0; n < band.size(); ++n )
+    {
+        int i = host_band_entities( n, Dim::I );
+        int j = host_band_entities( n, Dim::J );
+        int k = host_band_entities( n, Dim::K );
+        EXPECT_EQ( active( i, j, k ), 0 );
+        active( i, j, k ) = 1;
+    }
+    double width = band.width();
+    Kokkos::parallel_for(
+        "test_band",
+        Cajita::createExecutionPolicy( own_entities, Kokkos::Serial() ),
+        [=]( const int i, const int j, const int k ) {
+            if ( !active( i, j, k ) )
+            {
+                EXPECT_EQ( fabs( host_distance( i, j, k, 0 ) ), width );
+            }
+        } );
 }
 
 void sphere_redistance()
@@ -195,6 +277,429 @@ void scaled_sphere_redistance()
     runTest( phi_0, phi_r, 0.5 );
 }
 
+//---------------------------------------------------------------------------//
+void scaled_sphere_warm_start_redistance()
+{
+    // Scaled sphere with radius of 0.25 centered at (0.5,0.5,0.5).
+
+    // Initial data.
+    auto phi_0 = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return 2.8 * ( exp( r - 0.25 ) - 1.0 );
+    };
+
+    // Actual distance.
+    auto phi_r = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return r - 0.25;
+    };
+
+    // Test. The warm started result should have the same accuracy as the
+    // cold start.
+    runTest( phi_0, phi_r, 0.5, "hopf_lax", true );
+}
+
+//---------------------------------------------------------------------------//
+void moving_sphere_warm_start_redistance()
+{
+    // Global parameters.
+    Kokkos::Array<double, 6> global_box = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
+
+    // Get inputs for mesh.
+    InputParser parser( "level_set_redistance_test.json", "json" );
+    auto pt = parser.propertyTree();
+    pt.put( "level_set.redistance_warm_start", true );
+    auto cold_pt = pt;
+    cold_pt.put( "level_set.redistance_warm_start", false );
+
+    // Make mesh.
+    int halo_size = 4;
+    auto mesh = createUniformMesh( TEST_MEMSPACE(), pt, global_box, halo_size,
+                                   MPI_COMM_WORLD );
+    auto dx = mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
+    auto halo_width = dx * halo_size;
+
+    // Create a warm started level set and a cold started reference.
+    auto level_set = createLevelSet<FieldLocation::Node>( pt, mesh );
+    auto cold_level_set = createLevelSet<FieldLocation::Node>( cold_pt, mesh );
+    auto estimate_view = level_set->getDistanceEstimate()->view();
+    auto cold_estimate_view = cold_level_set->getDistanceEstimate()->view();
+
+    // Scaled sphere with radius of 0.25 centered at (c,0.5,0.5).
+    auto phi_0 = KOKKOS_LAMBDA( const double x, const double y, const double z,
+                                const double c )
+    {
+        double dx = c - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return 2.8 * ( exp( r - 0.25 ) - 1.0 );
+    };
+
+    // Redistance both level sets with the sphere at the given center.
+    auto local_mesh =
+        Cajita::createLocalMesh<TEST_MEMSPACE>( *( mesh->localGrid() ) );
+    auto own_entities = mesh->localGrid()->indexSpace(
+        Cajita::Own(), Cajita::Node(), Cajita::Local() );
+    auto redistance = [&]( const double c ) {
+        Kokkos::parallel_for(
+            "estimate",
+            Cajita::createExecutionPolicy( own_entities, TEST_EXECSPACE() ),
+            KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+                int entity_index[3] = { i, j, k };
+                double x[3];
+                local_mesh.coordinates( Cajita::Node(), entity_index, x );
+                estimate_view( i, j, k, 0 ) = phi_0( x[0], x[1], x[2], c );
+                cold_estimate_view( i, j, k, 0 ) =
+                    phi_0( x[0], x[1], x[2], c );
+            } );
+        level_set->redistance( TEST_EXECSPACE() );
+        cold_level_set->redistance( TEST_EXECSPACE() );
+    };
+
+    // Redistance and then move the sphere by more than a cell so the
+    // closest points of the first redistance are stale and entities enter
+    // and leave the band.
+    redistance( 0.5 );
+    redistance( 0.5 + 2.5 * dx );
+
+    // The warm started result should match the cold start.
+    double tolerance = 0.5 * dx;
+    auto host_distance = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), level_set->getSignedDistance()->view() );
+    auto host_cold_distance = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), cold_level_set->getSignedDistance()->view() );
+    Kokkos::parallel_for(
+        "test", Cajita::createExecutionPolicy( own_entities, Kokkos::Serial() ),
+        [=]( const int i, const int j, const int k ) {
+            double cold = host_cold_distance( i, j, k, 0 );
+            if ( fabs( cold ) < halo_width - tolerance )
+            {
+                EXPECT_NEAR( cold, host_distance( i, j, k, 0 ), tolerance );
+            }
+        } );
+}
+
+//---------------------------------------------------------------------------//
+void scaled_sphere_multilevel_redistance()
+{
+    // Scaled sphere with radius of 0.25 centered at (0.5,0.5,0.5).
+
+    // Initial data.
+    auto phi_0 = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return 2.8 * ( exp( r - 0.25 ) - 1.0 );
+    };
+
+    // Actual distance.
+    auto phi_r = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return r - 0.25;
+    };
+
+    // Test with 4:1, 2:1, and fine levels.
+    runTest( phi_0, phi_r, 0.5, "hopf_lax", false, 3 );
+}
+
+//---------------------------------------------------------------------------//
+void scaled_sphere_redundant_ghost_redistance()
+{
+    // Scaled sphere with radius of 0.25 centered at (0.5,0.5,0.5).
+
+    // Initial data.
+    auto phi_0 = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return 2.8 * ( exp( r - 0.25 ) - 1.0 );
+    };
+
+    // Actual distance.
+    auto phi_r = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return r - 0.25;
+    };
+
+    // Test with a single gather per redistance.
+    runTest( phi_0, phi_r, 0.5, "hopf_lax", false, 2, true );
+}
+
+//---------------------------------------------------------------------------//
+void scaled_sphere_coarse_redistance()
+{
+    // Scaled sphere with radius of 0.25 centered at (0.5,0.5,0.5).
+
+    // Initial data.
+    auto phi_0 = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return 2.8 * ( exp( r - 0.25 ) - 1.0 );
+    };
+
+    // Actual distance.
+    auto phi_r = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return r - 0.25;
+    };
+
+    // Test on a level set mesh 2x coarser than the simulation mesh.
+    runTest( phi_0, phi_r, 0.5, "hopf_lax", false, 2, false, 2.0 );
+}
+
+//---------------------------------------------------------------------------//
+void sphere_fast_sweeping_redistance()
+{
+    // Sphere with radius of 0.25 centered at (0.5,0.5,0.5)
+    auto phi_r = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return r - 0.25;
+    };
+
+    // Test. Fast sweeping is first-order accurate so use a tolerance of a
+    // full cell width.
+    runTest( phi_r, phi_r, 1.0, "fast_sweeping" );
+}
+
+//---------------------------------------------------------------------------//
+void scaled_sphere_fast_sweeping_redistance()
+{
+    // Scaled sphere with radius of 0.25 centered at (0.5,0.5,0.5).
+
+    // Initial data.
+    auto phi_0 = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return 2.8 * ( exp( r - 0.25 ) - 1.0 );
+    };
+
+    // Actual distance.
+    auto phi_r = KOKKOS_LAMBDA( const double x, const double y, const double z )
+    {
+
+        double dx = 0.5 - x;
+        double dy = 0.5 - y;
+        double dz = 0.5 - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return r - 0.25;
+    };
+
+    // Test. Fast sweeping is first-order accurate so use a tolerance of a
+    // full cell width.
+    runTest( phi_0, phi_r, 1.0, "fast_sweeping" );
+}
+
+//---------------------------------------------------------------------------//
+void sphere_advection()
+{
+    // Global parameters.
+    Kokkos::Array<double, 6> global_box = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
+
+    // Get inputs for mesh. Only monitor the number of steps.
+    InputParser parser( "level_set_redistance_test.json", "json" );
+    auto pt = parser.propertyTree();
+    int max_steps = 4;
+    pt.put( "level_set.advect_max_steps", max_steps );
+    pt.put( "level_set.advect_max_displacement", 100.0 );
+    pt.put( "level_set.advect_max_gradient_error", 100.0 );
+
+    // Make mesh.
+    int halo_size = 4;
+    auto mesh = createUniformMesh( TEST_MEMSPACE(), pt, global_box, halo_size,
+                                   MPI_COMM_WORLD );
+    auto dx = mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
+    auto halo_width = dx * halo_size;
+
+    // Create a level set.
+    auto level_set = createLevelSet<FieldLocation::Node>( pt, mesh );
+    auto estimate_view = level_set->getDistanceEstimate()->view();
+    auto distance_view = level_set->getSignedDistance()->view();
+
+    // Sphere with radius of 0.25 centered at (0.5,0.5,0.5) moving with a
+    // uniform velocity.
+    double dt = 0.1;
+    double u[3] = { 0.5 * dx / dt, -0.25 * dx / dt, 0.125 * dx / dt };
+    auto phi_r = KOKKOS_LAMBDA( const double x, const double y, const double z,
+                                const double t )
+    {
+        double dx = 0.5 + u[0] * t - x;
+        double dy = 0.5 + u[1] * t - y;
+        double dz = 0.5 + u[2] * t - z;
+        double r = sqrt( dx * dx + dy * dy + dz * dz );
+
+        return r - 0.25;
+    };
+
+    // Populate the estimate with the initial distance and redistance.
+    auto local_mesh =
+        Cajita::createLocalMesh<TEST_MEMSPACE>( *( mesh->localGrid() ) );
+    auto own_entities = mesh->localGrid()->indexSpace(
+        Cajita::Own(), Cajita::Node(), Cajita::Local() );
+    Kokkos::parallel_for(
+        "estimate",
+        Cajita::createExecutionPolicy( own_entities, TEST_EXECSPACE() ),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            int entity_index[3] = { i, j, k };
+            double x[3];
+            local_mesh.coordinates( Cajita::Node(), entity_index, x );
+            estimate_view( i, j, k, 0 ) = phi_r( x[0], x[1], x[2], 0.0 );
+        } );
+    level_set->redistance( TEST_EXECSPACE() );
+
+    // Uniform grid velocity.
+    Kokkos::View<double****, TEST_MEMSPACE> velocity(
+        "velocity", distance_view.extent( 0 ), distance_view.extent( 1 ),
+        distance_view.extent( 2 ), 3 );
+    Kokkos::parallel_for(
+        "velocity",
+        Cajita::createExecutionPolicy( own_entities, TEST_EXECSPACE() ),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            for ( int d = 0; d < 3; ++d )
+                velocity( i, j, k, d ) = u[d];
+        } );
+
+    // Advect until a rebuild is needed.
+    for ( int n = 0; n < max_steps; ++n )
+    {
+        EXPECT_FALSE( level_set->needsRebuild() );
+        level_set->advect( TEST_EXECSPACE(), velocity, dt );
+        EXPECT_EQ( level_set->advectSteps(), n + 1 );
+    }
+    EXPECT_TRUE( level_set->needsRebuild() );
+    double speed = sqrt( u[0] * u[0] + u[1] * u[1] + u[2] * u[2] );
+    EXPECT_NEAR( level_set->advectDisplacement(), max_steps * dt * speed,
+                 1.0e-12 );
+
+    // The distance within the band should follow the sphere. Linear
+    // interpolation diffuses the smooth solution only slightly.
+    double t = max_steps * dt;
+    double tolerance = 0.25 * dx;
+    auto host_distance = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), distance_view );
+    auto host_mesh =
+        Cajita::createLocalMesh<Kokkos::HostSpace>( *( mesh->localGrid() ) );
+    Kokkos::parallel_for(
+        "test", Cajita::createExecutionPolicy( own_entities, Kokkos::Serial() ),
+        [=]( const int i, const int j, const int k ) {
+            int entity_index[3] = { i, j, k };
+            double x[3];
+            host_mesh.coordinates( Cajita::Node(), entity_index, x );
+            double expected = phi_r( x[0], x[1], x[2], t );
+            if ( fabs( expected ) < halo_width - dx )
+            {
+                EXPECT_NEAR( expected, host_distance( i, j, k, 0 ),
+                             tolerance );
+            }
+        } );
+
+    // The monitored gradient error is that of the advected distance within
+    // the resolved band.
+    double threshold = dx * mesh->localGrid()->haloCellWidth();
+    double gradient_error = 0.0;
+    for ( int i = own_entities.min( Dim::I ); i < own_entities.max( Dim::I );
+          ++i )
+        for ( int j = own_entities.min( Dim::J );
+              j < own_entities.max( Dim::J ); ++j )
+            for ( int k = own_entities.min( Dim::K );
+                  k < own_entities.max( Dim::K ); ++k )
+                if ( fabs( host_distance( i, j, k, 0 ) ) < threshold )
+                {
+                    double gx = host_distance( i + 1, j, k, 0 ) -
+                                host_distance( i - 1, j, k, 0 );
+                    double gy = host_distance( i, j + 1, k, 0 ) -
+                                host_distance( i, j - 1, k, 0 );
+                    double gz = host_distance( i, j, k + 1, 0 ) -
+                                host_distance( i, j, k - 1, 0 );
+                    double error =
+                        fabs( 0.5 * sqrt( gx * gx + gy * gy + gz * gz ) / dx -
+                              1.0 );
+                    gradient_error =
+                        ( error > gradient_error ) ? error : gradient_error;
+                }
+    MPI_Allreduce( MPI_IN_PLACE, &gradient_error, 1, MPI_DOUBLE, MPI_MAX,
+                   MPI_COMM_WORLD );
+    EXPECT_NEAR( level_set->advectGradientError(), gradient_error, 1.0e-12 );
+
+    // The band follows the advected distance.
+    const auto& band = level_set->narrowBand();
+    auto host_band_entities = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), band.entities() );
+    for ( int n = 0; n < band.size(); ++n )
+    {
+        int i = host_band_entities( n, Dim::I );
+        int j = host_band_entities( n, Dim::J );
+        int k = host_band_entities( n, Dim::K );
+        EXPECT_LT( fabs( host_distance( i, j, k, 0 ) ), band.width() );
+    }
+
+    // Redistancing resets the monitor.
+    level_set->redistance( TEST_EXECSPACE() );
+    EXPECT_FALSE( level_set->needsRebuild() );
+    EXPECT_EQ( level_set->advectSteps(), 0 );
+
+    // A step which traces entities past the halo is rejected.
+    double large_dt = 2.0 * halo_width / speed;
+    EXPECT_THROW( level_set->advect( TEST_EXECSPACE(), velocity, large_dt ),
+                  std::runtime_error );
+}
+
 //---------------------------------------------------------------------------//
 // RUN TESTS
 //---------------------------------------------------------------------------//
@@ -206,6 +711,38 @@ TEST( TEST_CATEGORY, scaled_sphere_redistance_test )
 {
     scaled_sphere_redistance();
 }
+TEST( TEST_CATEGORY, scaled_sphere_warm_start_redistance_test )
+{
+    scaled_sphere_warm_start_redistance();
+}
+TEST( TEST_CATEGORY, moving_sphere_warm_start_redistance_test )
+{
+    moving_sphere_warm_start_redistance();
+}
+TEST( TEST_CATEGORY, scaled_sphere_multilevel_redistance_test )
+{
+    scaled_sphere_multilevel_redistance();
+}
+TEST( TEST_CATEGORY, scaled_sphere_redundant_ghost_redistance_test )
+{
+    scaled_sphere_redundant_ghost_redistance();
+}
+TEST( TEST_CATEGORY, scaled_sphere_coarse_redistance_test )
+{
+    scaled_sphere_coarse_redistance();
+}
+TEST( TEST_CATEGORY, sphere_fast_sweeping_redistance_test )
+{
+    sphere_fast_sweeping_redistance();
+}
+TEST( TEST_CATEGORY, scaled_sphere_fast_sweeping_redistance_test )
+{
+    scaled_sphere_fast_sweeping_redistance();
+}
+TEST( TEST_CATEGORY, sphere_advection_test )
+{
+    sphere_advection();
+}
 
 //---------------------------------------------------------------------------//
 /*
@@ -22,6 +22,7 @@
 
 #include <mpi.h>
 
+#include <cmath>
 #include <memory>
 
 using namespace Picasso;
@@ -55,11 +56,12 @@ void redistributeTest( const Cajita::ManualPartitioner& partitioner,
     auto ghosted_cell_space =
         block->indexSpace( Cajita::Ghost(), Cajita::Cell(), Cajita::Local() );
     int num_particle = ghosted_cell_space.size();
-    using MemberTypes = Cabana::MemberTypes<double[3], int>;
+    using MemberTypes = Cabana::MemberTypes<double[3], int, int[3]>;
     using ParticleContainer = Cabana::AoSoA<MemberTypes, Kokkos::HostSpace>;
     ParticleContainer particles( "particles", num_particle );
     auto coords = Cabana::slice<0>( particles, "coords" );
     auto linear_ids = Cabana::slice<1>( particles, "linear_ids" );
+    auto cells = Cabana::slice<2>( particles, "cells" );
 
     // Put particles in the center of every cell including halo cells if we
     // have them. Their ids should be equivalent to that of the rank they are
@@ -95,6 +97,11 @@ void redistributeTest( const Cajita::ManualPartitioner& partitioner,
                                                           Dim::K ) +
                                     ( k + 0.5 ) * cell_size;
 
+                                // Set the local cell index.
+                                cells( pid, Dim::I ) = i;
+                                cells( pid, Dim::J ) = j;
+                                cells( pid, Dim::K ) = k;
+
                                 // Set the linear ids as the linear rank of
                                 // the neighbor.
                                 linear_ids( pid ) = neighbor_rank;
@@ -109,41 +116,68 @@ void redistributeTest( const Cajita::ManualPartitioner& partitioner,
     // Copy to the device space.
     particles.resize( num_particle );
 
-    auto particles_mirror =
-        Cabana::create_mirror_view_and_copy( TEST_DEVICE(), particles );
-
-    // Redistribute the particles.
-    ParticleCommunication::redistribute( *block, 0,
-                                         Cabana::slice<0>( particles_mirror ),
-                                         particles_mirror, true );
-
-    // Copy back to check.
-    particles = Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(),
-                                                     particles_mirror );
-    coords = Cabana::slice<0>( particles, "coords" );
-    linear_ids = Cabana::slice<1>( particles, "linear_ids" );
-
-    // Check that we got as many particles as we should have.
-    EXPECT_EQ( coords.size(), num_particle );
-    EXPECT_EQ( linear_ids.size(), num_particle );
-
-    // Check that all of the particle ids are equal to this rank id.
-    for ( int p = 0; p < num_particle; ++p )
-        EXPECT_EQ( linear_ids( p ), global_grid->blockId() );
+    // Redistribute the particles locating them by position and by their
+    // cell index.
+    for ( bool use_cell_index : { false, true } )
+    {
+        auto particles_mirror =
+            Cabana::create_mirror_view_and_copy( TEST_DEVICE(), particles );
+
+        // Redistribute the particles.
+        if ( use_cell_index )
+            ParticleCommunication::redistribute(
+                *block, 0, Cabana::slice<0>( particles_mirror ),
+                Cabana::slice<2>( particles_mirror ), particles_mirror, true );
+        else
+            ParticleCommunication::redistribute(
+                *block, 0, Cabana::slice<0>( particles_mirror ),
+                particles_mirror, true );
+
+        // Copy back to check.
+        auto result = Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(),
+                                                           particles_mirror );
+        auto result_coords = Cabana::slice<0>( result, "coords" );
+        auto result_ids = Cabana::slice<1>( result, "linear_ids" );
+
+        // Check that we got as many particles as we should have.
+        EXPECT_EQ( result_coords.size(), num_particle );
+        EXPECT_EQ( result_ids.size(), num_particle );
+
+        // Check that all of the particle ids are equal to this rank id.
+        for ( int p = 0; p < num_particle; ++p )
+            EXPECT_EQ( result_ids( p ), global_grid->blockId() );
+
+        // Check that all of the particles are now in the local domain.
+        double low_c[3] = { local_mesh.lowCorner( Cajita::Own(), Dim::I ),
+                            local_mesh.lowCorner( Cajita::Own(), Dim::J ),
+                            local_mesh.lowCorner( Cajita::Own(), Dim::K ) };
+        double high_c[3] = { local_mesh.highCorner( Cajita::Own(), Dim::I ),
+                             local_mesh.highCorner( Cajita::Own(), Dim::J ),
+                             local_mesh.highCorner( Cajita::Own(), Dim::K ) };
+        for ( int p = 0; p < num_particle; ++p )
+            for ( int d = 0; d < 3; ++d )
+            {
+                EXPECT_TRUE( result_coords( p, d ) >= low_c[d] );
+                EXPECT_TRUE( result_coords( p, d ) <= high_c[d] );
+            }
 
-    // Check that all of the particles are now in the local domain.
-    double low_c[3] = { local_mesh.lowCorner( Cajita::Own(), Dim::I ),
-                        local_mesh.lowCorner( Cajita::Own(), Dim::J ),
-                        local_mesh.lowCorner( Cajita::Own(), Dim::K ) };
-    double high_c[3] = { local_mesh.highCorner( Cajita::Own(), Dim::I ),
-                         local_mesh.highCorner( Cajita::Own(), Dim::J ),
-                         local_mesh.highCorner( Cajita::Own(), Dim::K ) };
-    for ( int p = 0; p < num_particle; ++p )
-        for ( int d = 0; d < 3; ++d )
+        // Particles which left the owned cells have an invalid cell index.
+        // The index of the particles which stayed is still valid.
+        if ( use_cell_index )
         {
-            EXPECT_TRUE( coords( p, d ) >= low_c[d] );
-            EXPECT_TRUE( coords( p, d ) <= high_c[d] );
+            auto result_cells = Cabana::slice<2>( result, "cells" );
+            for ( int p = 0; p < num_particle; ++p )
+                for ( int d = 0; d < 3; ++d )
+                    if ( result_cells( p, d ) >= 0 )
+                        EXPECT_EQ(
+                            result_cells( p, d ),
+                            static_cast<int>( std::floor(
+                                ( result_coords( p, d ) -
+                                  local_mesh.lowCorner( Cajita::Ghost(),
+                                                        d ) ) /
+                                cell_size ) ) );
         }
+    }
 }
 
 //---------------------------------------------------------------------------//
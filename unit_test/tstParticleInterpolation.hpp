@@ -47,6 +47,21 @@ struct ParticleTensor : Field::Tensor<double, 3, 3>
     static std::string label() { return "particle_tensor"; }
 };
 
+struct ParticleScalarRef : Field::Scalar<double>
+{
+    static std::string label() { return "particle_scalar_ref"; }
+};
+
+struct ParticleVectorRef : Field::Vector<double, 3>
+{
+    static std::string label() { return "particle_vector_ref"; }
+};
+
+struct ParticleTensorRef : Field::Tensor<double, 3, 3>
+{
+    static std::string label() { return "particle_tensor_ref"; }
+};
+
 struct NodeScalar : Field::Scalar<double>
 {
     static std::string label() { return "node_scalar"; }
@@ -113,6 +128,40 @@ struct VectorValueP2G
     }
 };
 
+//---------------------------------------------------------------------------//
+struct MultiValueP2G
+{
+    template <class LocalMeshType, class GatherDependencies,
+              class ScatterDependencies, class LocalDependencies,
+              class ParticleViewType>
+    KOKKOS_INLINE_FUNCTION void
+    operator()( const LocalMeshType& local_mesh, const GatherDependencies&,
+                const ScatterDependencies& scatter_deps,
+                const LocalDependencies&, ParticleViewType& particle ) const
+    {
+        // Get output dependencies.
+        auto node_scalar =
+            scatter_deps.get( FieldLocation::Node(), NodeScalar() );
+        auto node_vector =
+            scatter_deps.get( FieldLocation::Node(), NodeVector() );
+
+        // Get particle data.
+        auto particle_scalar = get( particle, ParticleScalar() );
+        auto particle_vector = get( particle, ParticleVector() );
+
+        // Node Interpolant
+        auto spline = createSpline(
+            FieldLocation::Node(), InterpolationOrder<1>(), local_mesh,
+            get( particle, Field::LogicalPosition() ), SplineValue() );
+
+        // Interpolate to grid.
+        P2G::values(
+            spline,
+            Cajita::makeParameterPack( particle_scalar, particle_vector ),
+            Cajita::makeParameterPack( node_scalar, node_vector ) );
+    }
+};
+
 //---------------------------------------------------------------------------//
 struct ScalarGradientP2G
 {
@@ -348,6 +397,82 @@ struct VectorDivergenceG2P
     }
 };
 
+//---------------------------------------------------------------------------//
+// Scalar value and gradient in a single traversal with the separately
+// interpolated value and gradient as a reference.
+struct ScalarValueAndGradientG2P
+{
+    template <class LocalMeshType, class GatherDependencies,
+              class ScatterDependencies, class LocalDependencies,
+              class ParticleViewType>
+    KOKKOS_INLINE_FUNCTION void
+    operator()( const LocalMeshType& local_mesh,
+                const GatherDependencies& gather_deps,
+                const ScatterDependencies&, const LocalDependencies&,
+                ParticleViewType& particle ) const
+    {
+        // Get input dependencies.
+        auto node_scalar =
+            gather_deps.get( FieldLocation::Node(), NodeScalar() );
+
+        // Get particle data.
+        auto& particle_scalar = get( particle, ParticleScalar() );
+        auto particle_vector = get( particle, ParticleVector() );
+        auto& particle_scalar_ref = get( particle, ParticleScalarRef() );
+        auto particle_vector_ref = get( particle, ParticleVectorRef() );
+
+        // Node Interpolant
+        auto spline =
+            createSpline( FieldLocation::Node(), InterpolationOrder<1>(),
+                          local_mesh, get( particle, Field::LogicalPosition() ),
+                          SplineValue(), SplineGradient() );
+
+        // Interpolate to points.
+        G2P::valueAndGradient( spline, node_scalar, particle_scalar,
+                               particle_vector );
+        G2P::value( spline, node_scalar, particle_scalar_ref );
+        G2P::gradient( spline, node_scalar, particle_vector_ref );
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Vector value and gradient in a single traversal with the separately
+// interpolated value and gradient as a reference.
+struct VectorValueAndGradientG2P
+{
+    template <class LocalMeshType, class GatherDependencies,
+              class ScatterDependencies, class LocalDependencies,
+              class ParticleViewType>
+    KOKKOS_INLINE_FUNCTION void
+    operator()( const LocalMeshType& local_mesh,
+                const GatherDependencies& gather_deps,
+                const ScatterDependencies&, const LocalDependencies&,
+                ParticleViewType& particle ) const
+    {
+        // Get input dependencies.
+        auto node_vector =
+            gather_deps.get( FieldLocation::Node(), NodeVector() );
+
+        // Get particle data.
+        auto particle_vector = get( particle, ParticleVector() );
+        auto particle_tensor = get( particle, ParticleTensor() );
+        auto particle_vector_ref = get( particle, ParticleVectorRef() );
+        auto particle_tensor_ref = get( particle, ParticleTensorRef() );
+
+        // Node Interpolant
+        auto spline =
+            createSpline( FieldLocation::Node(), InterpolationOrder<1>(),
+                          local_mesh, get( particle, Field::LogicalPosition() ),
+                          SplineValue(), SplineGradient() );
+
+        // Interpolate to points.
+        G2P::valueAndGradient( spline, node_vector, particle_vector,
+                               particle_tensor );
+        G2P::value( spline, node_vector, particle_vector_ref );
+        G2P::gradient( spline, node_vector, particle_tensor_ref );
+    }
+};
+
 //---------------------------------------------------------------------------//
 void interpolationTest()
 {
@@ -379,7 +504,8 @@ void interpolationTest()
     // Make a particle list.
     using list_type =
         ParticleList<UniformMesh<TEST_MEMSPACE>, Field::LogicalPosition,
-                     ParticleScalar, ParticleVector, ParticleTensor>;
+                     ParticleScalar, ParticleVector, ParticleTensor,
+                     ParticleScalarRef, ParticleVectorRef, ParticleTensorRef>;
     list_type particles( "test_particles", mesh );
     using particle_type = typename list_type::particle_type;
 
@@ -409,6 +535,9 @@ void interpolationTest()
     auto scalar_p_host = Cabana::slice<1>( particles_host );
     auto vector_p_host = Cabana::slice<2>( particles_host );
     auto tensor_p_host = Cabana::slice<3>( particles_host );
+    auto scalar_ref_p_host = Cabana::slice<4>( particles_host );
+    auto vector_ref_p_host = Cabana::slice<5>( particles_host );
+    auto tensor_ref_p_host = Cabana::slice<6>( particles_host );
 
     // Make a field manager.
     auto fm = createFieldManager( mesh );
@@ -424,6 +553,12 @@ void interpolationTest()
     auto p2gvv_op = createGridOperator( mesh, p2gvv_scatter() );
     p2gvv_op->setup( *fm );
 
+    using p2gmv_scatter =
+        ScatterDependencies<FieldLayout<FieldLocation::Node, NodeScalar>,
+                            FieldLayout<FieldLocation::Node, NodeVector>>;
+    auto p2gmv_op = createGridOperator( mesh, p2gmv_scatter() );
+    p2gmv_op->setup( *fm );
+
     using p2gsg_scatter =
         ScatterDependencies<FieldLayout<FieldLocation::Node, NodeVector>>;
     auto p2gsg_op = createGridOperator( mesh, p2gsg_scatter() );
@@ -465,6 +600,16 @@ void interpolationTest()
     auto g2pvd_op = createGridOperator( mesh, g2pvd_gather() );
     g2pvd_op->setup( *fm );
 
+    using g2psvg_gather =
+        GatherDependencies<FieldLayout<FieldLocation::Node, NodeScalar>>;
+    auto g2psvg_op = createGridOperator( mesh, g2psvg_gather() );
+    g2psvg_op->setup( *fm );
+
+    using g2pvvg_gather =
+        GatherDependencies<FieldLayout<FieldLocation::Node, NodeVector>>;
+    auto g2pvvg_op = createGridOperator( mesh, g2pvvg_gather() );
+    g2pvvg_op->setup( *fm );
+
     // Get fields.
     auto scalar_n = fm->view( FieldLocation::Node(), NodeScalar() );
     auto vector_n = fm->view( FieldLocation::Node(), NodeVector() );
@@ -506,6 +651,24 @@ void interpolationTest()
                 for ( int d = 0; d < 3; ++d )
                     EXPECT_FLOAT_EQ( vector_n_host( i, j, k, d ), 3.5 );
 
+    // Interpolate a scalar and a vector point value to the grid together.
+    Kokkos::deep_copy( scalar_n, 0.0 );
+    Kokkos::deep_copy( vector_n, 0.0 );
+    p2gmv_op->apply( FieldLocation::Particle(), TEST_EXECSPACE(), *fm,
+                     particles, MultiValueP2G() );
+    Kokkos::deep_copy( scalar_n_host, scalar_n );
+    Kokkos::deep_copy( vector_n_host, vector_n );
+    for ( int i = node_space.min( Dim::I ); i < node_space.max( Dim::I ); ++i )
+        for ( int j = node_space.min( Dim::J ); j < node_space.max( Dim::J );
+              ++j )
+            for ( int k = node_space.min( Dim::K );
+                  k < node_space.max( Dim::K ); ++k )
+            {
+                EXPECT_FLOAT_EQ( scalar_n_host( i, j, k, 0 ), 3.5 );
+                for ( int d = 0; d < 3; ++d )
+                    EXPECT_FLOAT_EQ( vector_n_host( i, j, k, d ), 3.5 );
+            }
+
     // Interpolate a scalar point gradient value to the grid.
     Kokkos::deep_copy( vector_n, 0.0 );
     p2gsg_op->apply( FieldLocation::Particle(), TEST_EXECSPACE(), *fm,
@@ -593,6 +756,48 @@ void interpolationTest()
     Cabana::deep_copy( scalar_p_host, scalar_p );
     for ( int p = 0; p < num_particle; ++p )
         EXPECT_FLOAT_EQ( scalar_p_host( p ) + 1.0, 1.0 );
+
+    // Assign linear grid fields so the gradients are not zero.
+    auto local_mesh =
+        Cajita::createLocalMesh<TEST_EXECSPACE>( *( mesh->localGrid() ) );
+    Cajita::grid_parallel_for(
+        "linear_fields", TEST_EXECSPACE(), *( mesh->localGrid() ),
+        Cajita::Ghost(), Cajita::Node(),
+        KOKKOS_LAMBDA( const int i, const int j, const int k ) {
+            int index[3] = { i, j, k };
+            double x[3];
+            local_mesh.coordinates( Cajita::Node(), index, x );
+            scalar_n( i, j, k, 0 ) = 1.0 + 2.0 * x[0] - x[1] + 0.5 * x[2];
+            for ( int d = 0; d < 3; ++d )
+                vector_n( i, j, k, d ) = d - 1.5 * x[0] + ( d + 1.0 ) * x[1] +
+                                         0.25 * ( d + 1.0 ) * x[2];
+        } );
+
+    // Interpolate a scalar grid value and gradient to the points in a single
+    // traversal and compare to the separate value and gradient.
+    g2psvg_op->apply( FieldLocation::Particle(), TEST_EXECSPACE(), *fm,
+                      particles, ScalarValueAndGradientG2P() );
+    Cabana::deep_copy( particles_host, particles.aosoa() );
+    for ( int p = 0; p < num_particle; ++p )
+    {
+        EXPECT_FLOAT_EQ( scalar_p_host( p ), scalar_ref_p_host( p ) );
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_FLOAT_EQ( vector_p_host( p, d ), vector_ref_p_host( p, d ) );
+    }
+
+    // Interpolate a vector grid value and gradient to the points in a single
+    // traversal and compare to the separate value and gradient.
+    g2pvvg_op->apply( FieldLocation::Particle(), TEST_EXECSPACE(), *fm,
+                      particles, VectorValueAndGradientG2P() );
+    Cabana::deep_copy( particles_host, particles.aosoa() );
+    for ( int p = 0; p < num_particle; ++p )
+        for ( int i = 0; i < 3; ++i )
+        {
+            EXPECT_FLOAT_EQ( vector_p_host( p, i ), vector_ref_p_host( p, i ) );
+            for ( int j = 0; j < 3; ++j )
+                EXPECT_FLOAT_EQ( tensor_p_host( p, i, j ),
+                                 tensor_ref_p_host( p, i, j ) );
+        }
 }
 
 //---------------------------------------------------------------------------//
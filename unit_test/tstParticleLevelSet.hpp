@@ -28,6 +28,7 @@
 #include <Kokkos_Core.hpp>
 
 #include <cmath>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -194,9 +195,334 @@ void zalesaksTest( const std::string& filename )
     }
 }
 
+//---------------------------------------------------------------------------//
+void treeReuseTest()
+{
+    // Global parameters.
+    Kokkos::Array<double, 6> global_box = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
+
+    // Get inputs. Reuse the tree until the error bound reaches a cell.
+    InputParser parser( "level_set_redistance_test.json", "json" );
+    auto pt = parser.propertyTree();
+    pt.put( "particle_level_set.particle_radius", 0.5 );
+    pt.put( "particle_level_set.tree_rebuild_tolerance", 1.0 );
+
+    // Make mesh.
+    int minimum_halo_size = 4;
+    auto mesh = createUniformMesh( TEST_MEMSPACE(), pt, global_box,
+                                   minimum_halo_size, MPI_COMM_WORLD );
+    auto dx = mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
+
+    // Put a line of particles through the center of the local domain.
+    auto local_mesh =
+        Cajita::createLocalMesh<TEST_MEMSPACE>( *( mesh->localGrid() ) );
+    int num_particle = 10;
+    Kokkos::View<double* [3], TEST_MEMSPACE> x_p( "x_p", num_particle );
+    Kokkos::View<int*, TEST_MEMSPACE> c_p( "c_p", num_particle );
+    Kokkos::parallel_for(
+        "init_particles",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_particle ),
+        KOKKOS_LAMBDA( const int p ) {
+            for ( int d = 0; d < 3; ++d )
+            {
+                double low = local_mesh.lowCorner( Cajita::Own(), d );
+                double high = local_mesh.highCorner( Cajita::Own(), d );
+                x_p( p, d ) = 0.5 * ( low + high );
+            }
+            x_p( p, Dim::I ) += ( p - num_particle / 2 ) * dx;
+        } );
+
+    // Create a level set over all particles and a reference level set that
+    // rebuilds its tree whenever the particles move other than by a common
+    // translation.
+    auto level_set =
+        createParticleLevelSet<FieldLocation::Node>( pt, mesh, -1 );
+    auto ref_pt = pt;
+    ref_pt.put( "particle_level_set.tree_rebuild_tolerance", 0.0 );
+    auto ref_level_set =
+        createParticleLevelSet<FieldLocation::Node>( ref_pt, mesh, -1 );
+    level_set->updateParticleColors( TEST_EXECSPACE(), c_p );
+    ref_level_set->updateParticleColors( TEST_EXECSPACE(), c_p );
+
+    // Check the estimate against the reference within the given tolerance.
+    auto own_entities = mesh->localGrid()->indexSpace(
+        Cajita::Own(), Cajita::Node(), Cajita::Local() );
+    auto check_estimate = [&]( const double tol ) {
+        level_set->estimateSignedDistance( TEST_EXECSPACE(), x_p );
+        ref_level_set->estimateSignedDistance( TEST_EXECSPACE(), x_p );
+        auto estimate = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(),
+            level_set->levelSet()->getDistanceEstimate()->view() );
+        auto ref_estimate = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(),
+            ref_level_set->levelSet()->getDistanceEstimate()->view() );
+        for ( int i = own_entities.min( Dim::I );
+              i < own_entities.max( Dim::I ); ++i )
+            for ( int j = own_entities.min( Dim::J );
+                  j < own_entities.max( Dim::J ); ++j )
+                for ( int k = own_entities.min( Dim::K );
+                      k < own_entities.max( Dim::K ); ++k )
+                {
+                    EXPECT_GE( estimate( i, j, k, 0 ),
+                               ref_estimate( i, j, k, 0 ) - 1.0e-6 );
+                    EXPECT_LE( estimate( i, j, k, 0 ),
+                               ref_estimate( i, j, k, 0 ) + tol );
+                }
+    };
+
+    // The first estimate builds the tree.
+    check_estimate( 1.0e-6 );
+    EXPECT_EQ( level_set->treeBuildCount(), 1 );
+    EXPECT_EQ( level_set->treeErrorBound(), 0.0 );
+
+    // Particles have not moved so the tree is reused.
+    check_estimate( 1.0e-6 );
+    EXPECT_EQ( level_set->treeBuildCount(), 1 );
+    EXPECT_EQ( level_set->treeErrorBound(), 0.0 );
+
+    // Move the particles in alternating directions so the nearest particle
+    // to an entity may change. The error bound is within the tolerance so
+    // the tree is reused and the estimate is within twice the displacement
+    // of the rebuilt reference.
+    double shift = 0.4 * dx;
+    auto move_alternating = [&]() {
+        Kokkos::parallel_for(
+            "move_particles",
+            Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_particle ),
+            KOKKOS_LAMBDA( const int p ) {
+                double sign = ( p % 2 ) ? 1.0 : -1.0;
+                x_p( p, Dim::I ) += sign * shift;
+            } );
+    };
+    move_alternating();
+    check_estimate( 2.0 * shift + 1.0e-6 );
+    EXPECT_EQ( level_set->treeBuildCount(), 1 );
+    EXPECT_NEAR( level_set->treeErrorBound(), 2.0 * shift, 1.0e-12 );
+    EXPECT_LE( level_set->treeErrorBound(), dx );
+
+    // Translate all of the particles by a cell. The translation is followed
+    // without rebuilding the tree and does not add to the error bound.
+    Kokkos::parallel_for(
+        "move_particles",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_particle ),
+        KOKKOS_LAMBDA( const int p ) { x_p( p, Dim::J ) += dx; } );
+    check_estimate( 2.0 * shift + 1.0e-6 );
+    EXPECT_EQ( level_set->treeBuildCount(), 1 );
+    EXPECT_NEAR( level_set->treeErrorBound(), 2.0 * shift, 1.0e-12 );
+
+    // Move the particles apart again so the error bound exceeds the
+    // tolerance. The tree is rebuilt.
+    move_alternating();
+    check_estimate( 1.0e-6 );
+    EXPECT_EQ( level_set->treeBuildCount(), 2 );
+    EXPECT_EQ( level_set->treeErrorBound(), 0.0 );
+
+    // Updating the colors rebuilds the tree.
+    level_set->updateParticleColors( TEST_EXECSPACE(), c_p );
+    check_estimate( 1.0e-6 );
+    EXPECT_EQ( level_set->treeBuildCount(), 3 );
+}
+
+//---------------------------------------------------------------------------//
+void binEstimateTest()
+{
+    // Global parameters.
+    Kokkos::Array<double, 6> global_box = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
+
+    // Get inputs.
+    InputParser parser( "level_set_redistance_test.json", "json" );
+    auto pt = parser.propertyTree();
+    pt.put( "particle_level_set.particle_radius", 0.5 );
+
+    // Make mesh.
+    int minimum_halo_size = 4;
+    auto mesh = createUniformMesh( TEST_MEMSPACE(), pt, global_box,
+                                   minimum_halo_size, MPI_COMM_WORLD );
+    auto dx = mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
+
+    // Put a line of particles through the center of the local domain. Give
+    // every other particle a different color.
+    auto local_mesh =
+        Cajita::createLocalMesh<TEST_MEMSPACE>( *( mesh->localGrid() ) );
+    int num_particle = 10;
+    Kokkos::View<double* [3], TEST_MEMSPACE> x_p( "x_p", num_particle );
+    Kokkos::View<int*, TEST_MEMSPACE> c_p( "c_p", num_particle );
+    Kokkos::parallel_for(
+        "init_particles",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_particle ),
+        KOKKOS_LAMBDA( const int p ) {
+            for ( int d = 0; d < 3; ++d )
+            {
+                double low = local_mesh.lowCorner( Cajita::Own(), d );
+                double high = local_mesh.highCorner( Cajita::Own(), d );
+                x_p( p, d ) = 0.5 * ( low + high );
+            }
+            x_p( p, Dim::I ) += ( p - num_particle / 2 ) * dx;
+            c_p( p ) = p % 2;
+        } );
+
+    // Create level sets with the tree and bin estimates.
+    auto tree_level_set =
+        createParticleLevelSet<FieldLocation::Node>( pt, mesh, 1 );
+    pt.put( "particle_level_set.estimate_method", "bins" );
+    auto bin_level_set =
+        createParticleLevelSet<FieldLocation::Node>( pt, mesh, 1 );
+    EXPECT_TRUE( DistanceEstimateMethod::Bins ==
+                 bin_level_set->estimateMethod() );
+
+    auto cell_level_set =
+        createParticleLevelSet<FieldLocation::Node>( pt, mesh, 1 );
+
+    // Compute the particle cell indices.
+    Kokkos::View<int* [3], TEST_MEMSPACE> ci_p( "ci_p", num_particle );
+    CellLocator locator( *( mesh->localGrid() ) );
+    Kokkos::parallel_for(
+        "init_cells", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_particle ),
+        KOKKOS_LAMBDA( const int p ) {
+            double x[3] = { x_p( p, Dim::I ), x_p( p, Dim::J ),
+                            x_p( p, Dim::K ) };
+            int ijk[3];
+            locator.cellIndex( x, ijk );
+            for ( int d = 0; d < 3; ++d )
+                ci_p( p, d ) = ijk[d];
+        } );
+
+    // Estimate. The last bin estimate bins the particles by their cell
+    // index.
+    tree_level_set->updateParticleColors( TEST_EXECSPACE(), c_p );
+    bin_level_set->updateParticleColors( TEST_EXECSPACE(), c_p );
+    cell_level_set->updateParticleColors( TEST_EXECSPACE(), c_p );
+    tree_level_set->estimateSignedDistance( TEST_EXECSPACE(), x_p );
+    bin_level_set->estimateSignedDistance( TEST_EXECSPACE(), x_p );
+    cell_level_set->estimateSignedDistance( TEST_EXECSPACE(), x_p, ci_p );
+
+    // The bin estimate should match the tree estimate within the narrow band
+    // and be the narrow band width outside of it.
+    double far_value = dx * mesh->localGrid()->haloCellWidth();
+    auto tree_estimate = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(),
+        tree_level_set->levelSet()->getDistanceEstimate()->view() );
+    auto bin_estimate = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(),
+        bin_level_set->levelSet()->getDistanceEstimate()->view() );
+    auto cell_estimate = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(),
+        cell_level_set->levelSet()->getDistanceEstimate()->view() );
+    auto own_entities = mesh->localGrid()->indexSpace(
+        Cajita::Own(), Cajita::Node(), Cajita::Local() );
+    for ( int i = own_entities.min( Dim::I ); i < own_entities.max( Dim::I );
+          ++i )
+        for ( int j = own_entities.min( Dim::J );
+              j < own_entities.max( Dim::J ); ++j )
+            for ( int k = own_entities.min( Dim::K );
+                  k < own_entities.max( Dim::K ); ++k )
+            {
+                double expected =
+                    fmin( tree_estimate( i, j, k, 0 ), far_value );
+                EXPECT_NEAR( bin_estimate( i, j, k, 0 ), expected, 1.0e-5 );
+                EXPECT_EQ( cell_estimate( i, j, k, 0 ),
+                           bin_estimate( i, j, k, 0 ) );
+            }
+}
+
+//---------------------------------------------------------------------------//
+void multiColorTest()
+{
+    // Global parameters.
+    Kokkos::Array<double, 6> global_box = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
+
+    // Get inputs.
+    InputParser parser( "level_set_redistance_test.json", "json" );
+    auto pt = parser.propertyTree();
+    pt.put( "particle_level_set.particle_radius", 0.5 );
+
+    // Make mesh.
+    int minimum_halo_size = 4;
+    auto mesh = createUniformMesh( TEST_MEMSPACE(), pt, global_box,
+                                   minimum_halo_size, MPI_COMM_WORLD );
+    auto dx = mesh->localGrid()->globalGrid().globalMesh().cellSize( 0 );
+
+    // Put a line of particles through the center of the local domain with
+    // three colors.
+    auto local_mesh =
+        Cajita::createLocalMesh<TEST_MEMSPACE>( *( mesh->localGrid() ) );
+    int num_particle = 12;
+    Kokkos::View<double* [3], TEST_MEMSPACE> x_p( "x_p", num_particle );
+    Kokkos::View<int*, TEST_MEMSPACE> c_p( "c_p", num_particle );
+    Kokkos::parallel_for(
+        "init_particles",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_particle ),
+        KOKKOS_LAMBDA( const int p ) {
+            for ( int d = 0; d < 3; ++d )
+            {
+                double low = local_mesh.lowCorner( Cajita::Own(), d );
+                double high = local_mesh.highCorner( Cajita::Own(), d );
+                x_p( p, d ) = 0.5 * ( low + high );
+            }
+            x_p( p, Dim::I ) += ( p - num_particle / 2 ) * dx;
+            c_p( p ) = p % 3;
+        } );
+
+    // Create a multi-color level set for two of the colors.
+    std::vector<int> colors = { 2, 0 };
+    auto level_set = createMultiColorParticleLevelSet<FieldLocation::Node>(
+        pt, mesh, colors );
+    EXPECT_EQ( level_set->numColor(), 2 );
+    level_set->updateParticleColors( TEST_EXECSPACE(), c_p );
+    EXPECT_EQ( level_set->colorCount( 0 ), num_particle / 3 );
+    EXPECT_EQ( level_set->colorCount( 1 ), num_particle / 3 );
+    level_set->estimateSignedDistance( TEST_EXECSPACE(), x_p );
+
+    // Translate the particles. A second estimate reuses the single tree over
+    // all colors.
+    Kokkos::parallel_for(
+        "move_particles",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_particle ),
+        KOKKOS_LAMBDA( const int p ) { x_p( p, Dim::J ) += 0.5 * dx; } );
+    level_set->estimateSignedDistance( TEST_EXECSPACE(), x_p );
+    EXPECT_EQ( level_set->treeBuildCount(), 1 );
+
+    // Compare to the single color level sets. Entities with no particle of
+    // the color within the minimum halo width get that width.
+    double far_value = dx * mesh->localGrid()->haloCellWidth();
+    auto own_entities = mesh->localGrid()->indexSpace(
+        Cajita::Own(), Cajita::Node(), Cajita::Local() );
+    for ( int n = 0; n < level_set->numColor(); ++n )
+    {
+        EXPECT_EQ( level_set->color( n ), colors[n] );
+        auto single_level_set =
+            createParticleLevelSet<FieldLocation::Node>( pt, mesh, colors[n] );
+        single_level_set->updateParticleColors( TEST_EXECSPACE(), c_p );
+        single_level_set->estimateSignedDistance( TEST_EXECSPACE(), x_p );
+
+        auto estimate = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(),
+            level_set->levelSet( n )->getDistanceEstimate()->view() );
+        auto single_estimate = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(),
+            single_level_set->levelSet()->getDistanceEstimate()->view() );
+        for ( int i = own_entities.min( Dim::I );
+              i < own_entities.max( Dim::I ); ++i )
+            for ( int j = own_entities.min( Dim::J );
+                  j < own_entities.max( Dim::J ); ++j )
+                for ( int k = own_entities.min( Dim::K );
+                      k < own_entities.max( Dim::K ); ++k )
+                    EXPECT_NEAR(
+                        estimate( i, j, k, 0 ),
+                        fmin( single_estimate( i, j, k, 0 ), far_value ),
+                        1.0e-5 );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // RUN TESTS
 //---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, tree_reuse_test ) { treeReuseTest(); }
+
+TEST( TEST_CATEGORY, bin_estimate_test ) { binEstimateTest(); }
+
+TEST( TEST_CATEGORY, multi_color_test ) { multiColorTest(); }
+
 // TEST( TEST_CATEGORY, zalesaks_disk_test )
 // {
 //     zalesaksTest( "particle_level_set_zalesaks_disk.json" );
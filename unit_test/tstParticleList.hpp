@@ -18,6 +18,8 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <cmath>
+
 #include <gtest/gtest.h>
 
 using namespace Picasso;
@@ -347,6 +349,97 @@ void linearAlgebraTest()
     }
 }
 
+//---------------------------------------------------------------------------//
+void cellIndexTest()
+{
+    // Get inputs for mesh.
+    InputParser parser( "uniform_mesh_test_1.json", "json" );
+    Kokkos::Array<double, 6> global_box = { -10.0, -10.0, -10.0,
+                                            10.0,  10.0,  10.0 };
+    int minimum_halo_size = 0;
+
+    // Make mesh.
+    auto mesh = std::make_shared<UniformMesh<TEST_MEMSPACE>>(
+        parser.propertyTree(), global_box, minimum_halo_size, MPI_COMM_WORLD );
+    auto local_mesh =
+        Cajita::createLocalMesh<Kokkos::HostSpace>( *( mesh->localGrid() ) );
+    double dx = mesh->cellSize();
+
+    // Make a particle list.
+    using list_type =
+        ParticleList<UniformMesh<TEST_MEMSPACE>, Field::LogicalPosition,
+                     Field::LogicalCellIndex, Foo>;
+    EXPECT_TRUE( list_type::has_field<Field::LogicalCellIndex>::value );
+    EXPECT_FALSE( list_type::has_field<Field::Color>::value );
+
+    list_type particles( "test_particles", mesh );
+
+    // Put particles along the diagonal of the owned domain.
+    auto& aosoa = particles.aosoa();
+    std::size_t num_p = 23;
+    aosoa.resize( num_p );
+    auto aosoa_host = Cabana::create_mirror_view( Kokkos::HostSpace(), aosoa );
+    auto px_h = Cabana::slice<0>( aosoa_host );
+    auto pc_h = Cabana::slice<1>( aosoa_host );
+    for ( std::size_t p = 0; p < num_p; ++p )
+        for ( int d = 0; d < 3; ++d )
+            px_h( p, d ) = local_mesh.lowCorner( Cajita::Own(), d ) +
+                           ( p + 0.5 ) / num_p *
+                               ( local_mesh.highCorner( Cajita::Own(), d ) -
+                                 local_mesh.lowCorner( Cajita::Own(), d ) );
+    Cabana::deep_copy( aosoa, aosoa_host );
+
+    // Compute the cell index.
+    particles.updateCellIndex();
+    Cabana::deep_copy( aosoa_host, aosoa );
+    for ( std::size_t p = 0; p < num_p; ++p )
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( pc_h( p, d ),
+                       static_cast<int>( std::floor(
+                           ( px_h( p, d ) -
+                             local_mesh.lowCorner( Cajita::Ghost(), d ) ) /
+                           dx ) ) );
+
+    // Move the particles and update the cell index incrementally.
+    auto locator = particles.cellLocator();
+    Kokkos::parallel_for(
+        "move", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_p ),
+        KOKKOS_LAMBDA( const int p ) {
+            auto s = Cabana::Impl::Index<
+                list_type::particle_view_type::vector_length>::s( p );
+            auto a = Cabana::Impl::Index<
+                list_type::particle_view_type::vector_length>::a( p );
+            typename list_type::particle_view_type particle( aosoa.access( s ),
+                                                             a );
+            get( particle, Field::LogicalPosition(), Dim::I ) += 0.6 * dx;
+            get( particle, Field::LogicalPosition(), Dim::J ) -= 0.3 * dx;
+            updateCellIndex( locator, particle );
+        } );
+
+    // Check the update.
+    Cabana::deep_copy( aosoa_host, aosoa );
+    for ( std::size_t p = 0; p < num_p; ++p )
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( pc_h( p, d ),
+                       static_cast<int>( std::floor(
+                           ( px_h( p, d ) -
+                             local_mesh.lowCorner( Cajita::Ghost(), d ) ) /
+                           dx ) ) );
+
+    // Redistribute the particles. The incrementally updated cell index is
+    // used as-is and only recomputed for particles which left the owned
+    // cells.
+    particles.redistribute( true );
+    Cabana::deep_copy( aosoa_host, aosoa );
+    for ( std::size_t p = 0; p < aosoa_host.size(); ++p )
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( pc_h( p, d ),
+                       static_cast<int>( std::floor(
+                           ( px_h( p, d ) -
+                             local_mesh.lowCorner( Cajita::Ghost(), d ) ) /
+                           dx ) ) );
+}
+
 //---------------------------------------------------------------------------//
 // RUN TESTS
 //---------------------------------------------------------------------------//
@@ -356,6 +449,8 @@ TEST( TEST_CATEGORY, particle_view_test ) { particleViewTest(); }
 
 TEST( TEST_CATEGORY, linear_algebra_test ) { linearAlgebraTest(); }
 
+TEST( TEST_CATEGORY, cell_index_test ) { cellIndexTest(); }
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
@@ -16,6 +16,7 @@
 #include <Kokkos_Core.hpp>
 
 #include <cmath>
+#include <stdexcept>
 
 #include <gtest/gtest.h>
 
@@ -103,11 +104,77 @@ void constructionTest()
     EXPECT_EQ( mesh_2.localGrid()->haloCellWidth(), 1 );
 }
 
+//---------------------------------------------------------------------------//
+void scaledConstructionTest( const double cell_size_ratio )
+{
+    // Global parameters.
+    Kokkos::Array<double, 6> global_box = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
+    int minimum_halo_size = 2;
+
+    // Make the mesh.
+    InputParser parser( "level_set_redistance_test.json", "json" );
+    auto pt = parser.propertyTree();
+    auto mesh = createUniformMesh( TEST_MEMSPACE(), pt, global_box,
+                                   minimum_halo_size, MPI_COMM_WORLD );
+
+    // Make a mesh with a scaled cell size.
+    auto scaled_mesh =
+        createUniformMesh( *mesh, cell_size_ratio, minimum_halo_size );
+
+    // Check cell sizes.
+    EXPECT_DOUBLE_EQ( scaled_mesh->cellSize(),
+                      cell_size_ratio * mesh->cellSize() );
+    EXPECT_EQ( scaled_mesh->localGrid()->haloCellWidth(), minimum_halo_size );
+
+    // Check the global grid.
+    const auto& global_grid = mesh->localGrid()->globalGrid();
+    const auto& scaled_global_grid = scaled_mesh->localGrid()->globalGrid();
+    for ( int d = 0; d < 3; ++d )
+    {
+        EXPECT_EQ(
+            scaled_global_grid.globalNumEntity( Cajita::Cell(), d ),
+            static_cast<int>( std::rint(
+                global_grid.globalNumEntity( Cajita::Cell(), d ) /
+                cell_size_ratio ) ) );
+        EXPECT_EQ( scaled_global_grid.isPeriodic( d ),
+                   global_grid.isPeriodic( d ) );
+        EXPECT_EQ( scaled_global_grid.dimNumBlock( d ),
+                   global_grid.dimNumBlock( d ) );
+    }
+
+    // Check that this rank owns the same region of space in both meshes.
+    auto local_mesh =
+        Cajita::createLocalMesh<Kokkos::HostSpace>( *( mesh->localGrid() ) );
+    auto scaled_local_mesh = Cajita::createLocalMesh<Kokkos::HostSpace>(
+        *( scaled_mesh->localGrid() ) );
+    for ( int d = 0; d < 3; ++d )
+    {
+        EXPECT_DOUBLE_EQ( scaled_local_mesh.lowCorner( Cajita::Own(), d ),
+                          local_mesh.lowCorner( Cajita::Own(), d ) );
+        EXPECT_DOUBLE_EQ( scaled_local_mesh.highCorner( Cajita::Own(), d ),
+                          local_mesh.highCorner( Cajita::Own(), d ) );
+    }
+
+    // The ratio or its inverse must be an integer.
+    EXPECT_THROW( createUniformMesh( *mesh, 1.5, minimum_halo_size ),
+                  std::logic_error );
+}
+
 //---------------------------------------------------------------------------//
 // RUN TESTS
 //---------------------------------------------------------------------------//
 TEST( TEST_CATEGORY, construction_test ) { constructionTest(); }
 
+TEST( TEST_CATEGORY, coarsened_construction_test )
+{
+    scaledConstructionTest( 2.0 );
+}
+
+TEST( TEST_CATEGORY, refined_construction_test )
+{
+    scaledConstructionTest( 0.5 );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
@@ -0,0 +1,119 @@
+/****************************************************************************
+ * Copyright (c) 2021 by the Picasso authors                                *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Picasso library. Picasso is distributed under a *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Picasso_FacetGeometry.hpp>
+#include <Picasso_FieldManager.hpp>
+#include <Picasso_FieldTypes.hpp>
+#include <Picasso_InputParser.hpp>
+#include <Picasso_Types.hpp>
+#include <Picasso_UniformMesh.hpp>
+#include <Picasso_VolumeIdField.hpp>
+
+#include <Cajita.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Picasso;
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+void classifyTest()
+{
+    // Get inputs.
+    InputParser parser( "facet_init_example.json", "json" );
+    auto pt = parser.propertyTree();
+
+    // Make a mesh over the global bounding volume of the geometry. The
+    // geometry contains a sphere of radius 10 centered at the origin and a
+    // 4x4x4 cube centered at (15,15,15).
+    Kokkos::Array<double, 6> global_box = { -12.0, -12.0, -12.0,
+                                            20.0,  20.0,  20.0 };
+    int minimum_halo_size = 1;
+    auto mesh = std::make_shared<UniformMesh<TEST_MEMSPACE>>(
+        pt, global_box, minimum_halo_size, MPI_COMM_WORLD );
+    auto fm = createFieldManager( mesh );
+
+    // Classify the cells.
+    FacetGeometry<TEST_MEMSPACE> geometry( pt, TEST_EXECSPACE() );
+    classifyVolumeId( TEST_EXECSPACE(), geometry, *fm );
+
+    // Check that each local domain has both cut and uncut cells and that
+    // uncut cells are inside the domain.
+    auto volume_id = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(),
+        fm->view( FieldLocation::Cell(), Field::VolumeId() ) );
+    auto own_cells = mesh->localGrid()->indexSpace(
+        Cajita::Own(), Cajita::Cell(), Cajita::Local() );
+    int num_cut = 0;
+    for ( int i = own_cells.min( Dim::I ); i < own_cells.max( Dim::I ); ++i )
+        for ( int j = own_cells.min( Dim::J ); j < own_cells.max( Dim::J );
+              ++j )
+            for ( int k = own_cells.min( Dim::K );
+                  k < own_cells.max( Dim::K ); ++k )
+            {
+                if ( CutCell == volume_id( i, j, k, 0 ) )
+                    ++num_cut;
+                else
+                    EXPECT_TRUE( volume_id( i, j, k, 0 ) >= -1 );
+            }
+    EXPECT_TRUE( num_cut > 0 );
+    EXPECT_TRUE( num_cut < static_cast<int>( own_cells.size() ) );
+
+    // Locate points throughout the local ghosted domain and beyond with the
+    // cells and with the facets and check they agree.
+    auto locator = createVolumeIdLocator( *fm, geometry );
+    const auto& geom_data = geometry.data();
+    auto local_mesh =
+        Cajita::createLocalMesh<Kokkos::HostSpace>( *( mesh->localGrid() ) );
+    Kokkos::Array<double, 6> local_box;
+    for ( int d = 0; d < 3; ++d )
+    {
+        double width = local_mesh.highCorner( Cajita::Ghost(), d ) -
+                       local_mesh.lowCorner( Cajita::Ghost(), d );
+        local_box[d] =
+            local_mesh.lowCorner( Cajita::Ghost(), d ) - 0.1 * width;
+        local_box[d + 3] =
+            local_mesh.highCorner( Cajita::Ghost(), d ) + 0.1 * width;
+    }
+    int num_point = 30;
+    int num_mismatch = 0;
+    Kokkos::parallel_reduce(
+        "check_volume_id_locator",
+        Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_point * num_point *
+                                                    num_point ),
+        KOKKOS_LAMBDA( const int n, int& mismatch ) {
+            int ijk[3] = { n % num_point, ( n / num_point ) % num_point,
+                           n / ( num_point * num_point ) };
+            float x[3];
+            for ( int d = 0; d < 3; ++d )
+            {
+                double dx = ( local_box[d + 3] - local_box[d] ) / num_point;
+                x[d] = local_box[d] + ( ijk[d] + 0.37 ) * dx;
+            }
+            if ( locator.locatePoint( x ) !=
+                 FacetGeometryOps::locatePoint( x, geom_data ) )
+                ++mismatch;
+        },
+        num_mismatch );
+    EXPECT_EQ( num_mismatch, 0 );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, classify_test ) { classifyTest(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test